@@ -26,8 +26,13 @@
  * @author Vincent HERVIEUX    -   11.27.2012   -   initial creation
  */
 
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
 #include "acquisition.h"
 #include "acquisition2000.h"
+#include "acquisition2000a.h"
 #include "acquisition3000.h"
 #include "acquisition6000.h"
 
@@ -40,6 +45,26 @@ enum BOOL {FALSE,TRUE};
 Acquisition *Acquisition::singleton_m = NULL;
 const char * Acquisition::known_adc_units[] = { "ADC", "fs", "ps", "ns", "us", "ms"};
 const char * Acquisition::unknown_adc_units = "Not Known";
+/* probe order of the families, the ones not built are skipped by open_family() */
+const char * Acquisition::families[] = { "ps2000", "ps2000a", "ps3000", "ps6000", NULL };
+std::string Acquisition::preferred_family_m;
+std::string Acquisition::family_m;
+realtime_spec_t Acquisition::realtime_m = { SCHED_OTHER, 0, -1, false };
+
+/****************************************************************************
+ * prefault_stack - touch the stack the capture loop will use
+ ****************************************************************************/
+static void prefault_stack(void)
+{
+    volatile uint8_t stack[REALTIME_STACK_PREFAULT];
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t i = 0;
+
+    for(i = 0; i < sizeof(stack); i += page)
+    {
+        stack[i] = 0;
+    }
+}
 
 /****************************************************************************
  *
@@ -49,89 +74,249 @@ const char * Acquisition::unknown_adc_units = "Not Known";
 Acquisition::Acquisition()
 {
     DEBUG( "Acquisition model construction...\n");
+    memset(device_serial_m, 0, sizeof(device_serial_m));
     thread_id = 0;
     trigger_slope_m = E_TRIGGER_AUTO;
     trigger_level_m = 0.;
+    streaming_buffer_size_m = BUFFER_SIZE_STREAMING;
+    streaming_buffer_flags_m = 0;
+    acquisition_mode_m = E_ACQUISITION_BLOCK;
+    roll_history_m = ROLL_HISTORY_SAMPLES;
+    frame_sequence_m = 0;
+    pthread_mutex_init(&math_lock_m, NULL);
+    filter_interval_m = 0.;
+    pthread_mutex_init(&filter_lock_m, NULL);
+    decoder_m = NULL;
+    events_drawn_m = false;
+    pthread_mutex_init(&decoder_lock_m, NULL);
+    pthread_mutex_init(&mask_lock_m, NULL);
+    pthread_mutex_init(&analyzer_lock_m, NULL);
+    pthread_mutex_init(&averager_lock_m, NULL);
+    history_m.allocate(WAVEFORM_HISTORY_BUDGET);
+    pthread_mutex_init(&history_lock_m, NULL);
+    live_channels_m = 0;
+    live_sample_interval_m = 0.;
+    live_samples_in_screen_m = 0;
+    live_samples_per_aggregate_m = 1;
+    live_updated_m = false;
+    memset(&live_last_draw_m, 0, sizeof(live_last_draw_m));
+    memset(live_scale_m, 0, sizeof(live_scale_m));
+    record_channels_m = 0;
+    pthread_mutex_init(&record_lock_m, NULL);
 
 }
 
 /****************************************************************************
  *
- * get_instance
+ * open_family - open the first unit of a family, NULL if there is none
  *
  ****************************************************************************/
-Acquisition* Acquisition::get_instance()
+Acquisition* Acquisition::open_family(const char *family)
 {
+    Acquisition *device = NULL;
     device_info_t info;
-    if(NULL == Acquisition::singleton_m)
+
+    if(0 == strcmp(family, "ps2000"))
     {
-        // TODO Need to choose in a dynamic way between 2000 and 3000 series here..
-        do
-        {
 #ifdef HAVE_LIBPS2000
-            Acquisition::singleton_m = Acquisition2000::get_instance();
-            memset(&info, 0, sizeof(device_info_t));
-            Acquisition::singleton_m->get_device_info(&info);
-            if(0 == strncmp( info.device_name, "No device or device not supported", DEVICE_NAME_MAX))
-            {
-                DEBUG("No Picoscope 2000 series found.\n");
-                delete((Acquisition2000*)Acquisition::singleton_m);
-                Acquisition::singleton_m = NULL;
-            }
-            else
-            {
-                break;
-            }
+        device = Acquisition2000::get_instance();
 #endif
+    }
+    else if(0 == strcmp(family, "ps2000a"))
+    {
 #ifdef HAVE_LIBPS2000A
-            Acquisition::singleton_m = Acquisition2000a::get_instance();
-            memset(&info, 0, sizeof(device_info_t));
-            Acquisition::singleton_m->get_device_info(&info);
-            if(0 == strncmp( info.device_name, "No device or device not supported", DEVICE_NAME_MAX))
-            {
-                DEBUG("No Picoscope 2000a series found.\n");
-                delete((Acquisition2000a*)Acquisition::singleton_m);
-                Acquisition::singleton_m = NULL;
-            }
-            else
-            {
-                break;
-            }
+        device = Acquisition2000a::get_instance();
 #endif
+    }
+    else if(0 == strcmp(family, "ps3000"))
+    {
 #ifdef HAVE_LIBPS3000
-            Acquisition::singleton_m = Acquisition3000::get_instance();
-            memset(&info, 0, sizeof(device_info_t));
-            Acquisition::singleton_m->get_device_info(&info);
-            if(0 == strncmp( info.device_name, "No device or device not supported", DEVICE_NAME_MAX))
-            {
-                DEBUG("No Picoscope 3000 series found.\n");
-                delete((Acquisition3000*)Acquisition::singleton_m);
-                Acquisition::singleton_m = NULL;
-            }
-            else
-            {
-                break;
-            }
+        device = Acquisition3000::get_instance();
 #endif
+    }
+    else if(0 == strcmp(family, "ps6000"))
+    {
 #ifdef HAVE_LIBPS6000
-            Acquisition::singleton_m = Acquisition6000::get_instance();
-            memset(&info, 0, sizeof(device_info_t));
-            Acquisition::singleton_m->get_device_info(&info);
-            if(0 == strncmp( info.device_name, "No device or device not supported", DEVICE_NAME_MAX))
+        device = Acquisition6000::get_instance();
+#endif
+    }
+    if(NULL == device)
+    {
+        return NULL;
+    }
+    memset(&info, 0, sizeof(device_info_t));
+    device->get_device_info(&info);
+    if(0 == strncmp( info.device_name, "No device or device not supported", DEVICE_NAME_MAX))
+    {
+        DEBUG("No Picoscope %s series found.\n", family);
+        delete device;
+        return NULL;
+    }
+    return device;
+}
+
+/****************************************************************************
+ *
+ * get_instance
+ *
+ ****************************************************************************/
+Acquisition* Acquisition::get_instance()
+{
+    uint8_t i = 0;
+
+    if(NULL == Acquisition::singleton_m)
+    {
+        // family of the last session first, skipping the probe of the others
+        if(!preferred_family_m.empty())
+        {
+            Acquisition::singleton_m = open_family(preferred_family_m.c_str());
+            if(NULL != Acquisition::singleton_m)
+                family_m = preferred_family_m;
+        }
+        for(i = 0; (NULL != families[i]) && (NULL == Acquisition::singleton_m); i++)
+        {
+            if(preferred_family_m != families[i])
+            {
+                Acquisition::singleton_m = open_family(families[i]);
+                if(NULL != Acquisition::singleton_m)
+                    family_m = families[i];
+            }
+        }
+    }
+
+    return Acquisition::singleton_m;
+}
+
+/****************************************************************************
+ * set preferred family
+ ****************************************************************************/
+void Acquisition::set_preferred_family(const std::string &family)
+{
+    preferred_family_m = family;
+}
+
+/****************************************************************************
+ * get family
+ ****************************************************************************/
+const std::string& Acquisition::get_family(void)
+{
+    return family_m;
+}
+
+/****************************************************************************
+ * set real time scheduling
+ ****************************************************************************/
+int8_t Acquisition::set_realtime(const realtime_spec_t &spec)
+{
+    int8_t ret = 0;
+    int min = 0;
+    int max = 0;
+    int flags = MCL_CURRENT;
+    cpu_set_t cpus;
+    struct rlimit limit;
+
+    realtime_m = spec;
+    if( (SCHED_FIFO == spec.policy) || (SCHED_RR == spec.policy) )
+    {
+        min = sched_get_priority_min(spec.policy);
+        max = sched_get_priority_max(spec.policy);
+        if( (spec.priority < min) || (spec.priority > max) )
+        {
+            WARNING("real time priority %d is out of %d..%d\n", spec.priority, min, max);
+            realtime_m.priority = (spec.priority < min) ? min : max;
+        }
+    }
+    else
+    {
+        realtime_m.policy = SCHED_OTHER;
+        realtime_m.priority = 0;
+    }
+
+    if( spec.cpu >= 0 )
+    {
+        // GUI, export and analysis threads are kept off the acquisition CPU
+        CPU_ZERO(&cpus);
+        if( (spec.cpu < CPU_SETSIZE) &&
+            (0 == pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus)) &&
+            CPU_ISSET(spec.cpu, &cpus) )
+        {
+            CPU_CLR(spec.cpu, &cpus);
+            if( 0 == CPU_COUNT(&cpus) )
             {
-                DEBUG("No Picoscope 6000 series found.\n");
-                delete((Acquisition6000*)Acquisition::singleton_m);
-                Acquisition::singleton_m = NULL;
+                WARNING("CPU %d is the only one, it is shared with the GUI\n", spec.cpu);
             }
-            else
+            else if( 0 != pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) )
             {
-                break;
+                WARNING("cannot keep the GUI off CPU %d\n", spec.cpu);
+                ret = -1;
             }
-#endif
-        }while(0);
+        }
+        else
+        {
+            WARNING("CPU %d is not available, acquisition runs on any CPU\n", spec.cpu);
+            realtime_m.cpu = -1;
+            ret = -1;
+        }
     }
 
-    return Acquisition::singleton_m;
+    if( spec.lock_memory )
+    {
+        // with a limited RLIMIT_MEMLOCK, locking future mappings would make them fail
+        if( (0 == getrlimit(RLIMIT_MEMLOCK, &limit)) && (RLIM_INFINITY == limit.rlim_cur) )
+        {
+            flags |= MCL_FUTURE;
+        }
+        else
+        {
+            WARNING("RLIMIT_MEMLOCK is limited, only current memory and streaming buffers are locked\n");
+        }
+        if( 0 != mlockall(flags) )
+        {
+            WARNING("mlockall failed: %s\n", strerror(errno));
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+/****************************************************************************
+ * get real time scheduling from environment
+ ****************************************************************************/
+void Acquisition::get_realtime_from_env(realtime_spec_t *spec)
+{
+    const char *value = NULL;
+
+    if( NULL == spec )
+    {
+        ERROR("%s : invalid pointer given!\n", __FUNCTION__);
+        return;
+    }
+    *spec = realtime_m;
+    value = getenv("QPICOSCOPE_RT_POLICY");
+    if( NULL != value )
+    {
+        if( 0 == strcmp(value, "fifo") )
+            spec->policy = SCHED_FIFO;
+        else if( 0 == strcmp(value, "rr") )
+            spec->policy = SCHED_RR;
+        else
+            spec->policy = SCHED_OTHER;
+    }
+    value = getenv("QPICOSCOPE_RT_PRIORITY");
+    if( NULL != value )
+    {
+        spec->priority = atoi(value);
+    }
+    value = getenv("QPICOSCOPE_RT_CPU");
+    if( NULL != value )
+    {
+        spec->cpu = atoi(value);
+    }
+    value = getenv("QPICOSCOPE_RT_MLOCK");
+    if( NULL != value )
+    {
+        spec->lock_memory = (0 != atoi(value));
+    }
 }
 
 /****************************************************************************
@@ -143,6 +328,16 @@ Acquisition::~Acquisition()
 {
     if( thread_id )
         stop();
+    pthread_mutex_destroy(&math_lock_m);
+    pthread_mutex_destroy(&filter_lock_m);
+    if( NULL != decoder_m )
+        delete decoder_m;
+    pthread_mutex_destroy(&decoder_lock_m);
+    pthread_mutex_destroy(&mask_lock_m);
+    pthread_mutex_destroy(&analyzer_lock_m);
+    pthread_mutex_destroy(&averager_lock_m);
+    pthread_mutex_destroy(&history_lock_m);
+    pthread_mutex_destroy(&record_lock_m);
 }
 
 /****************************************************************************
@@ -197,10 +392,36 @@ double Acquisition::adc_multipliers (short time_units)
 void Acquisition::start(void)
 {
     int ret = 0;
+    pthread_attr_t attr;
+    struct sched_param param;
+    cpu_set_t cpus;
     if(0 == thread_id)
     {
         sem_init(&thread_stop, 0, 0);
-        ret = pthread_create(&thread_id, NULL, Acquisition::threadAcquisition, NULL);
+        pthread_attr_init(&attr);
+        if( SCHED_OTHER != realtime_m.policy )
+        {
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = realtime_m.priority;
+            pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attr, realtime_m.policy);
+            pthread_attr_setschedparam(&attr, &param);
+        }
+        if( realtime_m.cpu >= 0 )
+        {
+            CPU_ZERO(&cpus);
+            CPU_SET(realtime_m.cpu, &cpus);
+            pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+        }
+        ret = pthread_create(&thread_id, &attr, Acquisition::threadAcquisition, NULL);
+        if( (EPERM == ret) && (SCHED_OTHER != realtime_m.policy) )
+        {
+            // neither CAP_SYS_NICE nor RLIMIT_RTPRIO: acquire anyway
+            WARNING("not allowed to run at real time priority %d\n", realtime_m.priority);
+            pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+            ret = pthread_create(&thread_id, &attr, Acquisition::threadAcquisition, NULL);
+        }
+        pthread_attr_destroy(&attr);
         if( 0 != ret )
         {
             ERROR("pthread_create failed and returned %d\n", ret);
@@ -235,21 +456,39 @@ void* Acquisition::threadAcquisition(void* arg)
     (void)arg;
     if ( NULL != acquisition )
     {
+         if( (SCHED_OTHER != realtime_m.policy) || realtime_m.lock_memory )
+         {
+             prefault_stack();
+         }
          /* 
           * May not be supported by all devices... 
           * acquisition->collect_streaming();
           */
-
-         /*
-          * Acquisition might be triggered or not...
-          */
-         if(acquisition->trigger_slope_m == E_TRIGGER_AUTO)
-         {
-             acquisition->collect_block_immediate();
-         }
-         else
+         switch(acquisition->acquisition_mode_m)
          {
-             acquisition->collect_block_triggered(acquisition->trigger_slope_m, acquisition->trigger_level_m);
+             case E_ACQUISITION_FAST_STREAMING:
+                 acquisition->collect_fast_streaming();
+                 break;
+             case E_ACQUISITION_ROLL:
+                 acquisition->collect_streaming();
+                 break;
+             case E_ACQUISITION_ETS:
+                 acquisition->collect_block_ets();
+                 break;
+             case E_ACQUISITION_BLOCK:
+             default:
+                 /*
+                  * Acquisition might be triggered or not...
+                  */
+                 if(acquisition->trigger_slope_m == E_TRIGGER_AUTO)
+                 {
+                     acquisition->collect_block_immediate();
+                 }
+                 else
+                 {
+                     acquisition->collect_block_triggered(acquisition->trigger_slope_m, acquisition->trigger_level_m);
+                 }
+                 break;
          }
     }
     else
@@ -268,3 +507,908 @@ void Acquisition::set_trigger (trigger_e trigger_slope, double trigger_level)
    trigger_slope_m = trigger_slope;
    trigger_level_m = trigger_level;
 }
+
+/****************************************************************************
+ * set acquisition mode
+ ****************************************************************************/
+void Acquisition::set_acquisition_mode (acquisition_mode_e mode)
+{
+   acquisition_mode_m = mode;
+   /* block captures reuse the pool buffers backing the fast streaming record */
+   pthread_mutex_lock(&record_lock_m);
+   record_channels_m = 0;
+   pthread_mutex_unlock(&record_lock_m);
+}
+
+/****************************************************************************
+ * set streaming buffers size
+ ****************************************************************************/
+void Acquisition::set_streaming_buffer(uint32_t nb_samples, uint8_t flags)
+{
+   streaming_buffer_size_m = nb_samples;
+   streaming_buffer_flags_m = flags;
+}
+
+/****************************************************************************
+ * set roll mode history
+ ****************************************************************************/
+void Acquisition::set_roll_history(uint32_t nb_samples)
+{
+   roll_history_m = nb_samples;
+}
+
+/****************************************************************************
+ * set math channel expression
+ ****************************************************************************/
+int8_t Acquisition::set_math_expression(const std::string &expression)
+{
+   int8_t ret = 0;
+
+   pthread_mutex_lock(&math_lock_m);
+   ret = math_m.compile(expression);
+   pthread_mutex_unlock(&math_lock_m);
+   return ret;
+}
+
+/****************************************************************************
+ * set filter
+ ****************************************************************************/
+void Acquisition::set_filter(const filter_spec_t &spec)
+{
+   uint8_t ch = 0;
+
+   pthread_mutex_lock(&filter_lock_m);
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       filters_m[ch].configure(spec);
+       filters_m[ch].prepare(filter_interval_m);
+   }
+   pthread_mutex_unlock(&filter_lock_m);
+}
+
+/****************************************************************************
+ * filter start
+ ****************************************************************************/
+void Acquisition::filter_start (double sample_interval)
+{
+   uint8_t ch = 0;
+
+   pthread_mutex_lock(&filter_lock_m);
+   filter_interval_m = sample_interval;
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       filters_m[ch].prepare(sample_interval);
+   }
+   pthread_mutex_unlock(&filter_lock_m);
+}
+
+/****************************************************************************
+ * filter samples
+ ****************************************************************************/
+void Acquisition::filter_samples (uint8_t channel, const short *in, short *out, uint32_t nb_samples)
+{
+   pthread_mutex_lock(&filter_lock_m);
+   filters_m[channel].process(in, out, nb_samples);
+   pthread_mutex_unlock(&filter_lock_m);
+}
+
+/****************************************************************************
+ * filter delay
+ ****************************************************************************/
+uint32_t Acquisition::filter_delay (void)
+{
+   uint32_t delay = 0;
+
+   /* every channel runs the same specification */
+   pthread_mutex_lock(&filter_lock_m);
+   delay = filters_m[0].delay();
+   pthread_mutex_unlock(&filter_lock_m);
+   return delay;
+}
+
+/****************************************************************************
+ * set decoder
+ ****************************************************************************/
+int8_t Acquisition::set_decoder(const decoder_spec_t &spec)
+{
+   ProtocolDecoder *decoder = ProtocolDecoder::create(spec);
+
+   if( (NULL == decoder) && (E_DECODER_NONE != spec.protocol) )
+   {
+       return -1;
+   }
+   pthread_mutex_lock(&decoder_lock_m);
+   if( NULL != decoder_m )
+       delete decoder_m;
+   decoder_m = decoder;
+   pthread_mutex_unlock(&decoder_lock_m);
+   return 0;
+}
+
+/****************************************************************************
+ * set mask
+ ****************************************************************************/
+int8_t Acquisition::set_mask(const mask_spec_t &spec)
+{
+   int8_t ret = 0;
+
+   pthread_mutex_lock(&mask_lock_m);
+   ret = mask_m.configure(spec);
+   pthread_mutex_unlock(&mask_lock_m);
+   return ret;
+}
+
+/****************************************************************************
+ * get mask results
+ ****************************************************************************/
+void Acquisition::get_mask_results(uint32_t *passed, uint32_t *failed)
+{
+   pthread_mutex_lock(&mask_lock_m);
+   *passed = mask_m.passed();
+   *failed = mask_m.failed();
+   pthread_mutex_unlock(&mask_lock_m);
+}
+
+/****************************************************************************
+ * get mask failure
+ ****************************************************************************/
+int8_t Acquisition::get_mask_failure(uint32_t index, mask_failure_t *failure, std::vector<short> &samples)
+{
+   const mask_failure_t *kept = NULL;
+   int8_t ret = -1;
+
+   pthread_mutex_lock(&mask_lock_m);
+   kept = mask_m.failure(index);
+   if( NULL != kept )
+   {
+       *failure = *kept;
+       samples.assign(kept->block.raw, kept->block.raw + kept->block.count);
+       failure->block.raw = samples.empty() ? NULL : &samples[0];
+       ret = 0;
+   }
+   pthread_mutex_unlock(&mask_lock_m);
+   return ret;
+}
+
+/****************************************************************************
+ * mask test
+ ****************************************************************************/
+int8_t Acquisition::mask_test (const sample_frame_t *frame, uint32_t first, uint32_t nb_samples)
+{
+   uint8_t ch = 0;
+   int8_t ret = -1;
+
+   pthread_mutex_lock(&mask_lock_m);
+   ch = mask_m.channel();
+   if( mask_m.enabled() && (frame->channels & (1 << ch)) )
+   {
+       ret = mask_m.test(&frame->blocks[ch], first, nb_samples, frame->sequence);
+   }
+   pthread_mutex_unlock(&mask_lock_m);
+   return ret;
+}
+
+/****************************************************************************
+ * set analysis
+ ****************************************************************************/
+int8_t Acquisition::set_analysis(const analysis_spec_t &spec)
+{
+   int8_t ret = 0;
+
+   pthread_mutex_lock(&analyzer_lock_m);
+   ret = analyzer_m.configure(spec);
+   pthread_mutex_unlock(&analyzer_lock_m);
+   return ret;
+}
+
+/****************************************************************************
+ * get analysis
+ ****************************************************************************/
+void Acquisition::get_analysis(analysis_result_t *result)
+{
+   pthread_mutex_lock(&analyzer_lock_m);
+   analyzer_m.read(result);
+   pthread_mutex_unlock(&analyzer_lock_m);
+}
+
+/****************************************************************************
+ * analyze
+ ****************************************************************************/
+void Acquisition::analyze (const sample_frame_t *frame, uint32_t first, uint32_t nb_samples)
+{
+   const sample_block_t *block = NULL;
+   uint8_t ch = 0;
+
+   pthread_mutex_lock(&analyzer_lock_m);
+   if( analyzer_m.enabled() )
+   {
+       for(ch = 0; ch < MAX_CHANNELS; ch++)
+       {
+           block = &frame->blocks[ch];
+           if( !(frame->channels & (1 << ch)) || (first + nb_samples > block->count) )
+               continue;
+           // ETS samples are not evenly spaced: nothing to fold
+           analyzer_m.accumulate(ch, block->raw + first, nb_samples, block->scale,
+                                 (NULL == block->times) ? block->dt : 0., false);
+       }
+   }
+   pthread_mutex_unlock(&analyzer_lock_m);
+}
+
+/****************************************************************************
+ * analyze samples
+ ****************************************************************************/
+void Acquisition::analyze_samples (uint8_t channel, const short *samples, uint32_t nb_samples, double scale, double dt)
+{
+   pthread_mutex_lock(&analyzer_lock_m);
+   analyzer_m.accumulate(channel, samples, nb_samples, scale, dt, true);
+   pthread_mutex_unlock(&analyzer_lock_m);
+}
+
+/****************************************************************************
+ * set averaging
+ ****************************************************************************/
+void Acquisition::set_averaging(const average_spec_t &spec)
+{
+   pthread_mutex_lock(&averager_lock_m);
+   averager_m.configure(spec);
+   pthread_mutex_unlock(&averager_lock_m);
+}
+
+/****************************************************************************
+ * average start
+ ****************************************************************************/
+void Acquisition::average_start (uint32_t nb_samples)
+{
+   pthread_mutex_lock(&averager_lock_m);
+   /* on failure averaging is skipped, captures are drawn as they come */
+   averager_m.allocate(nb_samples);
+   pthread_mutex_unlock(&averager_lock_m);
+}
+
+/****************************************************************************
+ * average samples
+ ****************************************************************************/
+const short *Acquisition::average_samples (uint8_t channel, const short *samples, uint32_t first, uint32_t nb_samples, bool *interleaved)
+{
+   const short *averaged = NULL;
+
+   pthread_mutex_lock(&averager_lock_m);
+   averaged = averager_m.accumulate(channel, samples, first, nb_samples);
+   *interleaved = averager_m.interleaved();
+   pthread_mutex_unlock(&averager_lock_m);
+   return averaged;
+}
+
+/****************************************************************************
+ * set history budget
+ ****************************************************************************/
+int8_t Acquisition::set_history_budget(size_t budget)
+{
+   int8_t ret = 0;
+
+   pthread_mutex_lock(&history_lock_m);
+   ret = history_m.allocate(budget);
+   pthread_mutex_unlock(&history_lock_m);
+   return ret;
+}
+
+/****************************************************************************
+ * get history count
+ ****************************************************************************/
+uint32_t Acquisition::get_history_count(void)
+{
+   uint32_t count = 0;
+
+   pthread_mutex_lock(&history_lock_m);
+   count = history_m.count();
+   pthread_mutex_unlock(&history_lock_m);
+   return count;
+}
+
+/****************************************************************************
+ * get history frame
+ ****************************************************************************/
+int8_t Acquisition::get_history_frame(uint32_t age, history_frame_t *kept, std::vector<short> &samples, std::vector<double> &times)
+{
+   const history_frame_t *frame = NULL;
+   size_t nb_samples = 0;
+   size_t nb_times = 0;
+   uint8_t ch = 0;
+   int8_t ret = -1;
+
+   pthread_mutex_lock(&history_lock_m);
+   frame = history_m.frame(age);
+   if( NULL != frame )
+   {
+       *kept = *frame;
+       for(ch = 0; ch < FRAME_CHANNELS; ch++)
+       {
+           if( frame->frame.channels & (1 << ch) )
+           {
+               nb_samples += frame->frame.blocks[ch].count;
+               if( NULL != frame->frame.blocks[ch].times )
+                   nb_times += frame->frame.blocks[ch].count;
+           }
+       }
+       // sized first: blocks point in the tables
+       samples.resize(nb_samples);
+       times.resize(nb_times);
+       nb_samples = 0;
+       nb_times = 0;
+       for(ch = 0; ch < FRAME_CHANNELS; ch++)
+       {
+           if( frame->frame.channels & (1 << ch) )
+           {
+               std::copy(frame->frame.blocks[ch].raw, frame->frame.blocks[ch].raw + frame->frame.blocks[ch].count, samples.begin() + nb_samples);
+               kept->frame.blocks[ch].raw = &samples[nb_samples];
+               nb_samples += frame->frame.blocks[ch].count;
+               if( NULL != frame->frame.blocks[ch].times )
+               {
+                   std::copy(frame->frame.blocks[ch].times, frame->frame.blocks[ch].times + frame->frame.blocks[ch].count, times.begin() + nb_times);
+                   kept->frame.blocks[ch].times = &times[nb_times];
+                   nb_times += frame->frame.blocks[ch].count;
+               }
+           }
+       }
+       ret = 0;
+   }
+   pthread_mutex_unlock(&history_lock_m);
+   return ret;
+}
+
+/****************************************************************************
+ * get record info
+ ****************************************************************************/
+int8_t Acquisition::get_record_info(record_info_t *info)
+{
+   uint64_t first = 0;
+   uint64_t last = 0;
+   uint8_t ch = 0;
+
+   memset(info, 0, sizeof(*info));
+   pthread_mutex_lock(&record_lock_m);
+   info->channels = record_channels_m;
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       if( !(record_channels_m & (1 << ch)) )
+       {
+           continue;
+       }
+       // channels are appended one after the other: keep the range they all hold
+       if( (0 == last) || (record_m[ch].total() < last) )
+           last = record_m[ch].total();
+       if( record_m[ch].total() - record_m[ch].size() > first )
+           first = record_m[ch].total() - record_m[ch].size();
+       info->scale[ch] = live_scale_m[ch];
+   }
+   info->dt = live_sample_interval_m;
+   pthread_mutex_unlock(&record_lock_m);
+   if( (0 == info->channels) || (last <= first) )
+   {
+       return -1;
+   }
+   info->first = first;
+   info->count = last - first;
+   return 0;
+}
+
+/****************************************************************************
+ * read record
+ ****************************************************************************/
+uint32_t Acquisition::read_record(uint8_t ch, uint64_t first, short *out, uint32_t nb_samples)
+{
+   uint64_t oldest = 0;
+   uint32_t count = 0;
+
+   if( ch >= MAX_CHANNELS )
+   {
+       return 0;
+   }
+   pthread_mutex_lock(&record_lock_m);
+   oldest = record_m[ch].total() - record_m[ch].size();
+   if( (record_channels_m & (1 << ch)) && (first >= oldest) )
+   {
+       count = record_m[ch].copy((uint32_t)(first - oldest), out, nb_samples);
+   }
+   pthread_mutex_unlock(&record_lock_m);
+   return count;
+}
+
+/****************************************************************************
+ * decode start
+ ****************************************************************************/
+void Acquisition::decode_start (double time, bool clear_events)
+{
+   pthread_mutex_lock(&decoder_lock_m);
+   if( NULL != decoder_m )
+   {
+       decoder_m->reset(time);
+       if( clear_events )
+           decoder_m->clear_events();
+   }
+   pthread_mutex_unlock(&decoder_lock_m);
+}
+
+/****************************************************************************
+ * decode samples
+ ****************************************************************************/
+void Acquisition::decode_samples (const short * const *raw, const double *scale, uint32_t nb_samples, double sample_interval)
+{
+   pthread_mutex_lock(&decoder_lock_m);
+   if( (NULL != decoder_m) && !decoder_m->spec().digital )
+   {
+       decoder_m->feed_analog(raw, scale, nb_samples, sample_interval);
+   }
+   pthread_mutex_unlock(&decoder_lock_m);
+}
+
+/****************************************************************************
+ * decode digital
+ ****************************************************************************/
+void Acquisition::decode_digital (const DigitalBlock *block)
+{
+   pthread_mutex_lock(&decoder_lock_m);
+   if( (NULL != decoder_m) && decoder_m->spec().digital )
+   {
+       decoder_m->feed_digital(block);
+   }
+   pthread_mutex_unlock(&decoder_lock_m);
+}
+
+/****************************************************************************
+ * decode time
+ ****************************************************************************/
+double Acquisition::decode_time (void)
+{
+   double time = 0.;
+
+   pthread_mutex_lock(&decoder_lock_m);
+   if( NULL != decoder_m )
+       time = decoder_m->time();
+   pthread_mutex_unlock(&decoder_lock_m);
+   return time;
+}
+
+/****************************************************************************
+ * draw events
+ ****************************************************************************/
+void Acquisition::draw_events (double offset)
+{
+   uint32_t i = 0;
+   decoder_event_t event;
+
+   if( NULL == draw )
+   {
+       return;
+   }
+   pthread_mutex_lock(&decoder_lock_m);
+   drawn_events_m.clear();
+   if( NULL != decoder_m )
+   {
+       const std::vector<decoder_event_t> &events = decoder_m->events();
+       for(i = 0; i < events.size(); i++)
+       {
+           // events scrolled out on the left are not drawn
+           if( events[i].end < offset )
+               continue;
+           event = events[i];
+           event.time -= offset;
+           event.end -= offset;
+           drawn_events_m.push_back(event);
+       }
+   }
+   pthread_mutex_unlock(&decoder_lock_m);
+   // nothing to send when annotations are already removed
+   if( drawn_events_m.empty() && !events_drawn_m )
+   {
+       return;
+   }
+   draw->setEvents(drawn_events_m.empty() ? NULL : &drawn_events_m[0], drawn_events_m.size());
+   events_drawn_m = !drawn_events_m.empty();
+}
+
+/****************************************************************************
+ * reserve streaming buffers
+ ****************************************************************************/
+int8_t Acquisition::reserve_streaming_buffers (uint32_t min_samples)
+{
+   uint32_t nb_samples = (streaming_buffer_size_m < min_samples) ? min_samples : streaming_buffer_size_m;
+   /* record may be backed by the buffers about to be reallocated */
+   pthread_mutex_lock(&record_lock_m);
+   record_channels_m = 0;
+   pthread_mutex_unlock(&record_lock_m);
+   if( 0 != buffer_pool_m.reserve(nb_samples, streaming_buffer_flags_m | (realtime_m.lock_memory ? BUFFER_POOL_MLOCK : 0)) )
+   {
+       ERROR("cannot reserve %u samples for streaming\n", nb_samples);
+       return -1;
+   }
+   /* driver callbacks give at most a pool of samples: filtering them does not allocate */
+   filtered_m.reserve(nb_samples);
+   reserve_processing(nb_samples);
+   return 0;
+}
+
+/****************************************************************************
+ * reserve processing
+ ****************************************************************************/
+void Acquisition::reserve_processing (uint32_t nb_samples)
+{
+   uint8_t ch = 0;
+
+   pthread_mutex_lock(&filter_lock_m);
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       filters_m[ch].reserve(nb_samples);
+   }
+   pthread_mutex_unlock(&filter_lock_m);
+   pthread_mutex_lock(&mask_lock_m);
+   mask_m.reserve(nb_samples);
+   pthread_mutex_unlock(&mask_lock_m);
+   pthread_mutex_lock(&analyzer_lock_m);
+   analyzer_m.reserve(nb_samples);
+   pthread_mutex_unlock(&analyzer_lock_m);
+   if( NULL != draw )
+   {
+       draw->reserveFrame(nb_samples);
+   }
+}
+
+/****************************************************************************
+ * live streaming setup
+ ****************************************************************************/
+int8_t Acquisition::live_streaming_setup (uint8_t channels, double sample_interval, uint32_t samples_in_screen)
+{
+   uint32_t aggregates_in_screen = 0;
+   uint8_t ch = 0;
+
+   live_channels_m = 0;
+   if( (0 == buffer_pool_m.capacity()) || (0 == samples_in_screen) )
+   {
+       ERROR("streaming buffers are not reserved\n");
+       return -1;
+   }
+
+   pthread_mutex_lock(&record_lock_m);
+   record_channels_m = 0;
+   pthread_mutex_unlock(&record_lock_m);
+   live_samples_per_aggregate_m = samples_in_screen / LIVE_STREAMING_POINTS;
+   if( 0 == live_samples_per_aggregate_m )
+   {
+       live_samples_per_aggregate_m = 1;
+   }
+   aggregates_in_screen = (samples_in_screen + live_samples_per_aggregate_m - 1) / live_samples_per_aggregate_m;
+   /* strip chart draws a max and a min point per aggregate in the pool buffers */
+   if( 2 * aggregates_in_screen > buffer_pool_m.capacity() )
+   {
+       aggregates_in_screen = buffer_pool_m.capacity() / 2;
+   }
+
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       if( channels & (1 << ch) )
+       {
+           if( (0 != overview_max_m[ch].allocate(aggregates_in_screen)) ||
+               (0 != overview_min_m[ch].allocate(aggregates_in_screen)) )
+           {
+               return -1;
+           }
+           record_m[ch].attach(buffer_pool_m.raw(ch), buffer_pool_m.capacity());
+       }
+       live_aggregate_count_m[ch] = 0;
+       live_aggregate_max_m[ch] = SHRT_MIN;
+       live_aggregate_min_m[ch] = SHRT_MAX;
+   }
+
+   filter_start(sample_interval);
+   decode_start(0., true);
+   live_sample_interval_m = sample_interval;
+   live_samples_in_screen_m = samples_in_screen;
+   live_updated_m = false;
+   memset(&live_last_draw_m, 0, sizeof(live_last_draw_m));
+   live_channels_m = channels;
+   pthread_mutex_lock(&record_lock_m);
+   record_channels_m = channels;
+   pthread_mutex_unlock(&record_lock_m);
+   DEBUG("%u samples per aggregate, %u aggregates in screen\n", live_samples_per_aggregate_m, aggregates_in_screen);
+   return 0;
+}
+
+/****************************************************************************
+ * live streaming append - called from driver callback
+ ****************************************************************************/
+void Acquisition::live_streaming_append (short **overview_buffers, unsigned long nb_values)
+{
+   uint8_t ch = 0;
+   unsigned long i = 0;
+   const short *samples = NULL;
+   const short *raw[MAX_CHANNELS] = {NULL};
+   short max = 0;
+   short min = 0;
+   uint32_t count = 0;
+
+   if( (0 == live_channels_m) || (NULL == overview_buffers) )
+   {
+       return;
+   }
+   /* no driver aggregation: max buffers hold the samples */
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       raw[ch] = (live_channels_m & (1 << ch)) ? overview_buffers[2 * ch] : NULL;
+   }
+   decode_samples(raw, live_scale_m, nb_values, live_sample_interval_m);
+
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       if( !(live_channels_m & (1 << ch)) || (NULL == overview_buffers[2 * ch]) )
+       {
+           continue;
+       }
+       /* no driver aggregation: max buffer holds the samples */
+       samples = overview_buffers[2 * ch];
+       if( filters_m[ch].active() && (nb_values > 0) )
+       {
+           filtered_m.resize(nb_values);
+           filter_samples(ch, samples, &filtered_m[0], nb_values);
+           samples = &filtered_m[0];
+       }
+       analyze_samples(ch, samples, nb_values, live_scale_m[ch], live_sample_interval_m);
+       pthread_mutex_lock(&record_lock_m);
+       record_m[ch].append(samples, nb_values);
+       pthread_mutex_unlock(&record_lock_m);
+
+       max = live_aggregate_max_m[ch];
+       min = live_aggregate_min_m[ch];
+       count = live_aggregate_count_m[ch];
+       for(i = 0; i < nb_values; i++)
+       {
+           if(samples[i] > max)
+               max = samples[i];
+           if(samples[i] < min)
+               min = samples[i];
+           if(++count == live_samples_per_aggregate_m)
+           {
+               overview_max_m[ch].append(&max, 1);
+               overview_min_m[ch].append(&min, 1);
+               max = SHRT_MIN;
+               min = SHRT_MAX;
+               count = 0;
+           }
+       }
+       live_aggregate_max_m[ch] = max;
+       live_aggregate_min_m[ch] = min;
+       live_aggregate_count_m[ch] = count;
+   }
+   live_updated_m = true;
+}
+
+/****************************************************************************
+ * live streaming draw - strip chart, newest aggregate on the right
+ ****************************************************************************/
+void Acquisition::live_streaming_draw (void)
+{
+   struct timeval now;
+   long elapsed_ms = 0;
+   uint8_t ch = 0;
+   uint32_t i = 0;
+   uint32_t nb_aggregates = 0;
+   uint32_t first = 0;
+   double aggregate_interval = live_sample_interval_m * live_samples_per_aggregate_m;
+   double window = 0.;
+   short *raw = NULL;
+   sample_frame_t frame;
+
+   if( (0 == live_channels_m) || !live_updated_m || (NULL == draw) )
+   {
+       return;
+   }
+   gettimeofday(&now, NULL);
+   elapsed_ms = (now.tv_sec - live_last_draw_m.tv_sec) * 1000 + (now.tv_usec - live_last_draw_m.tv_usec) / 1000;
+   if( elapsed_ms < LIVE_STREAMING_REFRESH_MS )
+   {
+       return;
+   }
+   live_last_draw_m = now;
+   live_updated_m = false;
+
+   frame.triggered = 0;
+   frame.trigger_time = 0.;
+   frame.channels = live_channels_m;
+   frame.digital = NULL;
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       if( !(live_channels_m & (1 << ch)) )
+       {
+           continue;
+       }
+       /* aggregates as max/min pairs at half the aggregate interval */
+       raw = buffer_pool_m.screen(ch);
+       nb_aggregates = overview_max_m[ch].size();
+       for(i = 0; i < nb_aggregates; i++)
+       {
+           raw[2 * i]     = overview_max_m[ch].at(i);
+           raw[2 * i + 1] = overview_min_m[ch].at(i);
+       }
+       /* right align the trace: an empty screen fills from the right */
+       first = overview_max_m[ch].capacity() - nb_aggregates;
+       frame.blocks[ch].raw = raw;
+       frame.blocks[ch].count = 2 * nb_aggregates;
+       frame.blocks[ch].stable = 0;
+       frame.blocks[ch].scale = live_scale_m[ch];
+       frame.blocks[ch].dt = aggregate_interval / 2.;
+       frame.blocks[ch].t0 = first * aggregate_interval;
+       frame.blocks[ch].times = NULL;
+       window = overview_max_m[ch].capacity() * aggregate_interval;
+   }
+   draw_frame(&frame, decode_time() - window);
+}
+
+/****************************************************************************
+ * live streaming draw record - last screen at full resolution
+ ****************************************************************************/
+void Acquisition::live_streaming_draw_record (void)
+{
+   uint8_t ch = 0;
+   short *raw = NULL;
+   sample_frame_t frame;
+
+   frame.triggered = 0;
+   frame.trigger_time = 0.;
+   frame.channels = live_channels_m;
+   frame.digital = NULL;
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       if( !(live_channels_m & (1 << ch)) )
+       {
+           continue;
+       }
+       /* record rings sit in the pool counts, the screen is copied aside */
+       raw = buffer_pool_m.screen(ch);
+       frame.blocks[ch].raw = raw;
+       frame.blocks[ch].count = record_m[ch].copy_last(raw, live_samples_in_screen_m);
+       frame.blocks[ch].stable = 0;
+       frame.blocks[ch].scale = live_scale_m[ch];
+       frame.blocks[ch].dt = live_sample_interval_m;
+       frame.blocks[ch].t0 = (live_samples_in_screen_m - frame.blocks[ch].count) * live_sample_interval_m;
+       frame.blocks[ch].times = NULL;
+   }
+   if( 0 != live_channels_m )
+   {
+       draw_frame(&frame, decode_time() - live_samples_in_screen_m * live_sample_interval_m);
+   }
+   live_channels_m = 0;
+}
+
+/****************************************************************************
+ * roll setup
+ ****************************************************************************/
+int8_t Acquisition::roll_setup (uint8_t channels, double sample_interval)
+{
+   uint8_t ch = 0;
+
+   live_channels_m = 0;
+   if( buffer_pool_m.capacity() < ROLL_SAMPLES_IN_SCREEN )
+   {
+       ERROR("streaming buffers are not reserved\n");
+       return -1;
+   }
+   pthread_mutex_lock(&record_lock_m);
+   record_channels_m = 0;
+   pthread_mutex_unlock(&record_lock_m);
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       if( (channels & (1 << ch)) &&
+           (0 != record_m[ch].allocate(ROLL_SAMPLES_IN_SCREEN + roll_history_m)) )
+       {
+           return -1;
+       }
+   }
+   filter_start(sample_interval);
+   decode_start(0., true);
+   live_sample_interval_m = sample_interval;
+   live_samples_in_screen_m = ROLL_SAMPLES_IN_SCREEN;
+   live_channels_m = channels;
+   pthread_mutex_lock(&record_lock_m);
+   record_channels_m = channels;
+   pthread_mutex_unlock(&record_lock_m);
+   return 0;
+}
+
+/****************************************************************************
+ * roll append
+ ****************************************************************************/
+void Acquisition::roll_append (uint8_t channel, const short *samples, uint32_t nb_samples)
+{
+   if( (channel < MAX_CHANNELS) && (live_channels_m & (1 << channel)) )
+   {
+       if( filters_m[channel].active() )
+       {
+           filtered_m.resize(nb_samples);
+           filter_samples(channel, samples, &filtered_m[0], nb_samples);
+           samples = &filtered_m[0];
+       }
+       analyze_samples(channel, samples, nb_samples, live_scale_m[channel], live_sample_interval_m);
+       pthread_mutex_lock(&record_lock_m);
+       record_m[channel].append(samples, nb_samples);
+       pthread_mutex_unlock(&record_lock_m);
+   }
+}
+
+/****************************************************************************
+ * roll draw - newest sample on the right edge of the screen
+ ****************************************************************************/
+void Acquisition::roll_draw (void)
+{
+   uint8_t ch = 0;
+   short *raw = NULL;
+   sample_frame_t frame;
+
+   frame.triggered = 0;
+   frame.trigger_time = 0.;
+   frame.channels = live_channels_m;
+   frame.digital = NULL;
+   for(ch = 0; ch < MAX_CHANNELS; ch++)
+   {
+       if( !(live_channels_m & (1 << ch)) )
+       {
+           continue;
+       }
+       /* record rings own their storage in roll mode, pool counts are free */
+       raw = buffer_pool_m.raw(ch);
+       frame.blocks[ch].raw = raw;
+       frame.blocks[ch].count = record_m[ch].copy_last(raw, live_samples_in_screen_m);
+       frame.blocks[ch].stable = 0;
+       frame.blocks[ch].scale = live_scale_m[ch];
+       frame.blocks[ch].dt = live_sample_interval_m;
+       frame.blocks[ch].t0 = (live_samples_in_screen_m - frame.blocks[ch].count) * live_sample_interval_m;
+       frame.blocks[ch].times = NULL;
+   }
+   /* newest decoded sample sits on the right edge */
+   draw_frame(&frame, decode_time() - live_samples_in_screen_m * live_sample_interval_m);
+}
+
+/****************************************************************************
+ * draw frame
+ ****************************************************************************/
+int8_t Acquisition::draw_frame (sample_frame_t *frame, double decode_offset)
+{
+   int8_t ret = 0;
+
+   if( NULL == draw )
+   {
+       return -1;
+   }
+   frame->sequence = ++frame_sequence_m;
+   /* math channel is computed from the frame channels, once per frame */
+   evaluate_math(frame);
+   ret = draw->setFrame(frame);
+   draw_events(decode_offset);
+   return ret;
+}
+
+/****************************************************************************
+ * evaluate math
+ ****************************************************************************/
+void Acquisition::evaluate_math (sample_frame_t *frame)
+{
+   frame->channels &= ~(1 << MATH_CHANNEL);
+   pthread_mutex_lock(&math_lock_m);
+   if( math_m.enabled() && (0 == math_m.evaluate(frame, &frame->blocks[MATH_CHANNEL])) )
+   {
+       frame->channels |= (1 << MATH_CHANNEL);
+   }
+   pthread_mutex_unlock(&math_lock_m);
+}
+
+/****************************************************************************
+ * history store
+ ****************************************************************************/
+void Acquisition::history_store (const sample_frame_t *frame, bool failed)
+{
+   struct timeval now;
+
+   gettimeofday(&now, NULL);
+   pthread_mutex_lock(&history_lock_m);
+   history_m.store(frame, now.tv_sec + now.tv_usec * 1e-6, failed);
+   pthread_mutex_unlock(&history_lock_m);
+}
@@ -33,6 +33,15 @@
 
 #include "oscilloscope.h"
 #include "drawdata.h"
+#include "bufferpool.h"
+#include "samplering.h"
+#include "mathchannel.h"
+#include "filter.h"
+#include "masktest.h"
+#include "waveformaverager.h"
+#include "etsreconstructor.h"
+#include "waveformhistory.h"
+#include "signalanalyzer.h"
 
 #ifdef WIN32
 /* Headers for Windows */
@@ -51,7 +60,9 @@
 #include <ctype.h>
 #include <stdint.h>
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
+#include <sys/time.h>
 
 /* Definition of PS2000 driver routines on Linux */
 //#define DYNLINK
@@ -61,7 +72,48 @@
 
 #define BUFFER_SIZE           1024
 #define BUFFER_SIZE_STREAMING 100000
-#define MAX_CHANNELS          4
+/* points per screen drawn while fast streaming */
+#define LIVE_STREAMING_POINTS        1000
+/* minimum delay between two live screen refreshes */
+#define LIVE_STREAMING_REFRESH_MS    40
+/* roll mode: 100 points per division, 5 divisions */
+#define ROLL_SAMPLES_IN_SCREEN       500
+/* roll mode: default samples kept per channel besides the screen */
+#define ROLL_HISTORY_SAMPLES         50000
+/* memory kept for the last block captures, in bytes */
+#define WAVEFORM_HISTORY_BUDGET      (64 * 1024 * 1024)
+/* stack of the acquisition thread touched before capturing when it is real time */
+#define REALTIME_STACK_PREFAULT      (256 * 1024)
+
+/**
+ * @brief scheduling of the acquisition thread, see Acquisition::set_realtime()
+ */
+typedef struct
+{
+    /** @brief SCHED_OTHER (default), SCHED_FIFO or SCHED_RR */
+    int policy;
+    /** @brief static priority of SCHED_FIFO and SCHED_RR */
+    int priority;
+    /** @brief CPU the acquisition thread is pinned to, -1 for any CPU */
+    int cpu;
+    /** @brief lock the process memory and the streaming buffers in RAM */
+    bool lock_memory;
+}realtime_spec_t;
+
+/**
+ * @brief full resolution samples held by the streaming record, all channels
+ * are held from absolute sample index first to first + count
+ */
+typedef struct
+{
+    uint8_t channels;
+    uint64_t first;
+    uint64_t count;
+    /** @brief sample interval, in seconds */
+    double dt;
+    /** @brief volts per ADC count */
+    double scale[MAX_CHANNELS];
+}record_info_t;
 
 #define DEVICE_NAME_MAX       80
 #define CHANNEL_OFF           99
@@ -91,6 +143,8 @@ public:
     {
         char    device_name[DEVICE_NAME_MAX];
         uint8_t nb_channels;
+        /** @brief batch and serial number, empty when the driver does not give it */
+        char    serial[DEVICE_NAME_MAX];
     }device_info_t;
 
     typedef enum
@@ -104,6 +158,27 @@ public:
 
     /** @brief get singleton instance */
     static Acquisition* get_instance();
+    /**
+     * @brief set the family probed first by get_instance(), i.e. the one of the last session
+     * @param[in] : family name as given by get_family(), empty for the default order
+     */
+    static void set_preferred_family(const std::string &family);
+    /** @brief family of the opened device ("ps2000", "ps2000a", "ps3000" or "ps6000") */
+    static const std::string& get_family(void);
+    /**
+     * @brief set the scheduling of the acquisition thread, used by next start().
+     * Call it before other threads are created: the calling thread leaves the
+     * acquisition CPU to the acquisition and the threads it creates inherit that.
+     * @param[in] : policy, priority, CPU and memory locking
+     * return : 0 if successful, -1 if a part of it cannot be applied
+     */
+    static int8_t set_realtime(const realtime_spec_t &spec);
+    /**
+     * @brief read QPICOSCOPE_RT_POLICY (fifo, rr), QPICOSCOPE_RT_PRIORITY,
+     * QPICOSCOPE_RT_CPU and QPICOSCOPE_RT_MLOCK, unset ones keep their default
+     * @param[out] : scheduling read from the environment
+     */
+    static void get_realtime_from_env(realtime_spec_t *spec);
     /** @brief destructor */
     virtual ~Acquisition();
     /**
@@ -123,6 +198,11 @@ public:
      * @param[in] : trigger level
      */
     void set_trigger (trigger_e trigger_slope, double trigger_level);
+    /**
+     * @brief set acquisition mode
+     * @param[in] : block captures or live fast streaming
+     */
+    void set_acquisition_mode (acquisition_mode_e mode);
     /**
      * @brief set AC/DC
      * @param[in] : a current_e value (0 = AC, 1 = DC)
@@ -155,11 +235,109 @@ public:
      * @brief set DrawData Class
      */
     void setDrawData(DrawData *drawdata) { draw = drawdata; }
+    /**
+     * @brief set streaming buffers size, used by next streaming run
+     * @param[in] : number of samples per channel (may be millions)
+     * @param[in] : BUFFER_POOL_MLOCK and/or BUFFER_POOL_HUGE_PAGES
+     */
+    void set_streaming_buffer(uint32_t nb_samples, uint8_t flags = 0);
+    /**
+     * @brief set roll mode history, used by next roll mode run
+     * @param[in] : number of samples per channel kept besides the visible screen
+     */
+    void set_roll_history(uint32_t nb_samples);
+    /**
+     * @brief set math channel expression, e.g. "A-B", "2*A+0.5", "intg(A)"
+     * @param[in] : expression, empty or "off" to disable the math channel
+     * return : 0 if successful, -1 if the expression is not understood
+     */
+    int8_t set_math_expression(const std::string &expression);
+    /**
+     * @brief set the filter applied to all channels, effective immediately
+     * @param[in] : filter specification, E_FILTER_NONE to disable
+     */
+    void set_filter(const filter_spec_t &spec);
+    /**
+     * @brief set the protocol decoder, effective immediately
+     * @param[in] : decoder specification, E_DECODER_NONE to disable
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t set_decoder(const decoder_spec_t &spec);
+    /**
+     * @brief set the pass/fail mask tested on each block capture, results are reset
+     * @param[in] : mask specification, E_MASK_NONE to disable
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t set_mask(const mask_spec_t &spec);
+    /**
+     * @brief get mask test counts
+     * @param[out] : number of passed waveforms
+     * @param[out] : number of failed waveforms
+     */
+    void get_mask_results(uint32_t *passed, uint32_t *failed);
+    /**
+     * @brief copy a kept failed waveform
+     * @param[in] : failure index, 0 is the newest
+     * @param[out] : failure, its block raw points to samples
+     * @param[out] : failed samples
+     * return : 0 if successful, -1 if there is no such failure
+     */
+    int8_t get_mask_failure(uint32_t index, mask_failure_t *failure, std::vector<short> &samples);
+    /**
+     * @brief set the amplitude histograms and eye diagram accumulated on each capture, accumulators are cleared
+     * @param[in] : analysis specification, E_ANALYSIS_NONE to disable
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t set_analysis(const analysis_spec_t &spec);
+    /**
+     * @brief copy the analysis accumulators
+     * @param[out] : result
+     */
+    void get_analysis(analysis_result_t *result);
+    /**
+     * @brief set block captures averaging, the average restarts
+     * @param[in] : averaging specification, E_AVERAGE_NONE to disable
+     */
+    void set_averaging(const average_spec_t &spec);
+    /**
+     * @brief set the memory kept for the last block captures, kept captures are lost
+     * @param[in] : budget in bytes, 0 to keep no capture
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t set_history_budget(size_t budget);
+    /** @brief number of kept captures */
+    uint32_t get_history_count(void);
+    /**
+     * @brief copy a kept capture
+     * @param[in] : age, 0 for the newest capture
+     * @param[out] : kept capture, its blocks point to samples and times
+     * @param[out] : samples of all blocks
+     * @param[out] : times of all blocks, for non uniform modes
+     * return : 0 if successful, -1 if there is no such capture
+     */
+    int8_t get_history_frame(uint32_t age, history_frame_t *kept, std::vector<short> &samples, std::vector<double> &times);
+    /**
+     * @brief get the samples held by the record of fast streaming and roll modes
+     * @param[out] : record description
+     * return : 0 if successful, -1 if nothing is recorded
+     */
+    int8_t get_record_info(record_info_t *info);
+    /**
+     * @brief copy recorded samples, may be called while streaming goes on
+     * @param[in] : channel
+     * @param[in] : absolute index of the first sample
+     * @param[out] : table of at least nb_samples elements
+     * @param[in] : number of samples wanted
+     * return : number of samples copied, 0 if they are overwritten or the record restarted
+     */
+    uint32_t read_record(uint8_t ch, uint64_t first, short *out, uint32_t nb_samples);
 protected:
     /**
      * @brief protected methods declarations
      */
     Acquisition();
+    /** @brief batch and serial number read by get_info() of the families */
+    char device_serial_m[DEVICE_NAME_MAX];
     static const char * known_adc_units[]/* = { "ADC", "fs", "ps", "ns", "us", "ms"}*/;
     static const char * unknown_adc_units/* = "Not Known"*/;
     const char * adc_units (short time_units);
@@ -176,12 +354,204 @@ protected:
     virtual void collect_streaming (void) = 0;
     virtual void collect_fast_streaming (void) = 0;
     virtual void collect_fast_streaming_triggered (void) = 0;
+    /**
+     * @brief get streaming buffers ready before a streaming run
+     * @param[in] : minimum number of samples per channel needed by the caller
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t reserve_streaming_buffers (uint32_t min_samples);
+    /**
+     * @brief size filter, mask, analyzer and screen storage before a capture loop
+     * @param[in] : largest number of samples per channel handled at once
+     */
+    void reserve_processing (uint32_t nb_samples);
+    /**
+     * @brief prepare live fast streaming display.
+     * live_scale_m must be set for each channel of the mask before calling.
+     * @param[in] : bit mask of streamed channels (bit 0 for channel A, etc)
+     * @param[in] : sample interval in seconds
+     * @param[in] : number of samples making a screen
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t live_streaming_setup (uint8_t channels, double sample_interval, uint32_t samples_in_screen);
+    /**
+     * @brief store non aggregated fast streaming values (called from driver callback)
+     * @param[in] : driver overview buffers (max, min pairs per channel)
+     * @param[in] : number of values in each buffer
+     */
+    void live_streaming_append (short **overview_buffers, unsigned long nb_values);
+    /**
+     * @brief draw the strip chart built from aggregates, at most every LIVE_STREAMING_REFRESH_MS
+     */
+    void live_streaming_draw (void);
+    /**
+     * @brief draw the last screen at full resolution and end live streaming
+     */
+    void live_streaming_draw_record (void);
+    /**
+     * @brief prepare roll mode: record rings hold the screen plus the history.
+     * live_scale_m must be set for each channel of the mask before calling.
+     * @param[in] : bit mask of streamed channels (bit 0 for channel A, etc)
+     * @param[in] : sample interval in seconds
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t roll_setup (uint8_t channels, double sample_interval);
+    /**
+     * @brief append a batch of streamed samples, costs the batch size only
+     * @param[in] : channel index (0 for channel A, 1 for channel B, etc)
+     * @param[in] : table of raw ADC counts
+     * @param[in] : number of samples
+     */
+    void roll_append (uint8_t channel, const short *samples, uint32_t nb_samples);
+    /**
+     * @brief draw the newest screen, samples scrolling in from the right
+     */
+    void roll_draw (void);
+    /**
+     * @brief start filtering a new run of contiguous samples, filter state is cleared
+     * @param[in] : sample interval in seconds
+     */
+    void filter_start (double sample_interval);
+    /**
+     * @brief filter samples of a channel, continuing from its previous call
+     * @param[in] : channel index (0 for channel A, 1 for channel B, etc)
+     * @param[in] : raw ADC counts
+     * @param[out] : filtered counts, may be the input table
+     * @param[in] : number of samples
+     */
+    void filter_samples (uint8_t channel, const short *in, short *out, uint32_t nb_samples);
+    /**
+     * @brief get delay of filtered samples behind the raw ones
+     * return : group delay in samples, 0 when the filter does not delay
+     */
+    uint32_t filter_delay (void);
+    /**
+     * @brief test a new capture against the mask
+     * @param[in] : frame holding the capture
+     * @param[in] : first sample of the capture in the frame
+     * @param[in] : number of samples of the capture
+     * return : 0 if passed, 1 if failed, -1 if not tested
+     */
+    int8_t mask_test (const sample_frame_t *frame, uint32_t first, uint32_t nb_samples);
+    /**
+     * @brief accumulate a new capture into the analysis, ETS captures feed histograms only
+     * @param[in] : frame holding the capture
+     * @param[in] : first sample of the capture in the frame
+     * @param[in] : number of samples of the capture
+     */
+    void analyze (const sample_frame_t *frame, uint32_t first, uint32_t nb_samples);
+    /**
+     * @brief accumulate streamed samples of a channel into the analysis, continuing from its previous call
+     * @param[in] : channel index (0 for channel A, 1 for channel B, etc)
+     * @param[in] : ADC counts
+     * @param[in] : number of samples
+     * @param[in] : volts per ADC count
+     * @param[in] : sample interval, in seconds, 0 when samples are not evenly spaced
+     */
+    void analyze_samples (uint8_t channel, const short *samples, uint32_t nb_samples, double scale, double dt);
+    /**
+     * @brief start averaging block captures, the average restarts
+     * @param[in] : number of samples of a screen
+     */
+    void average_start (uint32_t nb_samples);
+    /**
+     * @brief add a capture of a channel to its average
+     * @param[in] : channel index (0 for channel A, 1 for channel B, etc)
+     * @param[in] : capture counts, after the filter
+     * @param[in] : first sample of the capture in the screen
+     * @param[in] : number of samples of the capture
+     * @param[out] : true when the result interleaves max and min of each sample
+     * return : averaged counts of the screen, NULL when averaging is disabled
+     */
+    const short *average_samples (uint8_t channel, const short *samples, uint32_t first, uint32_t nb_samples, bool *interleaved);
+    /**
+     * @brief start decoding a new run of contiguous samples, decoder state is cleared
+     * @param[in] : time of the first sample, in seconds
+     * @param[in] : true to also drop previously decoded events
+     */
+    void decode_start (double time, bool clear_events);
+    /**
+     * @brief decode raw samples of analog channels, continuing from the previous call
+     * @param[in] : raw ADC counts per channel, MAX_CHANNELS entries, NULL when not captured
+     * @param[in] : volts per ADC count per channel
+     * @param[in] : number of samples
+     * @param[in] : sample interval in seconds
+     */
+    void decode_samples (const short * const *raw, const double *scale, uint32_t nb_samples, double sample_interval);
+    /**
+     * @brief decode digital lines, continuing from the previous call
+     * @param[in] : digital block
+     */
+    void decode_digital (const DigitalBlock *block);
+    /**
+     * @brief time of the next sample to decode, in seconds
+     */
+    double decode_time (void);
+    /**
+     * @brief annotate decoded events
+     * @param[in] : decoder time of the display time origin, in seconds
+     */
+    void draw_events (double offset);
+    /**
+     * @brief stamp a frame with the next sequence number and draw it with its decoded events
+     * @param[in] : frame, all its channels are displayed together
+     * @param[in] : decoder time of the frame time origin, in seconds
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t draw_frame (sample_frame_t *frame, double decode_offset = 0.);
+    /**
+     * @brief compute the math channel of a frame from its other channels
+     * @param[in,out] : frame, its math block is set when the math channel is enabled
+     */
+    void evaluate_math (sample_frame_t *frame);
+    /**
+     * @brief keep a completed block capture in the history, once per capture
+     * @param[in] : frame holding the capture counts, not their average
+     * @param[in] : the capture failed the mask test
+     */
+    void history_store (const sample_frame_t *frame, bool failed = false);
     /**
      * @brief protected members declarations
      */
 
     sem_t thread_stop;
     DrawData *draw;
+    /** @brief heap buffers shared by all streaming modes */
+    BufferPool buffer_pool_m;
+    uint32_t streaming_buffer_size_m;
+    uint8_t streaming_buffer_flags_m;
+    acquisition_mode_e acquisition_mode_m;
+    uint32_t roll_history_m;
+    uint32_t frame_sequence_m;
+    /** @brief math channel added to each frame, compiled from the GUI thread */
+    MathChannel math_m;
+    pthread_mutex_t math_lock_m;
+    /** @brief filter stage between driver output and display, one state per channel */
+    Filter filters_m[MAX_CHANNELS];
+    double filter_interval_m;
+    std::vector<short> filtered_m;
+    pthread_mutex_t filter_lock_m;
+    /** @brief protocol decoder fed with raw driver samples, NULL when disabled */
+    ProtocolDecoder *decoder_m;
+    std::vector<decoder_event_t> drawn_events_m;
+    bool events_drawn_m;
+    pthread_mutex_t decoder_lock_m;
+    /** @brief pass/fail mask tested on block captures */
+    MaskTest mask_m;
+    pthread_mutex_t mask_lock_m;
+    /** @brief amplitude histograms and eye diagram */
+    SignalAnalyzer analyzer_m;
+    pthread_mutex_t analyzer_lock_m;
+    /** @brief integer accumulators of block captures */
+    WaveformAverager averager_m;
+    pthread_mutex_t averager_lock_m;
+    /** @brief last block captures, as drawn */
+    WaveformHistory history_m;
+    pthread_mutex_t history_lock_m;
+    /** @brief waveform rebuilt from ETS passes, used by the acquisition thread only */
+    EtsReconstructor ets_m;
+    /** @brief volts per ADC count of each streamed channel */
+    double live_scale_m[MAX_CHANNELS];
     trigger_e trigger_slope_m;
     double trigger_level_m;
 private:
@@ -194,11 +564,37 @@ private:
      * @brief private methods declarations
      */
     static void* threadAcquisition(void *arg);
+    /** @brief open the first device of a family, NULL if there is none */
+    static Acquisition* open_family(const char *family);
+    static const char * families[];
+    static std::string preferred_family_m;
+    static std::string family_m;
+    /** @brief scheduling of the acquisition thread */
+    static realtime_spec_t realtime_m;
     /**
      * Store singleton output from the factory
      */
     static Acquisition *singleton_m;
     pthread_t thread_id;
+    /** @brief live fast streaming state */
+    uint8_t live_channels_m;
+    double live_sample_interval_m;
+    uint32_t live_samples_in_screen_m;
+    uint32_t live_samples_per_aggregate_m;
+    uint32_t live_aggregate_count_m[MAX_CHANNELS];
+    short live_aggregate_max_m[MAX_CHANNELS];
+    short live_aggregate_min_m[MAX_CHANNELS];
+    bool live_updated_m;
+    struct timeval live_last_draw_m;
+    /** @brief aggregated max/min values making the strip chart */
+    SampleRing overview_max_m[MAX_CHANNELS];
+    SampleRing overview_min_m[MAX_CHANNELS];
+    /** @brief full resolution samples: backed by the buffer pool in fast streaming,
+     * owning screen plus history in roll mode */
+    SampleRing record_m[MAX_CHANNELS];
+    /** @brief channels of record_m readable by read_record(), locked against appends */
+    uint8_t record_channels_m;
+    pthread_mutex_t record_lock_m;
 };
 
 #endif // ACQUISITION_H
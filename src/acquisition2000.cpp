@@ -27,6 +27,7 @@
  */
 
 #include "acquisition2000.h"
+#include "driverlibrary.h"
 
 #ifdef HAVE_LIBPS2000
 
@@ -37,7 +38,57 @@ enum BOOL {FALSE,TRUE};
 
 /* static members initialization */
 Acquisition2000 *Acquisition2000::singleton_m = NULL;
-const short Acquisition2000::input_ranges [] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000};
+const short Ps2000Traits::input_ranges [PS2000_MAX_RANGES] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000};
+
+#ifdef DYNLINK
+/* driver routines, resolved by load_driver() */
+ps2000_api_t ps2000_api;
+static DriverLibrary ps2000_library;
+
+/****************************************************************************
+ *
+ * load_driver - open libps2000 and resolve its routines, once
+ *
+ ****************************************************************************/
+static int8_t load_driver (void)
+{
+    static const char *const names[] = PS2000_LIBRARIES;
+
+    if( ps2000_library.loaded() )
+    {
+        return 0;
+    }
+    if( (0 != ps2000_library.open(names)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_open_unit)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000SetAdvTriggerChannelConditions)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000SetAdvTriggerChannelDirections)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000SetAdvTriggerChannelProperties)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000SetAdvTriggerDelay)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000SetPulseWidthQualifier)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_close_unit)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_get_streaming_last_values)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_get_streaming_values_no_aggregation)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_get_timebase)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_get_times_and_values)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_get_unit_info)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_get_values)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_ready)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_run_block)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_run_streaming)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_run_streaming_ns)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_set_channel)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_set_ets)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_set_sig_gen_arbitrary)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_set_sig_gen_built_in)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_set_trigger)) ||
+        (0 != DRIVER_RESOLVE(ps2000_library, ps2000_stop)) )
+    {
+        ps2000_library.close();
+        return -1;
+    }
+    return 0;
+}
+#endif
 
 /****************************************************************************
  *
@@ -45,11 +96,20 @@ const short Acquisition2000::input_ranges [] = {10, 20, 50, 100, 200, 500, 1000,
  *
  ****************************************************************************/
 Acquisition2000::Acquisition2000() :
-    scale_to_mv(1),
     timebase(8)
 {
     DEBUG( "Opening the device...\n");
 
+#ifdef DYNLINK
+    if( 0 != load_driver() )
+    {
+        DEBUG ( "libps2000 is not installed\n" );
+        unitOpened_m.handle = 0;
+        unitOpened_m.model = MODEL_NONE;
+        return;
+    }
+#endif
+
     //open unit and show splash screen
     unitOpened_m.handle = ps2000_open_unit ();
     DEBUG ( "Handle: %d\n", unitOpened_m.handle );
@@ -93,32 +153,12 @@ Acquisition2000* Acquisition2000::get_instance()
 Acquisition2000::~Acquisition2000()
 {
     DEBUG ( "Device destroyed\n" );
-    ps2000_close_unit ( unitOpened_m.handle );
+    if ( unitOpened_m.handle >= 1 )
+        ps2000_close_unit ( unitOpened_m.handle );
     Acquisition2000::singleton_m = NULL;
-}
-
-/****************************************************************************
- *
- * ps2000FastStreamingReady
- *
- ****************************************************************************/
-void  __stdcall Acquisition2000::ps2000FastStreamingReady( short **overviewBuffers,
-                                                              short overflow,
-                                                                unsigned long triggeredAt,
-                                                                short triggered,
-                                                                short auto_stop,
-                                                              unsigned long nValues)
-{
-    (void)overviewBuffers;
-    (void)overflow;
-    (void)triggeredAt;
-    (void)triggered;
-    Acquisition2000* instance = Acquisition2000::get_instance();
-    if(NULL != instance)
-    {
-        instance->unitOpened_m.trigger.advanced.totalSamples += nValues;
-        instance->unitOpened_m.trigger.advanced.autoStop = auto_stop;
-    }
+#ifdef DYNLINK
+    ps2000_library.close();
+#endif
 }
 
 /****************************************************************************
@@ -135,6 +175,7 @@ void Acquisition2000::get_device_info(device_info_t* info)
     }
 
     memset(info, 0, sizeof(device_info_t));
+    snprintf(info->serial, DEVICE_NAME_MAX, "%s", device_serial_m);
 
     switch(unitOpened_m.model)
     {
@@ -273,296 +314,6 @@ void Acquisition2000::set_trigger_advanced(void)
     ok = ps2000SetAdvTriggerDelay (unitOpened_m.handle, 0, -10);
 }
 
-/****************************************************************************
- * Collect_block_immediate
- *  this function demonstrates how to collect a single block of data
- *  from the unit (start collecting immediately)
- ****************************************************************************/
-void Acquisition2000::collect_block_immediate (void)
-{
-    int i = 0;
-    long     time_interval;
-    short     time_units;
-    short     oversample;
-    int     no_of_samples = BUFFER_SIZE;
-    int nb_of_samples_in_screen = 0;
-    short     auto_trigger_ms = 0;
-    long     time_indisposed_ms;
-    short     overflow;
-    long     max_samples;
-    short ch = 0;
-    double* values_V[CHANNEL_MAX] = {NULL};
-    double* time[CHANNEL_MAX] = {NULL};
-    double time_multiplier = 0.;
-    double time_offset[CHANNEL_MAX] = {0.};
-    int index[CHANNEL_MAX] = {0};
-
-    DEBUG ( "Collect block immediate...\n" );
-
-    set_defaults ();
-
-    /* Trigger disabled
-     */
-    ps2000_set_trigger ( unitOpened_m.handle, PS2000_NONE, 0, PS2000_RISING, 0, auto_trigger_ms );
-
-    /*  find the maximum number of samples, the time interval (in time_units),
-    *         the most suitable time units, and the maximum oversample at the current timebase
-    */
-    oversample = 1;
-    while (!ps2000_get_timebase ( unitOpened_m.handle,
-                                timebase,
-                                no_of_samples,
-                                &time_interval,
-                                &time_units,
-                                oversample,
-                                &max_samples))
-    timebase++;                                        ;
-
-    time_multiplier = adc_multipliers(time_units);
-    nb_of_samples_in_screen = (int)(5 * time_per_division_m / (time_interval * time_multiplier)) + 1;
-    nb_of_samples_in_screen = ( nb_of_samples_in_screen < BUFFER_SIZE ? BUFFER_SIZE : nb_of_samples_in_screen);
-    for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-    {
-        if (unitOpened_m.channelSettings[ch].enabled)
-        {
-            values_V[ch] = (double*)malloc(nb_of_samples_in_screen * sizeof(double));
-            time[ch] = (double*)malloc(nb_of_samples_in_screen * sizeof(double));
-        }
-    }
-    DEBUG ( "timebase: %hd\tnb_of_samples:%d\toversample:%hd\ttime_units:%hd\ttime_interval:%lu\ttime_multiplier:%e\tnb_of_samples_in_screen:%d\n", 
-             timebase, no_of_samples, oversample, time_units, time_interval, time_multiplier, nb_of_samples_in_screen );
-
-
-    while ( sem_trywait(&thread_stop) )
-    {
-        /* Start it collecting,
-        *  then wait for completion
-        */
-        ps2000_run_block ( unitOpened_m.handle, no_of_samples, timebase, oversample, &time_indisposed_ms );
-        while ( !ps2000_ready ( unitOpened_m.handle ) )
-        {
-            if( !sem_trywait(&thread_stop) )
-            {
-                /* re-post semaphore to exit the main loop */
-                sem_post(&thread_stop);
-                break;
-            }
-            Sleep ( 100 );
-        }
-
-        ps2000_stop ( unitOpened_m.handle );
-
-        /* Should be done now...
-        *  get the times (in nanoseconds)
-        *   and the values (in ADC counts)
-        */
-        ps2000_get_times_and_values ( unitOpened_m.handle, times,
-                                    unitOpened_m.channelSettings[PS2000_CHANNEL_A].values,
-                                    unitOpened_m.channelSettings[PS2000_CHANNEL_B].values,
-                                    unitOpened_m.channelSettings[PS2000_CHANNEL_C].values,
-                                    unitOpened_m.channelSettings[PS2000_CHANNEL_D].values,
-                                    &overflow, time_units, no_of_samples );
-
-        DEBUG ( "%d values, overflow %d\n", no_of_samples, overflow );
-
-        for (ch = 0; (ch < unitOpened_m.noOfChannels) && (no_of_samples > 0); ch++)
-        {
-            if (unitOpened_m.channelSettings[ch].enabled)
-            {
-                for (  i = 0; (i < no_of_samples) && (index[ch] < nb_of_samples_in_screen) ; i++, index[ch]++ )
-                {
-                    values_V[ch][index[ch]] = 0.001 * adc_to_mv(unitOpened_m.channelSettings[ch].values[i], unitOpened_m.channelSettings[ch].range);
-                    time[ch][index[ch]] = (times[i] * time_multiplier) + time_offset[ch];
-                    //DEBUG("V: %lf (range %d) T: %lf\n", values_V[index[ch]], unitOpened_m.channelSettings[ch].range, time[index[ch]]);
-                }
-                // resetting all available data as long as the screen is not filled.
-                draw->setData(ch+1, time[ch], values_V[ch], index[ch]);
-                DEBUG("set %d data\n", index[ch]);
-                if( (index[ch] >= nb_of_samples_in_screen) || (time[ch][index[ch] - 1] > 5 * time_per_division_m) )
-                {
-                    time_offset[ch] = 0.;
-                    memset(time[ch], 0, nb_of_samples_in_screen * sizeof(double));
-                    memset(values_V[ch], 0, nb_of_samples_in_screen * sizeof(double));
-                    index[ch] = 0;
-                }
-                else
-                {
-                    time_offset[ch] = time[ch][index[ch] - 1];
-                }
-            }
-        }
-        Sleep(100);
-    }
-    for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-    {
-        if (unitOpened_m.channelSettings[ch].enabled)
-        {
-            free(values_V[ch]);
-            free(time[ch]);
-        }
-    }
-}
-
-/****************************************************************************
- * Collect_block_triggered
- *  this function demonstrates how to collect a single block of data from the
- *  unit, when a trigger event occurs.
- ****************************************************************************/
-
-void Acquisition2000::collect_block_triggered (trigger_e trigger_slope, double trigger_level)
-{
-    int i = 0;
-    long     time_interval;
-    short     time_units;
-    short     oversample;
-    int     no_of_samples = BUFFER_SIZE;
-    int nb_of_samples_in_screen = 0;
-    short     auto_trigger_ms = 0;
-    long     time_indisposed_ms;
-    short     overflow;
-    int     threshold_mv = (int)(trigger_level * 1000);
-    long max_samples;
-    short ch = 0;
-    double* values_V[CHANNEL_MAX] = {NULL};
-    double* time[CHANNEL_MAX] = {NULL};
-    double time_multiplier = 0.;
-    double time_offset[CHANNEL_MAX] = {0.};
-    int index[CHANNEL_MAX] = {0};
-    DEBUG ( "Collect block triggered...\n" );
-    DEBUG ( "Collects when value rises past %dmV\n", threshold_mv );
-
-    set_defaults ();
-
-  /* Trigger enabled
-     * ChannelA - to trigger unsing this channel it needs to be enabled using ps2000_set_channel
-   * Rising edge
-   * Threshold = 100mV
-   * 10% pre-trigger  (negative is pre-, positive is post-)
-   */
-    unitOpened_m.trigger.simple.channel = PS2000_CHANNEL_A;
-    switch(trigger_slope)
-    {
-        case E_TRIGGER_FALLING:
-            unitOpened_m.trigger.simple.direction = (short) PS2000_FALLING;
-        break;
-        case E_TRIGGER_RISING:
-        default:
-            unitOpened_m.trigger.simple.direction = (short) PS2000_RISING;
-        break;
-    }
-    unitOpened_m.trigger.simple.threshold = 100.f;
-    unitOpened_m.trigger.simple.delay = -10;
-
-    ps2000_set_trigger ( unitOpened_m.handle,
-                         (short) unitOpened_m.trigger.simple.channel,
-                         mv_to_adc (threshold_mv, unitOpened_m.channelSettings[(short) unitOpened_m.trigger.simple.channel].range),
-                         unitOpened_m.trigger.simple.direction,
-                         (short)unitOpened_m.trigger.simple.delay,
-                         auto_trigger_ms );
-
-
-  /*  find the maximum number of samples, the time interval (in time_units),
-   *         the most suitable time units, and the maximum oversample at the current timebase
-   */
-    oversample = 1;
-    while (!ps2000_get_timebase ( unitOpened_m.handle,
-                                    timebase,
-                                    no_of_samples,
-                                    &time_interval,
-                                    &time_units,
-                                    oversample,
-                                    &max_samples))
-    timebase++;
-
-    time_multiplier = adc_multipliers(time_units);
-    nb_of_samples_in_screen = (int)(5 * time_per_division_m / (time_interval * time_multiplier)) + 1;
-    nb_of_samples_in_screen = ( nb_of_samples_in_screen < BUFFER_SIZE ? BUFFER_SIZE : nb_of_samples_in_screen);
-    for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-    {
-        if (unitOpened_m.channelSettings[ch].enabled)
-        {
-            values_V[ch] = (double*)malloc(nb_of_samples_in_screen * sizeof(double));
-            time[ch] = (double*)malloc(nb_of_samples_in_screen * sizeof(double));
-        }
-    }
-    DEBUG ( "timebase: %hd\tnb_of_samples:%d\toversample:%hd\ttime_units:%hd\ttime_interval:%lu\ttime_multiplier:%e\tnb_of_samples_in_screen:%d\n", 
-             timebase, no_of_samples, oversample, time_units, time_interval, time_multiplier, nb_of_samples_in_screen );
-
-    while ( sem_trywait(&thread_stop) )
-    {
-        /* Start it collecting,
-         *  then wait for completion
-         */
-        ps2000_run_block ( unitOpened_m.handle, BUFFER_SIZE, timebase, oversample, &time_indisposed_ms );
-
-        while ( !ps2000_ready ( unitOpened_m.handle ))
-        {
-            if( !sem_trywait(&thread_stop) )
-            {
-                /* re-post semaphore to exit the main loop */
-                sem_post(&thread_stop);
-                break;
-            }
-            Sleep ( 100 );
-        }
-
-
-        ps2000_stop ( unitOpened_m.handle );
-
-        /* Get the times (in units specified by time_units)
-         *  and the values (in ADC counts)
-         */
-        ps2000_get_times_and_values ( unitOpened_m.handle,
-                                  times,
-                                  unitOpened_m.channelSettings[PS2000_CHANNEL_A].values,
-                                  unitOpened_m.channelSettings[PS2000_CHANNEL_B].values,
-                                  unitOpened_m.channelSettings[PS2000_CHANNEL_C].values,
-                                  unitOpened_m.channelSettings[PS2000_CHANNEL_D].values,
-                                  &overflow, time_units, BUFFER_SIZE );
-        DEBUG ("Time\tValue\n");
-        DEBUG ("(ns)\t(%s)\n", adc_units (time_units));
-        DEBUG ( "%d values, overflow %d\n", no_of_samples, overflow );
-
-        for (ch = 0; (ch < unitOpened_m.noOfChannels) && (no_of_samples > 0); ch++)
-        {
-            if (unitOpened_m.channelSettings[ch].enabled)
-            {
-                for (  i = 0; (i < no_of_samples) && (index[ch] < nb_of_samples_in_screen) ; i++, index[ch]++ )
-                {
-                    values_V[ch][index[ch]] = 0.001 * adc_to_mv(unitOpened_m.channelSettings[ch].values[i], unitOpened_m.channelSettings[ch].range);
-                    time[ch][index[ch]] = (times[i] * time_multiplier) + time_offset[ch];
-                    //DEBUG("V: %lf (range %d) T: %lf\n", values_V[index[ch]], unitOpened_m.channelSettings[ch].range, time[index[ch]]);
-                }
-                // resetting all available data as long as the screen is not filled.
-                draw->setData(ch+1, time[ch], values_V[ch], index[ch]);
-                DEBUG("set %d data\n", index[ch]);
-                if( (index[ch] >= nb_of_samples_in_screen) || (time[ch][index[ch] - 1] > 5 * time_per_division_m) )
-                {
-                    time_offset[ch] = 0.;
-                    memset(time[ch], 0, nb_of_samples_in_screen * sizeof(double));
-                    memset(values_V[ch], 0, nb_of_samples_in_screen * sizeof(double));
-                    index[ch] = 0;
-                }
-                else
-                {
-                    time_offset[ch] = time[ch][index[ch] - 1];
-                }
-            }
-
-        }
-        Sleep(100);
-    }
-
-    for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-    {
-        if (unitOpened_m.channelSettings[ch].enabled)
-        {
-            free(values_V[ch]);
-            free(time[ch]);
-        }
-    }
-}
-
 void Acquisition2000::collect_block_advanced_triggered ()
 {
 int        i;
@@ -683,468 +434,6 @@ int        i;
 }
 
 
-/****************************************************************************
- * Collect_block_ets
- *  this function demonstrates how to collect a block of
- *  data using equivalent time sampling (ETS).
- ****************************************************************************/
-
-void Acquisition2000::collect_block_ets (void)
-{
-    int       i;
-    int       trigger_sample;
-    FILE      *fp;
-    short     auto_trigger_ms = 0;
-    long      time_indisposed_ms;
-    short     overflow;
-    long      ets_sampletime;
-    short     ok = 0;
-    short     ch;
-
-    DEBUG ( "Collect ETS block...\n" );
-    DEBUG ( "Collects when value rises past 1500mV\n" );
-    DEBUG ( "Press a key to start...\n" );
-    //getch ();
-
-    set_defaults ();
-
-    /* Trigger enabled
-    * Channel A - to trigger unsing this channel it needs to be enabled using ps2000_set_channel
-    * Rising edge
-    * Threshold = 1500mV
-    * 10% pre-trigger  (negative is pre-, positive is post-)
-    */
-    unitOpened_m.trigger.simple.channel = PS2000_CHANNEL_A;
-    unitOpened_m.trigger.simple.delay = -10.f;
-    unitOpened_m.trigger.simple.direction = PS2000_RISING;
-    unitOpened_m.trigger.simple.threshold = 1500.f;
-
-
-    ps2000_set_trigger ( unitOpened_m.handle,
-        (short) unitOpened_m.trigger.simple.channel,
-        mv_to_adc (1500, unitOpened_m.channelSettings[(short) unitOpened_m.trigger.simple.channel].range),
-        unitOpened_m.trigger.simple.direction ,
-        (short) unitOpened_m.trigger.simple.delay,
-        auto_trigger_ms );
-
-    /* Enable ETS in fast mode,
-    * the computer will store 60 cycles
-    *  but interleave only 4
-    */
-    ets_sampletime = ps2000_set_ets ( unitOpened_m.handle, PS2000_ETS_FAST, 60, 4 );
-    DEBUG ( "ETS Sample Time is: %ld\n", ets_sampletime );
-    /* Start it collecting,
-    *  then wait for completion
-    */
-    ok = ps2000_run_block ( unitOpened_m.handle, BUFFER_SIZE, timebase, 1, &time_indisposed_ms );
-    if ( !ok )
-        WARNING ( "ps2000_run_block return value is not 0." );
-
-    DEBUG ( "Waiting for trigger..." );
-    DEBUG ( "Press a key to abort\n" );
-
-    while ( (!ps2000_ready (unitOpened_m.handle)) /*&& (!kbhit ())*/ )
-    {
-        Sleep (100);
-    }
-
-//    if ( kbhit () )
-//    {
-//        //getch ();
-//        DEBUG ( "data collection aborted\n" );
-//    }
-//    else
-//    {
-        ps2000_stop ( unitOpened_m.handle );
-        /* Get the times (in microseconds)
-        *  and the values (in ADC counts)
-        */
-        ok = (short)ps2000_get_times_and_values ( unitOpened_m.handle,
-                                                  times,
-                                                  unitOpened_m.channelSettings[PS2000_CHANNEL_A].values,
-                                                  unitOpened_m.channelSettings[PS2000_CHANNEL_B].values,
-                                                  NULL,
-                                                  NULL,
-                                                  &overflow,
-                                                  PS2000_PS,
-                                                  BUFFER_SIZE);
-
-        /* Print out the first 10 readings,
-        *  converting the readings to mV if required
-        */
-
-        DEBUG ( "Ten readings around trigger\n" );
-        DEBUG ( "(ps)\t(mv)\n");
-
-        /* This calculation is correct for 10% pre-trigger
-        */
-        trigger_sample = BUFFER_SIZE / 10;
-
-        for ( i = trigger_sample - 5; i < trigger_sample + 5; i++ )
-        {
-            DEBUG ( "%ld\t", times [i]);
-            for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-            {
-                if (unitOpened_m.channelSettings[ch].enabled)
-                {
-                    DEBUG ( "%d\t\n", adc_to_mv (unitOpened_m.channelSettings[ch].values[i], unitOpened_m.channelSettings[ch].range));
-                }
-            }
-            DEBUG ("\n");
-        }
-
-        fp = fopen ( "data.txt","w" );
-        if (fp != NULL)
-        {
-            for ( i = 0; i < BUFFER_SIZE; i++ )
-            {
-                fprintf ( fp, "%ld,", times[i] );
-                for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-                {
-                    if (unitOpened_m.channelSettings[ch].enabled)
-                    {
-                        fprintf ( fp, "%ld, %d, %d", times[i],  unitOpened_m.channelSettings[ch].values[i], adc_to_mv (unitOpened_m.channelSettings[ch].values[i], unitOpened_m.channelSettings[ch].range) );
-                    }
-                }
-                fprintf (fp, "\n");
-            }
-            fclose( fp );
-        }
-        else
-            ERROR("Cannot open the file data.txt for writing. \nPlease ensure that you have permission to access. \n");
-//    }
-}
-
-/****************************************************************************
- *
- * Collect_streaming
- *  this function demonstrates how to use streaming.
- *
- * In this mode, you can collect data continuously.
- *
- * This example writes data to disk...
- * don't leave it running too long or it will fill your disk up!
- *
- * Each call to ps2000_get_times_and_values returns the readings since the
- * last call
- *
- * The time is in microseconds: it will wrap around at 2^32 (approx 2,000 seconds)
- * if you don't need the time, you can just call ps2000_get_values
- *
- ****************************************************************************/
-
-void Acquisition2000::collect_streaming (void)
-{
-    int    i = 0;
-    int count = 0;
-    int    no_of_values;
-    short  overflow;
-    int    ok;
-    short  ch;
-    double values_V[BUFFER_SIZE] = {0};
-    double time[BUFFER_SIZE] = {0};
-    DEBUG ( "Collect streaming...\n" );
-
-    set_defaults ();
-
-    /* You cannot use triggering for the start of the data...
-    */
-    ps2000_set_trigger ( unitOpened_m.handle, PS2000_NONE, 0, 0, 0, 0 );
-
-    /* Collect data at time_per_division_m / 100  intervals
-    * Max BUFFER_SIZE points on each call
-    *  (buffer must be big enough for max time between calls
-    *
-    *  Start it collecting,
-    *  then wait for trigger event
-    */
-    ok = ps2000_run_streaming ( unitOpened_m.handle, (time_per_division_m * 1000. / 100.), 1000, 0 );
-    DEBUG ( "OK: %d\n", ok );
-
-    
-    while ( sem_trywait(&thread_stop) )
-    {
-        no_of_values = ps2000_get_values ( unitOpened_m.handle,
-            unitOpened_m.channelSettings[PS2000_CHANNEL_A].values,
-            unitOpened_m.channelSettings[PS2000_CHANNEL_B].values,
-            unitOpened_m.channelSettings[PS2000_CHANNEL_C].values,
-            unitOpened_m.channelSettings[PS2000_CHANNEL_D].values,
-            &overflow,
-            BUFFER_SIZE );
-        DEBUG ( "%d values, overflow %d\n", no_of_values, overflow );
-
-        for (ch = 0; (ch < unitOpened_m.noOfChannels) && (no_of_values > 0); ch++)
-        {
-            if (unitOpened_m.channelSettings[ch].enabled)
-            {
-
-                for (  i = 0; i < no_of_values; i++, count++ )
-                {
-                    values_V[count] = 0.001 * adc_to_mv(unitOpened_m.channelSettings[ch].values[i], unitOpened_m.channelSettings[ch].range);
-                    // TODO time will be probably wrong here, need to guess how to convert time range to time step...
-                    //time[i] = ( i ? time[i-1] : 0) + unitOpened_m.channelSettings[ch].range
-                    time[count] = count * 0.01 * time_per_division_m;
-                    DEBUG("V: %lf (range %d) T: %lf\n", values_V[count], unitOpened_m.channelSettings[ch].range, time[count]);
-                    // 500 points are making a screen:
-                    if(count == 500)
-                    {
-                        count = 0;
-                        memset(time, 0, BUFFER_SIZE * sizeof(double));
-                        memset(values_V, 0, BUFFER_SIZE * sizeof(double));
-                    }
-                }
-                
-                draw->setData(ch+1, time, values_V, count);
-
-            }
-
-        }
-        Sleep(100);
-    }
-
-    ps2000_stop ( unitOpened_m.handle );
-
-}
-
-void Acquisition2000::collect_fast_streaming (void)
-{
-    unsigned long    i;
-    short  overflow;
-    int     ok;
-    short ch;
-    unsigned long nPreviousValues = 0;
-    short values_a[BUFFER_SIZE_STREAMING];
-    short values_b[BUFFER_SIZE_STREAMING];
-    short *values = NULL;
-    double values_mV[BUFFER_SIZE_STREAMING];
-    double time[BUFFER_SIZE_STREAMING];
-    unsigned long triggerAt;
-    short triggered;
-    unsigned long no_of_samples;
-    double startTime = 0;
-
-
-    DEBUG ( "Collect fast streaming...\n" );
-
-    set_defaults ();
-
-    /* You cannot use triggering for the start of the data...
-    */
-    ps2000_set_trigger ( unitOpened_m.handle, PS2000_NONE, 0, 0, 0, 0 );
-
-    unitOpened_m.trigger.advanced.autoStop = 0;
-    unitOpened_m.trigger.advanced.totalSamples = 0;
-    unitOpened_m.trigger.advanced.triggered = 0;
-
-    /* Collect data at 10us intervals
-    * 100000 points with an agregation of 100 : 1
-    *    Auto stop after the 100000 samples
-    *  Start it collecting,
-    */
-    ok = ps2000_run_streaming_ns ( unitOpened_m.handle, 10, PS2000_US, BUFFER_SIZE_STREAMING, 1, 100, 30000 );
-    DEBUG ( "OK: %d\n", ok );
-
-    /* From here on, we can get data whenever we want...
-    */
-
-    while (!unitOpened_m.trigger.advanced.autoStop && sem_trywait(&thread_stop))
-    {
-
-        ps2000_get_streaming_last_values (unitOpened_m.handle, &Acquisition2000::ps2000FastStreamingReady);
-        if (nPreviousValues != unitOpened_m.trigger.advanced.totalSamples)
-        {
-
-            DEBUG ("Values collected: %ld\n", unitOpened_m.trigger.advanced.totalSamples - nPreviousValues);
-            nPreviousValues =     unitOpened_m.trigger.advanced.totalSamples;
-
-        }
-        Sleep (0);
-
-    }
-
-    ps2000_stop (unitOpened_m.handle);
-
-    no_of_samples = ps2000_get_streaming_values_no_aggregation (unitOpened_m.handle,
-                                                                &startTime, // get samples from the beginning
-                                                                values_a, // set buffer for channel A
-                                                                values_b, // set buffer for channel B
-                                                                NULL,
-                                                                NULL,
-                                                                &overflow,
-                                                                &triggerAt,
-                                                                &triggered,
-                                                                BUFFER_SIZE_STREAMING);
-
-
-    // print out the first 20 readings
-    for ( i = 0; i < 20; i++ )
-    {
-        for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-        {
-            if (unitOpened_m.channelSettings[ch].enabled)
-            {
-                printf("%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-            }
-        }
-            printf("\n");
-    }
-
-    for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-    {
-        if (unitOpened_m.channelSettings[ch].enabled)
-        {
-            switch(ch)
-            {
-                case 0:
-                    values = values_a;
-                break;
-                case 1:
-                    values = values_b;
-                break;
-                default:
-                    return;
-                break;
-            }
-
-            for (  i = 0; i < no_of_samples; i++ )
-            {
-                values_mV[i] = adc_to_mv(values[i], unitOpened_m.channelSettings[ch].range);
-                // TODO time will be probably wrong here, need to guess how to convert time range to time step...
-                time[i] = ( i ? time[i-1] : 0) + unitOpened_m.channelSettings[ch].range;
-            }
-
-            draw->setData(ch+1, values_mV, time, no_of_samples);
-        }
-               
-    }
-
-
-/*    DEBUG ( "Data is written to disk file (data.txt)\n" );
-    fp = fopen ( "data.txt", "w+" );
-    if (fp != NULL)
-    {
-        for ( i = 0; i < no_of_samples; i++ )
-        {
-            for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-            {
-                if (unitOpened_m.channelSettings[ch].enabled)
-                {
-                    fprintf ( fp, "%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-                }
-            }
-            fprintf (fp, "\n");
-        }
-        fclose ( fp );
-    }
-    else
-        ERROR("Cannot open the file data.txt for writing. \nPlease ensure that you have permission to access. \n");
-*/
-
-    //getch ();
-}
-
-void Acquisition2000::collect_fast_streaming_triggered (void)
-{
-    unsigned long    i;
-    FILE     *fp;
-    short  overflow;
-    int     ok;
-    short ch;
-    unsigned long nPreviousValues = 0;
-    short values_a[BUFFER_SIZE_STREAMING];
-    short values_b[BUFFER_SIZE_STREAMING];
-    unsigned long    triggerAt;
-    short triggered;
-    unsigned long no_of_samples;
-    double startTime = 0;
-
-
-
-    DEBUG ( "Collect fast streaming triggered...\n" );
-    DEBUG ( "Data is written to disk file (data.txt)\n" );
-    DEBUG ( "Press a key to start\n" );
-    //getch ();
-
-    set_defaults ();
-
-    set_trigger_advanced ();
-
-    unitOpened_m.trigger.advanced.autoStop = 0;
-    unitOpened_m.trigger.advanced.totalSamples = 0;
-    unitOpened_m.trigger.advanced.triggered = 0;
-
-    /* Collect data at 10us intervals
-    * 100000 points with an agregation of 100 : 1
-    *    Auto stop after the 100000 samples
-    *  Start it collecting,
-    */
-    ok = ps2000_run_streaming_ns ( unitOpened_m.handle, 10, PS2000_US, BUFFER_SIZE_STREAMING, 1, 100, 30000 );
-    DEBUG ( "OK: %d\n", ok );
-
-    /* From here on, we can get data whenever we want...
-    */
-
-    while (!unitOpened_m.trigger.advanced.autoStop)
-    {
-        ps2000_get_streaming_last_values (unitOpened_m.handle, ps2000FastStreamingReady);
-        if (nPreviousValues != unitOpened_m.trigger.advanced.totalSamples)
-        {
-            DEBUG ("Values collected: %ld\n", unitOpened_m.trigger.advanced.totalSamples - nPreviousValues);
-            nPreviousValues =     unitOpened_m.trigger.advanced.totalSamples;
-        }
-        Sleep (0);
-    }
-
-    ps2000_stop (unitOpened_m.handle);
-
-    no_of_samples = ps2000_get_streaming_values_no_aggregation (unitOpened_m.handle,
-                                                                &startTime, // get samples from the beginning
-                                                                values_a, // set buffer for channel A
-                                                                values_b,    // set buffer for channel B
-                                                                NULL,
-                                                                NULL,
-                                                                &overflow,
-                                                                &triggerAt,
-                                                                &triggered,
-                                                                BUFFER_SIZE_STREAMING);
-
-
-    // if the unit triggered print out ten samples either side of the trigger point
-    // otherwise print the first 20 readings
-    for ( i = (triggered ? triggerAt - 10 : 0) ; i < ((triggered ? triggerAt - 10 : 0) + 20); i++)
-    {
-        for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-        {
-            if (unitOpened_m.channelSettings[ch].enabled)
-            {
-                DEBUG ("%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-            }
-        }
-        DEBUG ("\n");
-    }
-
-    fp = fopen ( "data.txt", "w" );
-    if (fp != NULL)
-    {
-        for ( i = 0; i < no_of_samples; i++ )
-        {
-            for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-            {
-                if (unitOpened_m.channelSettings[ch].enabled)
-                {
-                    fprintf ( fp, "%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-                }
-            }
-            fprintf (fp, "\n");
-        }
-        fclose ( fp );
-    }
-    else
-        DEBUG("Cannot open the file data.txt for writing. \nPlease ensure that you have permission to access. \n");
-    //getch ();
-}
-
-
 /****************************************************************************
  *
  *
@@ -1172,6 +461,10 @@ void Acquisition2000::get_info (void)
             {
               variant = atoi(line);
             }
+            else if (i == 4)
+            {
+              snprintf(device_serial_m, DEVICE_NAME_MAX, "%s", line);
+            }
       DEBUG ( "%s: %s\n", description[i], line );
     }
 
@@ -1475,7 +768,7 @@ void Acquisition2000::set_voltages (channel_e channel_index, double volts_per_di
         return;
     }
 
-    if((5. * volts_per_division) > ((double)input_ranges[unitOpened_m.lastRange] / 1000.)){
+    if((5. * volts_per_division) > ((double)Traits::input_ranges[unitOpened_m.lastRange] / 1000.)){
         ERROR ( "%s : invalid voltage index!\n", __FUNCTION__ );
         return;
     }
@@ -1483,8 +776,8 @@ void Acquisition2000::set_voltages (channel_e channel_index, double volts_per_di
     /* find the first range that includes the voltage caliber */
     for ( i = unitOpened_m.firstRange; i <= unitOpened_m.lastRange; i++ )
     {
-        DEBUG ( "trying range %d -> %d mV\n", i, input_ranges[i] );
-        if(((double)input_ranges[i] / 1000.) >= (5. * volts_per_division))
+        DEBUG ( "trying range %d -> %d mV\n", i, Traits::input_ranges[i] );
+        if(((double)Traits::input_ranges[i] / 1000.) >= (5. * volts_per_division))
         {
             unitOpened_m.channelSettings[channel_index].range = i;
             break;
@@ -1493,7 +786,7 @@ void Acquisition2000::set_voltages (channel_e channel_index, double volts_per_di
 
     if(unitOpened_m.channelSettings[channel_index].range != CHANNEL_OFF)
     {
-        DEBUG ( "Channel %c has now range %d mV\n", 'A' + channel_index, input_ranges[unitOpened_m.channelSettings[channel_index].range]);
+        DEBUG ( "Channel %c has now range %d mV\n", 'A' + channel_index, Traits::input_ranges[unitOpened_m.channelSettings[channel_index].range]);
         unitOpened_m.channelSettings[channel_index].enabled = TRUE;
     }
     else
@@ -1503,27 +796,5 @@ void Acquisition2000::set_voltages (channel_e channel_index, double volts_per_di
     }
 
 }
-/****************************************************************************
- * adc_to_mv
- *
- * If the user selects scaling to millivolts,
- * Convert an 12-bit ADC count into millivolts
- ****************************************************************************/
-int Acquisition2000::adc_to_mv (long raw, int ch)
-{
-      return ( scale_to_mv ) ? ( raw * input_ranges[ch] ) / 32767 : raw;
-}
-
-/****************************************************************************
- * mv_to_adc
- *
- * Convert a millivolt value into a 12-bit ADC count
- *
- *  (useful for setting trigger thresholds)
- ****************************************************************************/
-short Acquisition2000::mv_to_adc (short mv, short ch)
-{
-  return ( ( mv * 32767 ) / input_ranges[ch] );
-}
 
 #endif // HAVE_LIBPS2000
@@ -38,6 +38,7 @@
 #include "oscilloscope.h"
 #include "drawdata.h"
 #include "acquisition.h"
+#include "acquisitionpipeline.h"
 
 #ifdef WIN32
 /* Headers for Windows */
@@ -59,14 +60,114 @@
 #include <stdint.h>
 
 /* Definition of PS2000 driver routines on Linux */
-//#define DYNLINK
+/* DYNLINK (configure --enable-dynlink) makes the routines pointer types */
 #include <libps2000/ps2000.h>
 #define __stdcall
+
+#ifdef DYNLINK
+/* driver routines resolved at run time into a table, calls are unchanged */
+#define PS2000_LIBRARIES  { "libps2000.so", "libps2000.so.3", "libps2000.so.2", NULL }
+typedef struct
+{
+    ps2000SetAdvTriggerChannelConditions SetAdvTriggerChannelConditions;
+    ps2000SetAdvTriggerChannelDirections SetAdvTriggerChannelDirections;
+    ps2000SetAdvTriggerChannelProperties SetAdvTriggerChannelProperties;
+    ps2000SetAdvTriggerDelay SetAdvTriggerDelay;
+    ps2000SetPulseWidthQualifier SetPulseWidthQualifier;
+    ps2000_close_unit close_unit;
+    ps2000_get_streaming_last_values get_streaming_last_values;
+    ps2000_get_streaming_values_no_aggregation get_streaming_values_no_aggregation;
+    ps2000_get_timebase get_timebase;
+    ps2000_get_times_and_values get_times_and_values;
+    ps2000_get_unit_info get_unit_info;
+    ps2000_get_values get_values;
+    ps2000_open_unit open_unit;
+    ps2000_ready ready;
+    ps2000_run_block run_block;
+    ps2000_run_streaming run_streaming;
+    ps2000_run_streaming_ns run_streaming_ns;
+    ps2000_set_channel set_channel;
+    ps2000_set_ets set_ets;
+    ps2000_set_sig_gen_arbitrary set_sig_gen_arbitrary;
+    ps2000_set_sig_gen_built_in set_sig_gen_built_in;
+    ps2000_set_trigger set_trigger;
+    ps2000_stop stop;
+}ps2000_api_t;
+extern ps2000_api_t ps2000_api;
+#define ps2000SetAdvTriggerChannelConditions       ps2000_api.SetAdvTriggerChannelConditions
+#define ps2000SetAdvTriggerChannelDirections       ps2000_api.SetAdvTriggerChannelDirections
+#define ps2000SetAdvTriggerChannelProperties       ps2000_api.SetAdvTriggerChannelProperties
+#define ps2000SetAdvTriggerDelay                   ps2000_api.SetAdvTriggerDelay
+#define ps2000SetPulseWidthQualifier               ps2000_api.SetPulseWidthQualifier
+#define ps2000_close_unit                          ps2000_api.close_unit
+#define ps2000_get_streaming_last_values           ps2000_api.get_streaming_last_values
+#define ps2000_get_streaming_values_no_aggregation ps2000_api.get_streaming_values_no_aggregation
+#define ps2000_get_timebase                        ps2000_api.get_timebase
+#define ps2000_get_times_and_values                ps2000_api.get_times_and_values
+#define ps2000_get_unit_info                       ps2000_api.get_unit_info
+#define ps2000_get_values                          ps2000_api.get_values
+#define ps2000_open_unit                           ps2000_api.open_unit
+#define ps2000_ready                               ps2000_api.ready
+#define ps2000_run_block                           ps2000_api.run_block
+#define ps2000_run_streaming                       ps2000_api.run_streaming
+#define ps2000_run_streaming_ns                    ps2000_api.run_streaming_ns
+#define ps2000_set_channel                         ps2000_api.set_channel
+#define ps2000_set_ets                             ps2000_api.set_ets
+#define ps2000_set_sig_gen_arbitrary               ps2000_api.set_sig_gen_arbitrary
+#define ps2000_set_sig_gen_built_in                ps2000_api.set_sig_gen_built_in
+#define ps2000_set_trigger                         ps2000_api.set_trigger
+#define ps2000_stop                                ps2000_api.stop
+#endif
 /* End of Linux-specific definitions */
 #endif
 
 
-class Acquisition2000 : public Acquisition{
+/**
+ * @brief libps2000 calls and constants used by the acquisition pipeline
+ */
+struct Ps2000Traits
+{
+    enum { MAX_VALUE = 32767 };
+    /* fast streaming runs up to 1 MS/s */
+    enum { FAST_STREAMING_MIN_INTERVAL_NS = 1000 };
+    static const short NONE = PS2000_NONE;
+    static const short RISING = PS2000_RISING;
+    static const short FALLING = PS2000_FALLING;
+    static const PS2000_CHANNEL CHANNEL_A = PS2000_CHANNEL_A;
+    static const short input_ranges [PS2000_MAX_RANGES] /*= {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000}*/;
+
+    static short set_trigger (short handle, short source, short threshold, short direction, short delay, short auto_trigger_ms)
+    { return ps2000_set_trigger ( handle, source, threshold, direction, delay, auto_trigger_ms ); }
+    static short get_timebase (short handle, short timebase, long no_of_samples, long *time_interval, short *time_units, short oversample, long *max_samples)
+    { return ps2000_get_timebase ( handle, timebase, no_of_samples, time_interval, time_units, oversample, max_samples ); }
+    static short run_block (short handle, long no_of_values, short timebase, short oversample, long *time_indisposed_ms)
+    { return ps2000_run_block ( handle, no_of_values, timebase, oversample, time_indisposed_ms ); }
+    static short ready (short handle)
+    { return ps2000_ready ( handle ); }
+    static short stop (short handle)
+    { return ps2000_stop ( handle ); }
+    static short run_streaming (short handle, short sample_interval_ms, long max_samples, short windowed)
+    { return ps2000_run_streaming ( handle, sample_interval_ms, max_samples, windowed ); }
+    static long get_values (short handle, short *a, short *b, short *c, short *d, short *overflow, long no_of_values)
+    { return ps2000_get_values ( handle, a, b, c, d, overflow, no_of_values ); }
+    static long set_ets (short handle, bool enabled, short cycles, short interleave)
+    { return ps2000_set_ets ( handle, enabled ? PS2000_ETS_FAST : PS2000_ETS_OFF, cycles, interleave ); }
+    static long get_times_and_values_ps (short handle, long *times, short *a, short *b, short *c, short *d, short *overflow, long no_of_values)
+    { return ps2000_get_times_and_values ( handle, times, a, b, c, d, overflow, PS2000_PS, no_of_values ); }
+    /* fast streaming: the driver keeps the overview buffers, no application buffers */
+    static short run_streaming_ns (short handle, unsigned long sample_interval_ns, unsigned long max_samples, short **buffers, unsigned long buffer_size)
+    { (void)buffers; (void)buffer_size; return ps2000_run_streaming_ns ( handle, sample_interval_ns, PS2000_NS, max_samples, 0, 1, 30000 ); }
+    template <class SINK>
+    static short get_streaming_last_values (short handle, short **buffers)
+    { (void)buffers; return ps2000_get_streaming_last_values ( handle, &streaming_ready<SINK> ); }
+    template <class SINK>
+    static void __stdcall streaming_ready (short **overview_buffers, short overflow, unsigned long triggered_at, short triggered, short auto_stop, unsigned long nb_values)
+    { (void)overflow; (void)triggered_at; (void)triggered; (void)auto_stop; SINK::streaming_ready ( overview_buffers, nb_values ); }
+};
+
+class Acquisition2000 : public AcquisitionPipeline<Acquisition2000, Ps2000Traits>{
+    friend class StreamingPipeline<Acquisition2000, Ps2000Traits>;
+    friend class AcquisitionPipeline<Acquisition2000, Ps2000Traits>;
 public:
     /**
      * @brief public typedef declarations
@@ -202,34 +303,18 @@ private:
      * @brief private methods declarations
      */
     Acquisition2000();
-    int adc_to_mv (long raw, int ch);    
-    short mv_to_adc (short mv, short ch);
     void get_info (void);
     void set_defaults (void);
     void set_trigger_advanced(void);
-    void collect_block_immediate (void);
-    void collect_block_triggered (trigger_e trigger_slope, double trigger_level);
     void collect_block_advanced_triggered ();
-    void collect_block_ets (void);
-    void collect_streaming (void);
-    void collect_fast_streaming (void);
-    void collect_fast_streaming_triggered (void);
-    static void  __stdcall ps2000FastStreamingReady( short **overviewBuffers,
-                                                     short overflow,
-                                                     unsigned long triggeredAt,
-                                                     short triggered,
-                                                     short auto_stop,
-                                                     unsigned long nValues);
     /**
      * @brief private instances declarations
      */
     UNIT_MODEL unitOpened_m;
     static Acquisition2000 *singleton_m;
-    int scale_to_mv;
     short timebase;
     double time_per_division_m;
     long times[BUFFER_SIZE];
-    static const short input_ranges [PS2000_MAX_RANGES] /*= {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000}*/;
 };
 
 #endif // HAVE_LIBPS2000
@@ -27,6 +27,7 @@
  */
 
 #include "acquisition2000a.h"
+#include "driverlibrary.h"
 
 #ifdef HAVE_LIBPS2000A
 
@@ -41,6 +42,61 @@ enum BOOL {FALSE,TRUE};
 Acquisition2000a *Acquisition2000a::singleton_m = NULL;
 const short Acquisition2000a::input_ranges [] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000};
 
+#ifdef DYNLINK
+/* driver routines, resolved by load_driver() */
+ps2000a_api_t ps2000a_api;
+static DriverLibrary ps2000a_library;
+
+/****************************************************************************
+ *
+ * load_driver - open libps2000a and resolve its routines, once
+ *
+ ****************************************************************************/
+static int8_t load_driver (void)
+{
+    static const char *const names[] = PS2000A_LIBRARIES;
+
+    if( ps2000a_library.loaded() )
+    {
+        return 0;
+    }
+    if( (0 != ps2000a_library.open(names)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aOpenUnit)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aCloseUnit)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aGetNoOfCaptures)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aGetStreamingLatestValues)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aGetTimebase)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aGetUnitInfo)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aGetValues)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aGetValuesBulk)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aMaximumValue)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aMemorySegments)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aRunBlock)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aRunStreaming)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetChannel)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetDataBuffer)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetDataBuffers)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetDigitalPort)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetEts)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetNoOfCaptures)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetPulseWidthQualifier)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetSigGenArbitrary)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetSigGenBuiltIn)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetSimpleTrigger)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetTriggerChannelConditions)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetTriggerChannelDirections)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetTriggerChannelProperties)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetTriggerDelay)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aSetTriggerDigitalPortProperties)) ||
+        (0 != DRIVER_RESOLVE(ps2000a_library, ps2000aStop)) )
+    {
+        ps2000a_library.close();
+        return -1;
+    }
+    return 0;
+}
+#endif
+
 /****************************************************************************
  *
  * constructor
@@ -53,7 +109,18 @@ Acquisition2000a::Acquisition2000a() :
 	int i;
 	PWQ pulseWidth;
 	TRIGGER_DIRECTIONS directions;
-	PICO_STATUS status = ps2000aOpenUnit(&unitOpened_m.handle, NULL);
+	PICO_STATUS status;
+
+#ifdef DYNLINK
+    if( 0 != load_driver() )
+    {
+        DEBUG ( "libps2000a is not installed\n" );
+        unitOpened_m.handle = 0;
+        unitOpened_m.model = MODEL_NONE;
+        return;
+    }
+#endif
+	status = ps2000aOpenUnit(&unitOpened_m.handle, NULL);
 	DEBUG ( "Handle: %d\n", unitOpened_m.handle );
 	if (status != PICO_OK) 
 	{
@@ -113,8 +180,12 @@ Acquisition2000a* Acquisition2000a::get_instance()
 Acquisition2000a::~Acquisition2000a()
 {
     DEBUG ( "Device destroyed\n" );
-    ps2000aCloseUnit( unitOpened_m.handle );
+    if ( unitOpened_m.handle >= 1 )
+        ps2000aCloseUnit( unitOpened_m.handle );
     Acquisition2000a::singleton_m = NULL;
+#ifdef DYNLINK
+    ps2000a_library.close();
+#endif
 }
 
 /****************************************************************************
@@ -1603,30 +1674,6 @@ void DigitalMenu(UNIT *unit)
 }
 
 
-/****************************************************************************
- *
- * ps2000FastStreamingReady
- *
- ****************************************************************************/
-void  __stdcall Acquisition2000a::ps2000FastStreamingReady( short **overviewBuffers,
-                                                              short overflow,
-                                                                unsigned long triggeredAt,
-                                                                short triggered,
-                                                                short auto_stop,
-                                                              unsigned long nValues)
-{
-    (void)overviewBuffers;
-    (void)overflow;
-    (void)triggeredAt;
-    (void)triggered;
-    Acquisition2000a* instance = Acquisition2000a::get_instance();
-    if(NULL != instance)
-    {
-        instance->unitOpened_m.trigger.advanced.totalSamples += nValues;
-        instance->unitOpened_m.trigger.advanced.autoStop = auto_stop;
-    }
-}
-
 /****************************************************************************
  *
  * get_device_info
@@ -1641,6 +1688,7 @@ void Acquisition2000a::get_device_info(device_info_t* info)
     }
 
     memset(info, 0, sizeof(device_info_t));
+    snprintf(info->serial, DEVICE_NAME_MAX, "%s", device_serial_m);
 
     switch(unitOpened_m.model)
     {
@@ -1806,10 +1854,133 @@ void Acquisition2000a::collect_block_immediate (void)
      */
     set_trigger ( NULL, 0, NULL, 0, &directions, &pulseWidth, 0, 0, 0, 0, 0 );
 
+    if ( unitOpened_m.noOfDigitalPorts > 0 )
+    {
+        /* MSO models: logic lines come with the analog channels */
+        collect_block_mixed();
+        return;
+    }
     /* TODO */
     BlockDataHandler(&unitOpened_m, "First 10 readings\n", 0, ANALOGUE);
 }
 
+/****************************************************************************
+ * Collect_block_mixed
+ *  collect blocks of analog and digital data from MSO models till the
+ *  acquisition stops, digital ports are packed into bit per line storage
+ *  before drawing
+ ****************************************************************************/
+void Acquisition2000a::collect_block_mixed (void)
+{
+    long sample_count = BUFFER_SIZE;
+    long time_interval = 0;
+    long max_samples = 0;
+    long time_indisposed_ms = 0;
+    unsigned long no_of_values = BUFFER_SIZE;
+    short oversample = 1;
+    short overflow = 0;
+    short logic_level = (short)((1.5 / 5) * PS2000A_MAX_LOGIC_LEVEL);
+    short * digital_buffers[PS2000A_MAX_DIGITAL_PORTS] = {NULL};
+    short ch = 0;
+    short port = 0;
+    double dt = 0.;
+    const short * raw[MAX_CHANNELS] = {NULL};
+    double scale[MAX_CHANNELS] = {0.};
+    sample_frame_t frame;
+    PICO_STATUS status;
+
+    /* driver buffers are set once per run, each capture fills them again */
+    for ( ch = 0; ch < unitOpened_m.noOfChannels; ch++ )
+    {
+        ps2000aSetDataBuffer( unitOpened_m.handle, (PS2000A_CHANNEL)ch, unitOpened_m.channelSettings[ch].values, sample_count, 0, PS2000A_RATIO_MODE_NONE );
+    }
+    for ( port = 0; port < unitOpened_m.noOfDigitalPorts; port++ )
+    {
+        ps2000aSetDigitalPort( unitOpened_m.handle, (PS2000A_DIGITAL_PORT)(PS2000A_DIGITAL_PORT0 + port), 1, logic_level );
+        digital_buffers[port] = (short*)malloc( sample_count * sizeof(short) );
+        if ( NULL == digital_buffers[port] )
+        {
+            ERROR( "unable to allocate digital port %d buffer\n", port );
+            goto cleanup;
+        }
+        ps2000aSetDataBuffer( unitOpened_m.handle, (PS2000A_CHANNEL)(PS2000A_DIGITAL_PORT0 + port), digital_buffers[port], sample_count, 0, PS2000A_RATIO_MODE_NONE );
+    }
+
+    while ( ps2000aGetTimebase( unitOpened_m.handle, timebase, sample_count, &time_interval, oversample, &max_samples, 0 ) )
+    {
+        timebase++;
+    }
+    /* sample interval is given in ns */
+    dt = time_interval * 1e-9;
+
+    frame.triggered = 0;
+    frame.trigger_time = 0.;
+    frame.channels = 0;
+    frame.digital = &digital_m;
+    for ( ch = 0; (ch < unitOpened_m.noOfChannels) && (ch < MAX_CHANNELS); ch++ )
+    {
+        if ( unitOpened_m.channelSettings[ch].enabled )
+        {
+            raw[ch] = unitOpened_m.channelSettings[ch].values;
+            scale[ch] = 0.001 * input_ranges[unitOpened_m.channelSettings[ch].range] / unitOpened_m.maxValue;
+            frame.channels |= (1 << ch);
+            frame.blocks[ch].raw = raw[ch];
+            frame.blocks[ch].scale = scale[ch];
+            frame.blocks[ch].t0 = 0.;
+            frame.blocks[ch].dt = dt;
+            frame.blocks[ch].stable = 0;
+            frame.blocks[ch].times = NULL;
+        }
+    }
+    reserve_processing( sample_count );
+
+    while ( sem_trywait(&thread_stop) )
+    {
+        g_ready = FALSE;
+        if ( (status = ps2000aRunBlock( unitOpened_m.handle, 0, sample_count, timebase, oversample, &time_indisposed_ms, 0, CallBackBlock, NULL )) != PICO_OK )
+        {
+            DEBUG( "collect_block_mixed:ps2000aRunBlock ------ 0x%08lx \n", status );
+            break;
+        }
+        while ( !g_ready )
+        {
+            if( !sem_trywait(&thread_stop) )
+            {
+                /* re-post semaphore to exit the main loop */
+                sem_post(&thread_stop);
+                break;
+            }
+            Sleep( BLOCK_READY_POLL_MS );
+        }
+        no_of_values = sample_count;
+        if ( g_ready &&
+             (ps2000aGetValues( unitOpened_m.handle, 0, &no_of_values, 1, PS2000A_RATIO_MODE_NONE, 0, &overflow ) == PICO_OK) &&
+             (0 == digital_m.pack_ports( digital_buffers[0], (unitOpened_m.noOfDigitalPorts > 1) ? digital_buffers[1] : NULL, no_of_values, 0., dt )) )
+        {
+            for ( ch = 0; ch < MAX_CHANNELS; ch++ )
+            {
+                frame.blocks[ch].count = no_of_values;
+            }
+            /* a block is a whole screen: bus decoding restarts with each capture */
+            decode_start( 0., true );
+            decode_digital( &digital_m );
+            decode_samples( raw, scale, no_of_values, dt );
+            draw_frame( &frame );
+            history_store( &frame, 1 == mask_test( &frame, 0, no_of_values ) );
+            analyze( &frame, 0, no_of_values );
+        }
+        ps2000aStop( unitOpened_m.handle );
+    }
+
+cleanup:
+    ClearDataBuffers( &unitOpened_m );
+    for ( port = 0; port < unitOpened_m.noOfDigitalPorts; port++ )
+    {
+        if ( NULL != digital_buffers[port] )
+            free( digital_buffers[port] );
+    }
+}
+
 /****************************************************************************
  * Collect_block_triggered
  *  this function demonstrates how to collect a single block of data from the
@@ -1949,18 +2120,34 @@ void Acquisition2000a::collect_block_ets (void)
 
 void Acquisition2000a::collect_streaming (void)
 {
-    int    i = 0;
-    int count = 0;
     int    no_of_values;
     short  overflow;
     int    ok;
     short  ch;
-    double values_V[BUFFER_SIZE] = {0};
-    double time[BUFFER_SIZE] = {0};
+    uint8_t channels = 0;
+    /* 100 points per division, the driver takes whole milliseconds:
+     * faster timebases roll at 1 ms per sample */
+    short  interval_ms = (short)(time_per_division_m * 1000. / 100.);
     DEBUG ( "Collect streaming...\n" );
 
+    if ( interval_ms < 1 )
+        interval_ms = 1;
+    if ( 0 != reserve_streaming_buffers ( ROLL_SAMPLES_IN_SCREEN ) )
+        return;
+
     set_defaults ();
 
+    for (ch = 0; ch < unitOpened_m.noOfChannels && ch < MAX_CHANNELS; ch++)
+    {
+        if (unitOpened_m.channelSettings[ch].enabled)
+        {
+            channels |= (1 << ch);
+            live_scale_m[ch] = 0.001 * adc_to_mv(SHRT_MAX, unitOpened_m.channelSettings[ch].range) / SHRT_MAX;
+        }
+    }
+    if ( 0 != roll_setup ( channels, interval_ms * 1e-3 ) )
+        return;
+
     /* You cannot use triggering for the start of the data...
     */
     ps2000_set_trigger ( unitOpened_m.handle, PS2000A_NONE, 0, 0, 0, 0 );
@@ -1972,8 +2159,13 @@ void Acquisition2000a::collect_streaming (void)
     *  Start it collecting,
     *  then wait for trigger event
     */
-    ok = ps2000_run_streaming ( unitOpened_m.handle, (time_per_division_m * 1000. / 100.), 1000, 0 );
+    ok = ps2000_run_streaming ( unitOpened_m.handle, interval_ms, 1000, 0 );
     DEBUG ( "OK: %d\n", ok );
+    if ( 0 == ok )
+    {
+        ERROR ( "cannot stream at %hd ms per sample\n", interval_ms );
+        return;
+    }
 
     
     while ( sem_trywait(&thread_stop) )
@@ -1985,33 +2177,15 @@ void Acquisition2000a::collect_streaming (void)
             unitOpened_m.channelSettings[PS2000A_CHANNEL_D].values,
             &overflow,
             BUFFER_SIZE );
-        DEBUG ( "%d values, overflow %d\n", no_of_values, overflow );
 
-        for (ch = 0; (ch < unitOpened_m.noOfChannels) && (no_of_values > 0); ch++)
+        if ( no_of_values > 0 )
         {
-            if (unitOpened_m.channelSettings[ch].enabled)
+            /* roll: new samples are appended, the screen scrolls to the left */
+            for (ch = 0; ch < unitOpened_m.noOfChannels && ch < MAX_CHANNELS; ch++)
             {
-
-                for (  i = 0; i < no_of_values; i++, count++ )
-                {
-                    values_V[count] = 0.001 * adc_to_mv(unitOpened_m.channelSettings[ch].values[i], unitOpened_m.channelSettings[ch].range);
-                    // TODO time will be probably wrong here, need to guess how to convert time range to time step...
-                    //time[i] = ( i ? time[i-1] : 0) + unitOpened_m.channelSettings[ch].range
-                    time[count] = count * 0.01 * time_per_division_m;
-                    DEBUG("V: %lf (range %d) T: %lf\n", values_V[count], unitOpened_m.channelSettings[ch].range, time[count]);
-                    // 500 points are making a screen:
-                    if(count == 500)
-                    {
-                        count = 0;
-                        memset(time, 0, BUFFER_SIZE * sizeof(double));
-                        memset(values_V, 0, BUFFER_SIZE * sizeof(double));
-                    }
-                }
-                
-                draw->setData(ch+1, time, values_V, count);
-
+                roll_append ( ch, unitOpened_m.channelSettings[ch].values, no_of_values );
             }
-
+            roll_draw ();
         }
         Sleep(100);
     }
@@ -2020,245 +2194,6 @@ void Acquisition2000a::collect_streaming (void)
 
 }
 
-void Acquisition2000a::collect_fast_streaming (void)
-{
-    unsigned long    i;
-    short  overflow;
-    int     ok;
-    short ch;
-    unsigned long nPreviousValues = 0;
-    short values_a[BUFFER_SIZE_STREAMING];
-    short values_b[BUFFER_SIZE_STREAMING];
-    short *values = NULL;
-    double values_mV[BUFFER_SIZE_STREAMING];
-    double time[BUFFER_SIZE_STREAMING];
-    unsigned long triggerAt;
-    short triggered;
-    unsigned long no_of_samples;
-    double startTime = 0;
-
-
-    DEBUG ( "Collect fast streaming...\n" );
-
-    set_defaults ();
-
-    /* You cannot use triggering for the start of the data...
-    */
-    ps2000_set_trigger ( unitOpened_m.handle, PS2000A_NONE, 0, 0, 0, 0 );
-
-    unitOpened_m.trigger.advanced.autoStop = 0;
-    unitOpened_m.trigger.advanced.totalSamples = 0;
-    unitOpened_m.trigger.advanced.triggered = 0;
-
-    /* Collect data at 10us intervals
-    * 100000 points with an agregation of 100 : 1
-    *    Auto stop after the 100000 samples
-    *  Start it collecting,
-    */
-    ok = ps2000_run_streaming_ns ( unitOpened_m.handle, 10, PS2000A_US, BUFFER_SIZE_STREAMING, 1, 100, 30000 );
-    DEBUG ( "OK: %d\n", ok );
-
-    /* From here on, we can get data whenever we want...
-    */
-
-    while (!unitOpened_m.trigger.advanced.autoStop && sem_trywait(&thread_stop))
-    {
-
-        ps2000_get_streaming_last_values (unitOpened_m.handle, &Acquisition2000a::ps2000FastStreamingReady);
-        if (nPreviousValues != unitOpened_m.trigger.advanced.totalSamples)
-        {
-
-            DEBUG ("Values collected: %ld\n", unitOpened_m.trigger.advanced.totalSamples - nPreviousValues);
-            nPreviousValues =     unitOpened_m.trigger.advanced.totalSamples;
-
-        }
-        Sleep (0);
-
-    }
-
-    ps2000aStop(unitOpened_m.handle);
-
-    no_of_samples = ps2000_get_streaming_values_no_aggregation (unitOpened_m.handle,
-                                                                &startTime, // get samples from the beginning
-                                                                values_a, // set buffer for channel A
-                                                                values_b, // set buffer for channel B
-                                                                NULL,
-                                                                NULL,
-                                                                &overflow,
-                                                                &triggerAt,
-                                                                &triggered,
-                                                                BUFFER_SIZE_STREAMING);
-
-
-    // print out the first 20 readings
-    for ( i = 0; i < 20; i++ )
-    {
-        for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-        {
-            if (unitOpened_m.channelSettings[ch].enabled)
-            {
-                DEBUG("%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-            }
-        }
-            DEBUG("\n");
-    }
-
-    for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-    {
-        if (unitOpened_m.channelSettings[ch].enabled)
-        {
-            switch(ch)
-            {
-                case 0:
-                    values = values_a;
-                break;
-                case 1:
-                    values = values_b;
-                break;
-                default:
-                    return;
-                break;
-            }
-
-            for (  i = 0; i < no_of_samples; i++ )
-            {
-                values_mV[i] = adc_to_mv(values[i], unitOpened_m.channelSettings[ch].range);
-                // TODO time will be probably wrong here, need to guess how to convert time range to time step...
-                time[i] = ( i ? time[i-1] : 0) + unitOpened_m.channelSettings[ch].range;
-            }
-
-            draw->setData(ch+1, values_mV, time, no_of_samples);
-        }
-               
-    }
-
-
-/*    DEBUG ( "Data is written to disk file (data.txt)\n" );
-    fp = fopen ( "data.txt", "w+" );
-    if (fp != NULL)
-    {
-        for ( i = 0; i < no_of_samples; i++ )
-        {
-            for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-            {
-                if (unitOpened_m.channelSettings[ch].enabled)
-                {
-                    fDEBUG ( fp, "%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-                }
-            }
-            fDEBUG (fp, "\n");
-        }
-        fclose ( fp );
-    }
-    else
-        ERROR("Cannot open the file data.txt for writing. \nPlease ensure that you have permission to access. \n");
-*/
-
-    //getch ();
-}
-
-void Acquisition2000a::collect_fast_streaming_triggered (void)
-{
-    unsigned long    i;
-    FILE     *fp;
-    short  overflow;
-    int     ok;
-    short ch;
-    unsigned long nPreviousValues = 0;
-    short values_a[BUFFER_SIZE_STREAMING];
-    short values_b[BUFFER_SIZE_STREAMING];
-    unsigned long    triggerAt;
-    short triggered;
-    unsigned long no_of_samples;
-    double startTime = 0;
-
-
-
-    DEBUG ( "Collect fast streaming triggered...\n" );
-    DEBUG ( "Data is written to disk file (data.txt)\n" );
-    DEBUG ( "Press a key to start\n" );
-    //getch ();
-
-    set_defaults ();
-
-    set_trigger_advanced ();
-
-    unitOpened_m.trigger.advanced.autoStop = 0;
-    unitOpened_m.trigger.advanced.totalSamples = 0;
-    unitOpened_m.trigger.advanced.triggered = 0;
-
-    /* Collect data at 10us intervals
-    * 100000 points with an agregation of 100 : 1
-    *    Auto stop after the 100000 samples
-    *  Start it collecting,
-    */
-    ok = ps2000_run_streaming_ns ( unitOpened_m.handle, 10, PS2000A_US, BUFFER_SIZE_STREAMING, 1, 100, 30000 );
-    DEBUG ( "OK: %d\n", ok );
-
-    /* From here on, we can get data whenever we want...
-    */
-
-    while (!unitOpened_m.trigger.advanced.autoStop)
-    {
-        ps2000_get_streaming_last_values (unitOpened_m.handle, ps2000FastStreamingReady);
-        if (nPreviousValues != unitOpened_m.trigger.advanced.totalSamples)
-        {
-            DEBUG ("Values collected: %ld\n", unitOpened_m.trigger.advanced.totalSamples - nPreviousValues);
-            nPreviousValues =     unitOpened_m.trigger.advanced.totalSamples;
-        }
-        Sleep (0);
-    }
-
-    ps2000aStop(unitOpened_m.handle);
-
-    no_of_samples = ps2000_get_streaming_values_no_aggregation (unitOpened_m.handle,
-                                                                &startTime, // get samples from the beginning
-                                                                values_a, // set buffer for channel A
-                                                                values_b,    // set buffer for channel B
-                                                                NULL,
-                                                                NULL,
-                                                                &overflow,
-                                                                &triggerAt,
-                                                                &triggered,
-                                                                BUFFER_SIZE_STREAMING);
-
-
-    // if the unit triggered print out ten samples either side of the trigger point
-    // otherwise print the first 20 readings
-    for ( i = (triggered ? triggerAt - 10 : 0) ; i < ((triggered ? triggerAt - 10 : 0) + 20); i++)
-    {
-        for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-        {
-            if (unitOpened_m.channelSettings[ch].enabled)
-            {
-                DEBUG ("%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-            }
-        }
-        DEBUG ("\n");
-    }
-
-    fp = fopen ( "data.txt", "w" );
-    if (fp != NULL)
-    {
-        for ( i = 0; i < no_of_samples; i++ )
-        {
-            for (ch = 0; ch < unitOpened_m.noOfChannels; ch++)
-            {
-                if (unitOpened_m.channelSettings[ch].enabled)
-                {
-                    fDEBUG ( fp, "%d, ", adc_to_mv ((!ch ? values_a[i] : values_b[i]), unitOpened_m.channelSettings[ch].range) );
-                }
-            }
-            fDEBUG (fp, "\n");
-        }
-        fclose ( fp );
-    }
-    else
-        DEBUG("Cannot open the file data.txt for writing. \nPlease ensure that you have permission to access. \n");
-    //getch ();
-}
-
-
 /****************************************************************************
  *
  *
@@ -2286,6 +2221,10 @@ void Acquisition2000a::get_info (void)
             {
               variant = atoi(line);
             }
+            else if (i == 4)
+            {
+              snprintf(device_serial_m, DEVICE_NAME_MAX, "%s", line);
+            }
       DEBUG ( "%s: %s\n", description[i], line );
     }
 
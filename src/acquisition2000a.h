@@ -38,6 +38,8 @@
 #include "oscilloscope.h"
 #include "drawdata.h"
 #include "acquisition.h"
+#include "acquisitionpipeline.h"
+#include "digitalblock.h"
 
 #ifdef WIN32
 /* Headers for Windows */
@@ -59,14 +61,131 @@
 #include <stdint.h>
 
 /* Definition of PS2000a driver routines on Linux */
-//#define DYNLINK
+/* DYNLINK (configure --enable-dynlink) makes the routines pointer types */
 #include <libps2000a-1.0/ps2000aApi.h>
 #define __stdcall
+
+#ifdef DYNLINK
+/* driver routines resolved at run time into a table, calls are unchanged */
+#define PS2000A_LIBRARIES  { "libps2000a.so", "libps2000a.so.2", NULL }
+typedef struct
+{
+    ps2000aCloseUnit CloseUnit;
+    ps2000aGetNoOfCaptures GetNoOfCaptures;
+    ps2000aGetStreamingLatestValues GetStreamingLatestValues;
+    ps2000aGetTimebase GetTimebase;
+    ps2000aGetUnitInfo GetUnitInfo;
+    ps2000aGetValues GetValues;
+    ps2000aGetValuesBulk GetValuesBulk;
+    ps2000aMaximumValue MaximumValue;
+    ps2000aMemorySegments MemorySegments;
+    ps2000aOpenUnit OpenUnit;
+    ps2000aRunBlock RunBlock;
+    ps2000aRunStreaming RunStreaming;
+    ps2000aSetChannel SetChannel;
+    ps2000aSetDataBuffer SetDataBuffer;
+    ps2000aSetDataBuffers SetDataBuffers;
+    ps2000aSetDigitalPort SetDigitalPort;
+    ps2000aSetEts SetEts;
+    ps2000aSetNoOfCaptures SetNoOfCaptures;
+    ps2000aSetPulseWidthQualifier SetPulseWidthQualifier;
+    ps2000aSetSigGenArbitrary SetSigGenArbitrary;
+    ps2000aSetSigGenBuiltIn SetSigGenBuiltIn;
+    ps2000aSetSimpleTrigger SetSimpleTrigger;
+    ps2000aSetTriggerChannelConditions SetTriggerChannelConditions;
+    ps2000aSetTriggerChannelDirections SetTriggerChannelDirections;
+    ps2000aSetTriggerChannelProperties SetTriggerChannelProperties;
+    ps2000aSetTriggerDelay SetTriggerDelay;
+    ps2000aSetTriggerDigitalPortProperties SetTriggerDigitalPortProperties;
+    ps2000aStop Stop;
+}ps2000a_api_t;
+extern ps2000a_api_t ps2000a_api;
+#define ps2000aCloseUnit                       ps2000a_api.CloseUnit
+#define ps2000aGetNoOfCaptures                 ps2000a_api.GetNoOfCaptures
+#define ps2000aGetStreamingLatestValues        ps2000a_api.GetStreamingLatestValues
+#define ps2000aGetTimebase                     ps2000a_api.GetTimebase
+#define ps2000aGetUnitInfo                     ps2000a_api.GetUnitInfo
+#define ps2000aGetValues                       ps2000a_api.GetValues
+#define ps2000aGetValuesBulk                   ps2000a_api.GetValuesBulk
+#define ps2000aMaximumValue                    ps2000a_api.MaximumValue
+#define ps2000aMemorySegments                  ps2000a_api.MemorySegments
+#define ps2000aOpenUnit                        ps2000a_api.OpenUnit
+#define ps2000aRunBlock                        ps2000a_api.RunBlock
+#define ps2000aRunStreaming                    ps2000a_api.RunStreaming
+#define ps2000aSetChannel                      ps2000a_api.SetChannel
+#define ps2000aSetDataBuffer                   ps2000a_api.SetDataBuffer
+#define ps2000aSetDataBuffers                  ps2000a_api.SetDataBuffers
+#define ps2000aSetDigitalPort                  ps2000a_api.SetDigitalPort
+#define ps2000aSetEts                          ps2000a_api.SetEts
+#define ps2000aSetNoOfCaptures                 ps2000a_api.SetNoOfCaptures
+#define ps2000aSetPulseWidthQualifier          ps2000a_api.SetPulseWidthQualifier
+#define ps2000aSetSigGenArbitrary              ps2000a_api.SetSigGenArbitrary
+#define ps2000aSetSigGenBuiltIn                ps2000a_api.SetSigGenBuiltIn
+#define ps2000aSetSimpleTrigger                ps2000a_api.SetSimpleTrigger
+#define ps2000aSetTriggerChannelConditions     ps2000a_api.SetTriggerChannelConditions
+#define ps2000aSetTriggerChannelDirections     ps2000a_api.SetTriggerChannelDirections
+#define ps2000aSetTriggerChannelProperties     ps2000a_api.SetTriggerChannelProperties
+#define ps2000aSetTriggerDelay                 ps2000a_api.SetTriggerDelay
+#define ps2000aSetTriggerDigitalPortProperties ps2000a_api.SetTriggerDigitalPortProperties
+#define ps2000aStop                            ps2000a_api.Stop
+#endif
 /* End of Linux-specific definitions */
 #endif
 
 
-class Acquisition2000a : public Acquisition{
+/**
+ * @brief libps2000a calls and constants used by the streaming pipeline
+ */
+struct Ps2000aTraits
+{
+    /* channels are not a trigger source only: no source disables the simple trigger */
+    static const short NONE = -1;
+    /* each poll drains at most BUFFER_SIZE samples per channel: 1 MS/s */
+    enum { FAST_STREAMING_MIN_INTERVAL_NS = 1000 };
+
+    static short set_trigger (short handle, short source, short threshold, short direction, short delay, short auto_trigger_ms)
+    { return (PICO_OK == ps2000aSetSimpleTrigger ( handle, (NONE != source) ? 1 : 0, (NONE != source) ? (PS2000A_CHANNEL)source : PS2000A_CHANNEL_A,
+                                                   threshold, (PS2000A_THRESHOLD_DIRECTION)direction, delay, auto_trigger_ms )) ? 1 : 0; }
+    static short stop (short handle)
+    { return (PICO_OK == ps2000aStop ( handle )) ? 1 : 0; }
+    /* fast streaming: the driver copies new samples into the application buffers,
+     * buffer_size samples at most between two polls */
+    static short run_streaming_ns (short handle, unsigned long sample_interval_ns, unsigned long max_samples, short **buffers, unsigned long buffer_size)
+    {
+        short ch;
+
+        for (ch = 0; ch < MAX_CHANNELS; ch++)
+        {
+            if ( NULL != buffers[ch] )
+                ps2000aSetDataBuffer ( handle, ch, buffers[ch], buffer_size, 0, PS2000A_RATIO_MODE_NONE );
+        }
+        return (PICO_OK == ps2000aRunStreaming ( handle, &sample_interval_ns, PS2000A_NS, 0, max_samples, 0, 1,
+                                                 PS2000A_RATIO_MODE_NONE, buffer_size )) ? 1 : 0;
+    }
+    template <class SINK>
+    static short get_streaming_last_values (short handle, short **buffers)
+    { return (PICO_OK == ps2000aGetStreamingLatestValues ( handle, &streaming_ready<SINK>, buffers )) ? 1 : 0; }
+    /* new samples start at start_index in each buffer: hand them as max/min pairs */
+    template <class SINK>
+    static void __stdcall streaming_ready (short handle, long nb_values, unsigned long start_index, short overflow,
+                                           unsigned long trigger_at, short triggered, short auto_stop, void *parameter)
+    {
+        short **buffers = (short **)parameter;
+        short *overview_buffers[2 * MAX_CHANNELS];
+        short ch;
+
+        (void)handle; (void)overflow; (void)trigger_at; (void)triggered; (void)auto_stop;
+        for (ch = 0; ch < MAX_CHANNELS; ch++)
+        {
+            overview_buffers[2 * ch] = (NULL != buffers[ch]) ? buffers[ch] + start_index : NULL;
+            overview_buffers[2 * ch + 1] = overview_buffers[2 * ch];
+        }
+        SINK::streaming_ready ( overview_buffers, nb_values );
+    }
+};
+
+class Acquisition2000a : public StreamingPipeline<Acquisition2000a, Ps2000aTraits>{
+    friend class StreamingPipeline<Acquisition2000a, Ps2000aTraits>;
 public:
     /**
      * @brief public typedef declarations
@@ -191,6 +310,7 @@ private:
         short maxTimebase;
         short timebases;
         short noOfChannels;
+        short noOfDigitalPorts;
 	    short maxValue;
         CHANNEL_SETTINGS channelSettings[PS2000A_MAX_CHANNELS];
         short                hasAdvancedTriggering;
@@ -222,15 +342,11 @@ private:
     void collect_block_triggered (trigger_e trigger_slope, double trigger_level);    // OK
     void collect_block_advanced_triggered ();
     void collect_block_ets (void);
+    /**
+     * @brief collect blocks of analog channels and digital ports of MSO models till the acquisition stops
+     */
+    void collect_block_mixed (void);
     void collect_streaming (void);
-    void collect_fast_streaming (void);
-    void collect_fast_streaming_triggered (void);
-    static void  __stdcall ps2000FastStreamingReady( short **overviewBuffers,
-                                                     short overflow,
-                                                     unsigned long triggeredAt,
-                                                     short triggered,
-                                                     short auto_stop,
-                                                     unsigned long nValues);
     /**
      * @brief private instances declarations
      */
@@ -239,6 +355,8 @@ private:
     short timebase;
     double time_per_division_m;
     long times[BUFFER_SIZE];
+    /** @brief logic lines of the last mixed capture, bit-packed */
+    DigitalBlock digital_m;
     static const short input_ranges [PS2000A_MAX_RANGES] /*= {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000}*/;
 };
 
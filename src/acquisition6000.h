@@ -38,6 +38,7 @@
 #include "oscilloscope.h"
 #include "drawdata.h"
 #include "acquisition.h"
+#include "acquisitionpipeline.h"
 
 #ifdef WIN32
 /* Headers for Windows */
@@ -59,14 +60,102 @@
 #include <stdint.h>
 
 /* Definition of PS6000 driver routines on Linux */
-//#define DYNLINK
+/* DYNLINK (configure --enable-dynlink) makes the routines pointer types */
 #include <libps6000-1.4/ps6000Api.h>
 #define __stdcall
+
+#ifdef DYNLINK
+/* driver routines resolved at run time into a table, calls are unchanged */
+#define PS6000_LIBRARIES  { "libps6000.so", "libps6000.so.1", NULL }
+typedef struct
+{
+    ps6000GetUnitInfo GetUnitInfo;
+    ps6000_close_unit close_unit;
+    ps6000_get_streaming_last_values get_streaming_last_values;
+    ps6000_get_streaming_values_no_aggregation get_streaming_values_no_aggregation;
+    ps6000_get_timebase get_timebase;
+    ps6000_get_times_and_values get_times_and_values;
+    ps6000_get_unit_info get_unit_info;
+    ps6000_get_values get_values;
+    ps6000_open_unit open_unit;
+    ps6000_ready ready;
+    ps6000_run_block run_block;
+    ps6000_run_streaming run_streaming;
+    ps6000_run_streaming_ns run_streaming_ns;
+    ps6000_set_channel set_channel;
+    ps6000_set_ets set_ets;
+    ps6000_set_trigger set_trigger;
+    ps6000_stop stop;
+}ps6000_api_t;
+extern ps6000_api_t ps6000_api;
+#define ps6000GetUnitInfo                          ps6000_api.GetUnitInfo
+#define ps6000_close_unit                          ps6000_api.close_unit
+#define ps6000_get_streaming_last_values           ps6000_api.get_streaming_last_values
+#define ps6000_get_streaming_values_no_aggregation ps6000_api.get_streaming_values_no_aggregation
+#define ps6000_get_timebase                        ps6000_api.get_timebase
+#define ps6000_get_times_and_values                ps6000_api.get_times_and_values
+#define ps6000_get_unit_info                       ps6000_api.get_unit_info
+#define ps6000_get_values                          ps6000_api.get_values
+#define ps6000_open_unit                           ps6000_api.open_unit
+#define ps6000_ready                               ps6000_api.ready
+#define ps6000_run_block                           ps6000_api.run_block
+#define ps6000_run_streaming                       ps6000_api.run_streaming
+#define ps6000_run_streaming_ns                    ps6000_api.run_streaming_ns
+#define ps6000_set_channel                         ps6000_api.set_channel
+#define ps6000_set_ets                             ps6000_api.set_ets
+#define ps6000_set_trigger                         ps6000_api.set_trigger
+#define ps6000_stop                                ps6000_api.stop
+#endif
 /* End of Linux-specific definitions */
 #endif
 
 
-class Acquisition6000 : public Acquisition{
+/**
+ * @brief libps6000 calls and constants used by the acquisition pipeline
+ */
+struct Ps6000Traits
+{
+    enum { MAX_VALUE = 32767 };
+    /* fast streaming runs up to 10 MS/s */
+    enum { FAST_STREAMING_MIN_INTERVAL_NS = 100 };
+    static const short NONE = PS6000_NONE;
+    static const short RISING = PS6000_RISING;
+    static const short FALLING = PS6000_FALLING;
+    static const PS6000_CHANNEL CHANNEL_A = PS6000_CHANNEL_A;
+    static const short input_ranges [PS6000_MAX_RANGES] /*= {10, 20, 50, 100, 200, 500, 1000, 3000, 5000, 10000, 30000, 50000}*/;
+
+    static short set_trigger (short handle, short source, short threshold, short direction, short delay, short auto_trigger_ms)
+    { return ps6000_set_trigger ( handle, source, threshold, direction, delay, auto_trigger_ms ); }
+    static short get_timebase (short handle, short timebase, long no_of_samples, long *time_interval, short *time_units, short oversample, long *max_samples)
+    { return ps6000_get_timebase ( handle, timebase, no_of_samples, time_interval, time_units, oversample, max_samples ); }
+    static short run_block (short handle, long no_of_values, short timebase, short oversample, long *time_indisposed_ms)
+    { return ps6000_run_block ( handle, no_of_values, timebase, oversample, time_indisposed_ms ); }
+    static short ready (short handle)
+    { return ps6000_ready ( handle ); }
+    static short stop (short handle)
+    { return ps6000_stop ( handle ); }
+    static short run_streaming (short handle, short sample_interval_ms, long max_samples, short windowed)
+    { return ps6000_run_streaming ( handle, sample_interval_ms, max_samples, windowed ); }
+    static long get_values (short handle, short *a, short *b, short *c, short *d, short *overflow, long no_of_values)
+    { return ps6000_get_values ( handle, a, b, c, d, overflow, no_of_values ); }
+    static long set_ets (short handle, bool enabled, short cycles, short interleave)
+    { return ps6000_set_ets ( handle, enabled ? PS6000_ETS_FAST : PS6000_ETS_OFF, cycles, interleave ); }
+    static long get_times_and_values_ps (short handle, long *times, short *a, short *b, short *c, short *d, short *overflow, long no_of_values)
+    { return ps6000_get_times_and_values ( handle, times, a, b, c, d, overflow, PS6000_PS, no_of_values ); }
+    /* fast streaming: the driver keeps the overview buffers, no application buffers */
+    static short run_streaming_ns (short handle, unsigned long sample_interval_ns, unsigned long max_samples, short **buffers, unsigned long buffer_size)
+    { (void)buffers; (void)buffer_size; return ps6000_run_streaming_ns ( handle, sample_interval_ns, PS6000_NS, max_samples, 0, 1, 30000 ); }
+    template <class SINK>
+    static short get_streaming_last_values (short handle, short **buffers)
+    { (void)buffers; return ps6000_get_streaming_last_values ( handle, &streaming_ready<SINK> ); }
+    template <class SINK>
+    static void __stdcall streaming_ready (short **overview_buffers, short overflow, unsigned long triggered_at, short triggered, short auto_stop, unsigned long nb_values)
+    { (void)overflow; (void)triggered_at; (void)triggered; (void)auto_stop; SINK::streaming_ready ( overview_buffers, nb_values ); }
+};
+
+class Acquisition6000 : public AcquisitionPipeline<Acquisition6000, Ps6000Traits>{
+    friend class StreamingPipeline<Acquisition6000, Ps6000Traits>;
+    friend class AcquisitionPipeline<Acquisition6000, Ps6000Traits>;
 public:
     /**
      * @brief public typedef declarations
@@ -243,34 +332,18 @@ private:
      * @brief private methods declarations
      */
     Acquisition6000();
-    int adc_to_mv (long raw, int ch);    
-    short mv_to_adc (short mv, short ch);
     void get_info (void);
     void set_defaults (void);
     void set_trigger_advanced(void);
-    void collect_block_immediate (void);
-    void collect_block_triggered (trigger_e trigger_slope, double trigger_level);
     void collect_block_advanced_triggered ();
-    void collect_block_ets (void);
-    void collect_streaming (void);
-    void collect_fast_streaming (void);
-    void collect_fast_streaming_triggered (void);
-    static void  __stdcall ps6000FastStreamingReady( short **overviewBuffers,
-                                                     short overflow,
-                                                     unsigned long triggeredAt,
-                                                     short triggered,
-                                                     short auto_stop,
-                                                     unsigned long nValues);
     /**
      * @brief private instances declarations
      */
     UNIT_MODEL unitOpened_m;
     static Acquisition6000 *singleton_m;
-    int scale_to_mv;
     short timebase;
     double time_per_division_m;
     long times[BUFFER_SIZE];
-    static const short input_ranges [PS6000_MAX_RANGES] /*= {10, 20, 50, 100, 200, 500, 1000, 3000, 5000, 10000, 30000, 50000}*/;
 };
 
 #endif // HAVE_LIBPS6000
@@ -0,0 +1,843 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file acquisitionpipeline.h
+ * @brief Declaration and definition of StreamingPipeline and AcquisitionPipeline
+ * class templates.
+ * Collect loops shared by the Picoscope families using the same block and
+ * streaming API. Driver calls and constants come from a per-family traits
+ * class, so each family gets its own compiled loops without virtual calls.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+#ifndef ACQUISITIONPIPELINE_H
+#define ACQUISITIONPIPELINE_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "oscilloscope.h"
+#include "drawdata.h"
+#include "acquisition.h"
+
+#ifndef WIN32
+#ifndef Sleep
+#define Sleep(x) usleep(1000*(x))
+#endif
+#endif
+
+/* ETS in fast mode: the driver stores ETS_CYCLES cycles and interleaves ETS_INTERLEAVE of them per pass */
+#define ETS_CYCLES       60
+#define ETS_INTERLEAVE   4
+
+/* samples searched on each side of the nominal trigger index for the exact crossing */
+#define TRIGGER_SEARCH_SAMPLES 4
+
+/* delay between two polls of a running block: captures are rearmed as soon as they are read */
+#define BLOCK_READY_POLL_MS    1
+
+/**
+ * Fast streaming loop, shared by every family with a callback streaming API.
+ *
+ * A traits class provides, as static members:
+ *  - FAST_STREAMING_MIN_INTERVAL_NS : shortest sample interval the family streams at,
+ *  - NONE : trigger source disabling the trigger,
+ *  - set_trigger, stop : driver calls,
+ *  - run_streaming_ns : start streaming without aggregation, into the driver
+ *    buffers or into the given per channel buffers,
+ *  - get_streaming_last_values<SINK> : poll the driver, new samples are handed
+ *    to SINK::streaming_ready as max/min buffer pairs per channel.
+ *
+ * DRIVER is the family class deriving from the pipeline. It must declare the
+ * pipeline as friend and provide get_instance(), unitOpened_m and
+ * time_per_division_m.
+ */
+template <class DRIVER, class TRAITS>
+class StreamingPipeline : public Acquisition {
+public:
+    /**
+     * @brief driver callback target: appends new samples to the live record
+     * @param[in] : max/min buffer pairs per channel, NULL for disabled channels
+     * @param[in] : number of new samples
+     */
+    static void streaming_ready (short **overview_buffers, unsigned long nb_values);
+protected:
+    StreamingPipeline() {}
+    virtual ~StreamingPipeline() {}
+    void collect_fast_streaming (void);
+    void collect_fast_streaming_triggered (void);
+    /**
+     * @brief get volts per ADC count of each enabled channel
+     * @param[out] : table of MAX_CHANNELS scales, 0 for disabled channels
+     * return : bit mask of enabled channels
+     */
+    uint8_t channel_scales (double *scale);
+    DRIVER *driver (void) { return static_cast<DRIVER*>(this); }
+private:
+    /**
+     * @brief stream samples until stopped, drawing them as a strip chart
+     * @param[in] : true when streaming starts on the advanced trigger
+     */
+    void fast_streaming_loop (bool triggered);
+};
+
+/****************************************************************************
+ * streaming_ready
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void StreamingPipeline<DRIVER, TRAITS>::streaming_ready (short **overview_buffers, unsigned long nb_values)
+{
+    StreamingPipeline *instance = DRIVER::get_instance();
+    if(NULL != instance)
+    {
+        instance->live_streaming_append(overview_buffers, nb_values);
+    }
+}
+
+/****************************************************************************
+ * channel_scales
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+uint8_t StreamingPipeline<DRIVER, TRAITS>::channel_scales (double *scale)
+{
+    short ch = 0;
+    uint8_t channels = 0;
+
+    for (ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        scale[ch] = 0.;
+        if ( (ch < driver()->unitOpened_m.noOfChannels) &&
+             driver()->unitOpened_m.channelSettings[ch].enabled )
+        {
+            channels |= (1 << ch);
+            scale[ch] = 0.001 * adc_to_mv(SHRT_MAX, driver()->unitOpened_m.channelSettings[ch].range) / SHRT_MAX;
+        }
+    }
+    return channels;
+}
+
+/****************************************************************************
+ * collect_fast_streaming
+ *
+ * live fast streaming: samples are not aggregated by the driver,
+ * the callback stores them in the record rings and builds the
+ * max/min aggregates drawn as a strip chart while streaming.
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void StreamingPipeline<DRIVER, TRAITS>::collect_fast_streaming (void)
+{
+    DEBUG ( "Collect fast streaming...\n" );
+
+    fast_streaming_loop (false);
+}
+
+/****************************************************************************
+ * collect_fast_streaming_triggered
+ *
+ * same strip chart, the driver starts streaming on the advanced trigger.
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void StreamingPipeline<DRIVER, TRAITS>::collect_fast_streaming_triggered (void)
+{
+    DEBUG ( "Collect fast streaming triggered...\n" );
+
+    fast_streaming_loop (true);
+}
+
+/****************************************************************************
+ * fast_streaming_loop
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void StreamingPipeline<DRIVER, TRAITS>::fast_streaming_loop (bool triggered)
+{
+    short ok;
+    short ch;
+    uint8_t channels = 0;
+    short* buffers[MAX_CHANNELS] = {NULL};
+    unsigned long interval_ns = 0;
+    double sample_interval = 0.;
+    uint32_t samples_in_screen = 0;
+
+    if ( 0 != reserve_streaming_buffers ( BUFFER_SIZE_STREAMING ) )
+        return;
+
+    driver()->set_defaults ();
+
+    if ( triggered )
+    {
+        driver()->set_trigger_advanced ();
+    }
+    else
+    {
+        /* You cannot use triggering for the start of the data...
+        */
+        TRAITS::set_trigger ( driver()->unitOpened_m.handle, TRAITS::NONE, 0, 0, 0, 0 );
+    }
+
+    channels = channel_scales (live_scale_m);
+    /* the record holds the screen at the timebase, down to the fastest interval of the family */
+    interval_ns = (unsigned long)ceil ( 5 * driver()->time_per_division_m * 1E9 / buffer_pool_m.capacity() );
+    if ( interval_ns < (unsigned long)TRAITS::FAST_STREAMING_MIN_INTERVAL_NS )
+        interval_ns = TRAITS::FAST_STREAMING_MIN_INTERVAL_NS;
+    sample_interval = interval_ns * 1E-9;
+    samples_in_screen = (uint32_t)(5 * driver()->time_per_division_m / sample_interval);
+    if ( 0 != live_streaming_setup ( channels, sample_interval, samples_in_screen ) )
+        return;
+
+    /* families streaming into application buffers get the channel buffers */
+    for (ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        buffers[ch] = (channels & (1 << ch)) ? driver()->unitOpened_m.channelSettings[ch].values : NULL;
+    }
+
+    /* Collect data at interval_ns intervals
+    * no agregation, the callback gets every sample
+    *    No auto stop, streaming runs till the thread is stopped
+    *  Start it collecting,
+    */
+    ok = TRAITS::run_streaming_ns ( driver()->unitOpened_m.handle, interval_ns, buffer_pool_m.capacity(), buffers, BUFFER_SIZE );
+    DEBUG ( "OK: %d\tinterval: %luns\n", ok, interval_ns );
+
+    /* From here on, we can get data whenever we want...
+    */
+    while ( sem_trywait(&thread_stop) )
+    {
+        TRAITS::template get_streaming_last_values<StreamingPipeline> ( driver()->unitOpened_m.handle, buffers );
+        live_streaming_draw ();
+        Sleep (0);
+    }
+
+    TRAITS::stop ( driver()->unitOpened_m.handle );
+
+    /* last screen is drawn at full resolution */
+    live_streaming_draw_record ();
+}
+
+/**
+ * A traits class provides, besides the streaming ones, as static members:
+ *  - MAX_VALUE : ADC count of a full scale input,
+ *  - NONE, RISING, FALLING : trigger source and directions,
+ *  - input_ranges[] : input ranges table in mV,
+ *  - set_trigger, get_timebase, run_block, ready, stop,
+ *    run_streaming, get_values : driver calls,
+ *  - set_ets, get_times_and_values_ps : equivalent time sampling calls.
+ *
+ * DRIVER is the family class deriving from the pipeline. It must declare the
+ * pipelines as friends and provide unitOpened_m, timebase, times,
+ * time_per_division_m and set_defaults().
+ */
+template <class DRIVER, class TRAITS>
+class AcquisitionPipeline : public StreamingPipeline<DRIVER, TRAITS> {
+protected:
+    typedef TRAITS Traits;
+    typedef StreamingPipeline<DRIVER, TRAITS> Streaming;
+    /* members of the dependent base, looked up at instantiation */
+    using Streaming::driver;
+    using Streaming::channel_scales;
+    using Streaming::thread_stop;
+    using Streaming::ets_m;
+    using Streaming::live_scale_m;
+    using Streaming::trigger_slope_m;
+    using Streaming::trigger_level_m;
+    using Streaming::reserve_streaming_buffers;
+    using Streaming::reserve_processing;
+    using Streaming::filter_start;
+    using Streaming::filter_samples;
+    using Streaming::filter_delay;
+    using Streaming::average_start;
+    using Streaming::average_samples;
+    using Streaming::decode_start;
+    using Streaming::decode_samples;
+    using Streaming::analyze_samples;
+    using Streaming::analyze;
+    using Streaming::mask_test;
+    using Streaming::draw_frame;
+    using Streaming::evaluate_math;
+    using Streaming::history_store;
+    using Streaming::roll_setup;
+    using Streaming::roll_append;
+    using Streaming::roll_draw;
+    using Streaming::adc_multipliers;
+    AcquisitionPipeline() : scale_to_mv(1), trigger_threshold_m(0) {}
+    virtual ~AcquisitionPipeline() {}
+    /**
+     * @brief convert an ADC count into millivolts
+     * @param[in] : ADC count
+     * @param[in] : input range index
+     */
+    int adc_to_mv (long raw, int ch);
+    /**
+     * @brief convert millivolts into an ADC count (useful for trigger thresholds)
+     * @param[in] : millivolts
+     * @param[in] : input range index
+     */
+    short mv_to_adc (short mv, short ch);
+    void collect_block_immediate (void);
+    void collect_block_triggered (trigger_e trigger_slope, double trigger_level);
+    void collect_block_ets (void);
+    void collect_streaming (void);
+    int scale_to_mv;
+private:
+    /**
+     * @brief set the simple trigger on channel A with 10% pre-trigger
+     * @param[in] : trigger slope, rising unless falling
+     * @param[in] : trigger level in volts
+     */
+    void set_simple_trigger (trigger_e trigger_slope, double trigger_level);
+    /**
+     * @brief locate the trigger crossing between samples, by linear interpolation
+     * of the two samples around the crossing nearest to the nominal trigger index
+     * @param[in] : raw ADC counts of the trigger channel
+     * @param[in] : number of samples
+     * @param[in] : nominal trigger index, from the pre-trigger ratio
+     * return : crossing position minus nominal index, in samples, 0 if no crossing is found
+     */
+    double trigger_offset (const short *values, long count, long trigger_index);
+    /**
+     * @brief run blocks until stopped, filling the screen block after block
+     * @param[in] : true when captures start on the simple trigger
+     */
+    void collect_block_loop (bool triggered);
+    /** @brief simple trigger threshold, in ADC counts */
+    short trigger_threshold_m;
+};
+
+/****************************************************************************
+ * adc_to_mv
+ *
+ * If the user selects scaling to millivolts,
+ * Convert an ADC count into millivolts
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+int AcquisitionPipeline<DRIVER, TRAITS>::adc_to_mv (long raw, int ch)
+{
+      return ( scale_to_mv ) ? ( raw * TRAITS::input_ranges[ch] ) / TRAITS::MAX_VALUE : raw;
+}
+
+/****************************************************************************
+ * mv_to_adc
+ *
+ * Convert a millivolt value into an ADC count
+ *
+ *  (useful for setting trigger thresholds)
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+short AcquisitionPipeline<DRIVER, TRAITS>::mv_to_adc (short mv, short ch)
+{
+  return ( ( mv * TRAITS::MAX_VALUE ) / TRAITS::input_ranges[ch] );
+}
+
+/****************************************************************************
+ * collect_block_immediate
+ *
+ * this function demonstrates how to collect a single block of data
+ * from the unit (start collecting immediately)
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void AcquisitionPipeline<DRIVER, TRAITS>::collect_block_immediate (void)
+{
+    DEBUG ( "Collect block immediate...\n" );
+
+    driver()->set_defaults ();
+
+    /* Trigger disabled
+     */
+    TRAITS::set_trigger ( driver()->unitOpened_m.handle, TRAITS::NONE, 0, TRAITS::RISING, 0, 0 );
+
+    collect_block_loop (false);
+}
+
+/****************************************************************************
+ * collect_block_triggered
+ *
+ * this function demonstrates how to collect a single block of data from the
+ * unit, when a trigger event occurs.
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void AcquisitionPipeline<DRIVER, TRAITS>::collect_block_triggered (trigger_e trigger_slope, double trigger_level)
+{
+    DEBUG ( "Collect block triggered...\n" );
+
+    driver()->set_defaults ();
+
+    set_simple_trigger (trigger_slope, trigger_level);
+
+    collect_block_loop (true);
+}
+
+/****************************************************************************
+ * set_simple_trigger
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void AcquisitionPipeline<DRIVER, TRAITS>::set_simple_trigger (trigger_e trigger_slope, double trigger_level)
+{
+    int threshold_mv = (int)(trigger_level * 1000);
+    short trigger_channel = 0;
+
+    DEBUG ( "Collects when value crosses %dmV\n", threshold_mv );
+
+    /* Trigger enabled
+     * ChannelA
+     * Rising or falling edge
+     * 10% pre-trigger  (negative is pre-, positive is post-)
+     */
+    driver()->unitOpened_m.trigger.simple.channel = TRAITS::CHANNEL_A;
+    switch(trigger_slope)
+    {
+        case E_TRIGGER_FALLING:
+            driver()->unitOpened_m.trigger.simple.direction = (short) TRAITS::FALLING;
+        break;
+        case E_TRIGGER_RISING:
+        default:
+            driver()->unitOpened_m.trigger.simple.direction = (short) TRAITS::RISING;
+        break;
+    }
+    driver()->unitOpened_m.trigger.simple.threshold = 100.f;
+    driver()->unitOpened_m.trigger.simple.delay = -10;
+
+    trigger_channel = (short) driver()->unitOpened_m.trigger.simple.channel;
+    trigger_threshold_m = mv_to_adc (threshold_mv, driver()->unitOpened_m.channelSettings[trigger_channel].range);
+    TRAITS::set_trigger ( driver()->unitOpened_m.handle,
+                          trigger_channel,
+                          trigger_threshold_m,
+                          driver()->unitOpened_m.trigger.simple.direction,
+                          (short) driver()->unitOpened_m.trigger.simple.delay,
+                          0 );
+}
+
+/****************************************************************************
+ * trigger_offset
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+double AcquisitionPipeline<DRIVER, TRAITS>::trigger_offset (const short *values, long count, long trigger_index)
+{
+    bool rising = ( (short) TRAITS::FALLING != driver()->unitOpened_m.trigger.simple.direction );
+    long distance = 0;
+    long side = 0;
+    long i = 0;
+    short before = 0;
+    short after = 0;
+
+    /* look outwards from the nominal index, the nearest crossing wins */
+    for (distance = 0; distance <= TRIGGER_SEARCH_SAMPLES; distance++)
+    {
+        for (side = -1; side <= 1; side += 2)
+        {
+            i = trigger_index + side * distance;
+            if ( (i < 1) || (i >= count) )
+                continue;
+            before = values[i - 1];
+            after = values[i];
+            if ( rising ? ((before < trigger_threshold_m) && (after >= trigger_threshold_m)) :
+                          ((before > trigger_threshold_m) && (after <= trigger_threshold_m)) )
+            {
+                return (i - 1 - trigger_index) + (double)(trigger_threshold_m - before) / (after - before);
+            }
+        }
+    }
+    return 0.;
+}
+
+/****************************************************************************
+ * collect_block_ets
+ *
+ * equivalent time sampling of a repetitive signal: each triggered pass
+ * returns interleaved samples with their times, passes are merged into one
+ * waveform sorted by time and the waveform is drawn after each pass.
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void AcquisitionPipeline<DRIVER, TRAITS>::collect_block_ets (void)
+{
+    long time_indisposed_ms;
+    short overflow;
+    long ets_sample_time_ps;
+    long no_of_values;
+    long i = 0;
+    short ch = 0;
+    uint8_t channels = 0;
+    double scale[MAX_CHANNELS];
+    const short* raw[MAX_CHANNELS] = {NULL};
+    double times[BUFFER_SIZE];
+    double pre_trigger = 0.;
+    sample_frame_t frame;
+
+    DEBUG ( "Collect block ETS...\n" );
+
+    driver()->set_defaults ();
+
+    /* ETS needs a trigger: auto falls back on rising edge */
+    set_simple_trigger (trigger_slope_m, trigger_level_m);
+
+    ets_sample_time_ps = TRAITS::set_ets ( driver()->unitOpened_m.handle, true, ETS_CYCLES, ETS_INTERLEAVE );
+    DEBUG ( "ETS Sample Time is: %ld ps\n", ets_sample_time_ps );
+    if ( ets_sample_time_ps <= 0 )
+    {
+        ERROR ( "ETS is not available at this timebase\n" );
+        return;
+    }
+    if ( 0 != ets_m.allocate ( BUFFER_SIZE, ETS_PASSES ) )
+    {
+        TRAITS::set_ets ( driver()->unitOpened_m.handle, false, 0, 0 );
+        return;
+    }
+    reserve_processing ( BUFFER_SIZE * ETS_PASSES );
+
+    channels = channel_scales (scale);
+    /* times are relative to the trigger: shift the pre-trigger part on screen */
+    pre_trigger = -driver()->unitOpened_m.trigger.simple.delay / 100. * BUFFER_SIZE * ets_sample_time_ps * 1e-12;
+    frame.channels = channels;
+    frame.triggered = 1;
+    frame.trigger_time = pre_trigger;
+    frame.digital = NULL;
+    for (ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        raw[ch] = (channels & (1 << ch)) ? driver()->unitOpened_m.channelSettings[ch].values : NULL;
+        frame.blocks[ch].scale = scale[ch];
+        frame.blocks[ch].dt = ets_sample_time_ps * 1e-12;
+        frame.blocks[ch].times = ets_m.times();
+    }
+
+    while ( sem_trywait(&thread_stop) )
+    {
+        TRAITS::run_block ( driver()->unitOpened_m.handle, BUFFER_SIZE, driver()->timebase, 1, &time_indisposed_ms );
+        while ( !TRAITS::ready ( driver()->unitOpened_m.handle ) )
+        {
+            if( !sem_trywait(&thread_stop) )
+            {
+                /* re-post semaphore to exit the main loop */
+                sem_post(&thread_stop);
+                break;
+            }
+            Sleep ( 10 );
+        }
+
+        TRAITS::stop ( driver()->unitOpened_m.handle );
+
+        no_of_values = TRAITS::get_times_and_values_ps ( driver()->unitOpened_m.handle,
+                                                         driver()->times,
+                                                         driver()->unitOpened_m.channelSettings[0].values,
+                                                         driver()->unitOpened_m.channelSettings[1].values,
+                                                         driver()->unitOpened_m.channelSettings[2].values,
+                                                         driver()->unitOpened_m.channelSettings[3].values,
+                                                         &overflow, BUFFER_SIZE );
+
+        DEBUG ( "%ld ETS values, overflow %d\n", no_of_values, overflow );
+
+        if ( no_of_values > 0 )
+        {
+            for (i = 0; i < no_of_values; i++)
+            {
+                times[i] = driver()->times[i] * 1e-12 + pre_trigger;
+            }
+            /* each pass is a capture of its own, unevenly spaced: histograms only */
+            for (ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                if ( NULL != raw[ch] )
+                    analyze_samples ( ch, raw[ch], no_of_values, scale[ch], 0. );
+            }
+            if ( 0 == ets_m.merge ( times, raw, channels, no_of_values ) )
+            {
+                for (ch = 0; ch < MAX_CHANNELS; ch++)
+                {
+                    frame.blocks[ch].raw = (channels & (1 << ch)) ? ets_m.values(ch) : NULL;
+                    frame.blocks[ch].t0 = ets_m.times()[0];
+                    frame.blocks[ch].count = ets_m.count();
+                    frame.blocks[ch].stable = 0;
+                }
+                draw_frame ( &frame );
+                history_store ( &frame );
+            }
+        }
+    }
+    TRAITS::set_ets ( driver()->unitOpened_m.handle, false, 0, 0 );
+}
+
+/****************************************************************************
+ * collect_block_loop
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void AcquisitionPipeline<DRIVER, TRAITS>::collect_block_loop (bool triggered)
+{
+    long time_interval;
+    short time_units;
+    short oversample;
+    int no_of_samples = BUFFER_SIZE;
+    int nb_of_samples_in_screen = 0;
+    long no_of_values;
+    long time_indisposed_ms;
+    short overflow;
+    long max_samples;
+    short ch = 0;
+    uint8_t channels = 0;
+    double scale[MAX_CHANNELS];
+    short* screen[MAX_CHANNELS] = {NULL};
+    const short* raw[MAX_CHANNELS] = {NULL};
+    const short* averaged[MAX_CHANNELS] = {NULL};
+    bool interleaved = false;
+    short trigger_channel = 0;
+    double shift = 0.;
+    long index = 0;
+    long n = 0;
+    double dt = 0.;
+    double delay = 0.;
+    bool failed = false;
+    sample_frame_t frame;
+
+    /*  find the maximum number of samples, the time interval (in time_units),
+    *         the most suitable time units, and the maximum oversample at the current timebase
+    */
+    oversample = 1;
+    while (!TRAITS::get_timebase ( driver()->unitOpened_m.handle,
+                                   driver()->timebase,
+                                   no_of_samples,
+                                   &time_interval,
+                                   &time_units,
+                                   oversample,
+                                   &max_samples))
+        driver()->timebase++;
+
+    /* samples are evenly spaced: time is t0 + i * dt, no time table needed */
+    dt = time_interval * adc_multipliers(time_units);
+    nb_of_samples_in_screen = (int)(5 * driver()->time_per_division_m / dt) + 1;
+    nb_of_samples_in_screen = ( nb_of_samples_in_screen < BUFFER_SIZE ? BUFFER_SIZE : nb_of_samples_in_screen);
+    channels = channel_scales (scale);
+    for (ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        if (channels & (1 << ch))
+        {
+            screen[ch] = (short*)malloc(nb_of_samples_in_screen * sizeof(short));
+            if (NULL == screen[ch])
+            {
+                ERROR ( "cannot allocate %d samples\n", nb_of_samples_in_screen );
+                channels &= ~(1 << ch);
+            }
+        }
+    }
+    frame.channels = channels;
+    frame.triggered = triggered ? 1 : 0;
+    frame.digital = NULL;
+    for (ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        frame.blocks[ch].raw = screen[ch];
+        frame.blocks[ch].scale = scale[ch];
+        frame.blocks[ch].t0 = 0.;
+        frame.blocks[ch].dt = dt;
+        frame.blocks[ch].times = NULL;
+    }
+    average_start ( nb_of_samples_in_screen );
+    /* the loop below works within a screen: nothing grows once it runs */
+    reserve_processing ( nb_of_samples_in_screen );
+    DEBUG ( "timebase: %hd\tnb_of_samples:%d\toversample:%hd\ttime_units:%hd\ttime_interval:%lu\tdt:%e\tnb_of_samples_in_screen:%d\n",
+             driver()->timebase, no_of_samples, oversample, time_units, time_interval, dt, nb_of_samples_in_screen );
+
+    while ( sem_trywait(&thread_stop) )
+    {
+        /* Start it collecting,
+        *  then wait for completion
+        */
+        TRAITS::run_block ( driver()->unitOpened_m.handle, no_of_samples, driver()->timebase, oversample, &time_indisposed_ms );
+        while ( !TRAITS::ready ( driver()->unitOpened_m.handle ) )
+        {
+            if( !sem_trywait(&thread_stop) )
+            {
+                /* re-post semaphore to exit the main loop */
+                sem_post(&thread_stop);
+                break;
+            }
+            Sleep ( BLOCK_READY_POLL_MS );
+        }
+
+        TRAITS::stop ( driver()->unitOpened_m.handle );
+
+        /* Should be done now...
+        *  get the values (in ADC counts)
+        */
+        no_of_values = TRAITS::get_values ( driver()->unitOpened_m.handle,
+                                            driver()->unitOpened_m.channelSettings[0].values,
+                                            driver()->unitOpened_m.channelSettings[1].values,
+                                            driver()->unitOpened_m.channelSettings[2].values,
+                                            driver()->unitOpened_m.channelSettings[3].values,
+                                            &overflow, no_of_samples );
+
+        DEBUG ( "%ld values, overflow %d\n", no_of_values, overflow );
+
+        if ( no_of_values > 0 )
+        {
+            n = nb_of_samples_in_screen - index;
+            if ( n > no_of_values )
+                n = no_of_values;
+            /* captures are not contiguous in time: filter and decode each one from a cleared state */
+            filter_start ( dt );
+            /* the FIR draws each sample late by its group delay: traces are moved back by as much */
+            delay = filter_delay () * dt;
+            decode_start ( index * dt, 0 == index );
+            for (ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                raw[ch] = (channels & (1 << ch)) ? driver()->unitOpened_m.channelSettings[ch].values : NULL;
+                if (channels & (1 << ch))
+                {
+                    filter_samples ( ch, driver()->unitOpened_m.channelSettings[ch].values, screen[ch] + index, n );
+                    averaged[ch] = average_samples ( ch, screen[ch] + index, index, n, &interleaved );
+                }
+            }
+            decode_samples ( raw, scale, n, dt );
+            /* trigger point sits after the pre-trigger part of the last capture */
+            frame.trigger_time = triggered ? (index - (driver()->unitOpened_m.trigger.simple.delay * no_of_values) / 100.) * dt : 0.;
+            /* shift the time origin so the exact crossing, not the nearest sample, sits on the trigger time.
+             * One block has one origin: it follows the capture opening the screen, captures appended
+             * after it on slow timebases are not moved by their own crossing */
+            if ( 0 == index )
+            {
+                trigger_channel = (short) driver()->unitOpened_m.trigger.simple.channel;
+                shift = 0.;
+                if ( triggered && (channels & (1 << trigger_channel)) )
+                {
+                    shift = -trigger_offset ( driver()->unitOpened_m.channelSettings[trigger_channel].values, n,
+                                              (long)(-driver()->unitOpened_m.trigger.simple.delay * no_of_values / 100.) ) * dt;
+                }
+            }
+            index += n;
+            /* draw the average when enabled, an envelope as max/min pairs at half the interval */
+            for (ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                frame.blocks[ch].raw = averaged[ch] ? averaged[ch] : screen[ch];
+                frame.blocks[ch].t0 = shift - delay;
+                frame.blocks[ch].count = (averaged[ch] && interleaved) ? 2 * index : index;
+                /* a filling screen only appends the new capture, averages change as a whole */
+                frame.blocks[ch].stable = averaged[ch] ? 0 : index - n;
+                frame.blocks[ch].dt = (averaged[ch] && interleaved) ? dt / 2. : dt;
+            }
+            // resetting all available data as long as the screen is not filled.
+            draw_frame ( &frame );
+            /* the mask tests each capture, not its average, on the unshifted time base
+             * its limits were computed for */
+            for (ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                frame.blocks[ch].raw = screen[ch];
+                frame.blocks[ch].t0 = 0.;
+                frame.blocks[ch].count = index;
+                frame.blocks[ch].dt = dt;
+            }
+            /* a screen failing in any of its captures is kept as failed */
+            if ( 1 == mask_test ( &frame, index - n, n ) )
+                failed = true;
+            analyze ( &frame, index - n, n );
+            if( (index >= nb_of_samples_in_screen) || (index * dt > 5 * driver()->time_per_division_m) )
+            {
+                /* the screen is complete: it is kept once, with its own counts rather than
+                 * their average, at the time base it was drawn with */
+                for (ch = 0; ch < MAX_CHANNELS; ch++)
+                {
+                    frame.blocks[ch].t0 = shift - delay;
+                }
+                evaluate_math ( &frame );
+                history_store ( &frame, failed );
+                failed = false;
+                index = 0;
+            }
+        }
+    }
+    for (ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        free(screen[ch]);
+    }
+}
+
+/****************************************************************************
+ * collect_streaming
+ *
+ * roll mode: streamed samples are appended to the channel histories and the
+ * newest screen is drawn, scrolling to the left.
+ ****************************************************************************/
+template <class DRIVER, class TRAITS>
+void AcquisitionPipeline<DRIVER, TRAITS>::collect_streaming (void)
+{
+    long no_of_values;
+    short overflow;
+    short ok;
+    short ch;
+    uint8_t channels = 0;
+    const short* raw[MAX_CHANNELS] = {NULL};
+    /* 100 points per division, the driver takes whole milliseconds:
+     * faster timebases roll at 1 ms per sample */
+    short interval_ms = (short)(driver()->time_per_division_m * 1000. / 100.);
+    double sample_interval = 0.;
+    DEBUG ( "Collect streaming...\n" );
+
+    if ( interval_ms < 1 )
+        interval_ms = 1;
+    sample_interval = interval_ms * 1e-3;
+
+    if ( 0 != reserve_streaming_buffers ( ROLL_SAMPLES_IN_SCREEN ) )
+        return;
+
+    driver()->set_defaults ();
+
+    channels = channel_scales (live_scale_m);
+    if ( 0 != roll_setup ( channels, sample_interval ) )
+        return;
+
+    /* You cannot use triggering for the start of the data...
+    */
+    TRAITS::set_trigger ( driver()->unitOpened_m.handle, TRAITS::NONE, 0, 0, 0, 0 );
+
+    /* Collect data at time_per_division_m / 100  intervals
+    * Max BUFFER_SIZE points on each call
+    *  (buffer must be big enough for max time between calls
+    */
+    ok = TRAITS::run_streaming ( driver()->unitOpened_m.handle, interval_ms, 1000, 0 );
+    DEBUG ( "OK: %d\n", ok );
+    if ( 0 == ok )
+    {
+        ERROR ( "cannot stream at %hd ms per sample\n", interval_ms );
+        return;
+    }
+
+    while ( sem_trywait(&thread_stop) )
+    {
+        no_of_values = TRAITS::get_values ( driver()->unitOpened_m.handle,
+                                            driver()->unitOpened_m.channelSettings[0].values,
+                                            driver()->unitOpened_m.channelSettings[1].values,
+                                            driver()->unitOpened_m.channelSettings[2].values,
+                                            driver()->unitOpened_m.channelSettings[3].values,
+                                            &overflow,
+                                            BUFFER_SIZE );
+
+        if ( no_of_values > 0 )
+        {
+            /* roll: new samples are appended, the screen scrolls to the left */
+            for (ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                raw[ch] = (channels & (1 << ch)) ? driver()->unitOpened_m.channelSettings[ch].values : NULL;
+                roll_append ( ch, driver()->unitOpened_m.channelSettings[ch].values, no_of_values );
+            }
+            decode_samples ( raw, live_scale_m, no_of_values, sample_interval );
+            roll_draw ();
+        }
+        Sleep(100);
+    }
+
+    TRAITS::stop ( driver()->unitOpened_m.handle );
+}
+
+#endif // ACQUISITIONPIPELINE_H
@@ -0,0 +1,208 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file analysisview.cpp
+ * @brief Definition of AnalysisView class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <math.h>
+
+#include <QColor>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPolygonF>
+
+#include "analysisview.h"
+
+/* height of the text line under the plots */
+#define ANALYSIS_VIEW_TEXT_HEIGHT 16
+
+AnalysisView::AnalysisView(QWidget *parent)
+    : QWidget(parent)
+{
+    result_m.mode = E_ANALYSIS_NONE;
+    result_m.bins = 0;
+    result_m.columns = 0;
+    result_m.folded = 0;
+    result_m.symbol_period = 0.;
+    // empty bins are black, counts go from blue to red on a log scale
+    colors_m.append(qRgb(0, 0, 0));
+    for(int i = 1; i < 256; i++)
+    {
+        colors_m.append(QColor::fromHsv(240 - (240 * i) / 255, 255, 96 + (159 * i) / 255).rgb());
+    }
+    setMinimumHeight(160);
+}
+
+AnalysisView::~AnalysisView()
+{
+}
+
+void AnalysisView::setResult(const analysis_result_t &result)
+{
+    result_m = result;
+    update();
+}
+
+double AnalysisView::binVolts(uint32_t bin, uint8_t channel) const
+{
+    return ((double)(bin << result_m.shift) + (double)(1 << result_m.shift) / 2. - 32768.) * result_m.scale[channel];
+}
+
+bool AnalysisView::occupiedBins(uint32_t *low, uint32_t *high) const
+{
+    bool found = false;
+
+    *low = result_m.bins;
+    *high = 0;
+    for(uint8_t ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        for(uint32_t bin = 0; bin < result_m.histograms[ch].size(); bin++)
+        {
+            if(0 != result_m.histograms[ch][bin])
+            {
+                *low = (bin < *low) ? bin : *low;
+                *high = (bin > *high) ? bin : *high;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+void AnalysisView::drawHistograms(QPainter *painter, const QRect &area, uint32_t low, uint32_t high)
+{
+    static const Qt::GlobalColor colors[MAX_CHANNELS] = {Qt::green, Qt::red, Qt::magenta, Qt::yellow};
+    const double step = (double)area.height() / (high - low + 1);
+
+    // amplitude goes up as on the screen, counts go right on a log scale
+    for(uint8_t ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        const std::vector<uint32_t> &histogram = result_m.histograms[ch];
+        uint32_t max = 0;
+
+        if(0 == result_m.samples[ch])
+        {
+            continue;
+        }
+        for(uint32_t bin = low; bin <= high; bin++)
+        {
+            max = (histogram[bin] > max) ? histogram[bin] : max;
+        }
+        QPolygonF line;
+        for(uint32_t bin = low; bin <= high; bin++)
+        {
+            line << QPointF(area.left() + area.width() * log(histogram[bin] + 1.) / log(max + 1.),
+                            area.bottom() - (bin - low + 0.5) * step);
+        }
+        painter->setPen(colors[ch]);
+        painter->drawPolyline(line);
+    }
+}
+
+void AnalysisView::drawEye(QPainter *painter, const QRect &area, uint32_t low, uint32_t high)
+{
+    const uint32_t columns = result_m.columns;
+    const int rows = high - low + 1;
+    uint32_t max = 0;
+
+    if((0 == columns) || (result_m.eye.size() < result_m.bins * columns))
+    {
+        return;
+    }
+    for(uint32_t i = low * columns; i < (high + 1) * columns; i++)
+    {
+        max = (result_m.eye[i] > max) ? result_m.eye[i] : max;
+    }
+    if((eye_m.width() != (int)columns) || (eye_m.height() != rows))
+    {
+        eye_m = QImage(columns, rows, QImage::Format_Indexed8);
+        eye_m.setColorTable(colors_m);
+    }
+    // bin low is the bottom row
+    for(int row = 0; row < rows; row++)
+    {
+        const uint32_t *counts = &result_m.eye[(high - row) * columns];
+        uchar *pixels = eye_m.scanLine(row);
+        for(uint32_t column = 0; column < columns; column++)
+        {
+            pixels[column] = (0 == counts[column]) ? 0 : (uchar)(1 + 254 * log((double)counts[column]) / log(max + 1.));
+        }
+    }
+    painter->drawImage(area, eye_m);
+}
+
+void AnalysisView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    QRect plots = rect().adjusted(2, 2, -2, -ANALYSIS_VIEW_TEXT_HEIGHT);
+    QRect text = rect().adjusted(2, rect().height() - ANALYSIS_VIEW_TEXT_HEIGHT, -2, 0);
+    QString summary;
+    uint32_t low = 0;
+    uint32_t high = 0;
+    uint8_t axis = result_m.channel;
+
+    (void)event;
+    painter.fillRect(rect(), Qt::black);
+    painter.setPen(Qt::white);
+    if((E_ANALYSIS_NONE == result_m.mode) || !occupiedBins(&low, &high))
+    {
+        painter.drawText(rect(), Qt::AlignCenter, tr("No samples"));
+        return;
+    }
+    if(E_ANALYSIS_EYE == result_m.mode)
+    {
+        // histograms on the left share the eye amplitude axis
+        QRect histograms(plots.left(), plots.top(), plots.width() / 4, plots.height());
+        drawHistograms(&painter, histograms, low, high);
+        drawEye(&painter, plots.adjusted(plots.width() / 4 + 4, 0, 0, 0), low, high);
+        if(result_m.symbol_period > 0.)
+        {
+            summary = tr("Eye CH %1: symbol %2 s, %3 samples").arg(QChar('A' + result_m.channel))
+                      .arg(result_m.symbol_period, 0, 'g', 4).arg((qulonglong)result_m.folded);
+        }
+        else
+        {
+            summary = tr("Eye CH %1: recovering the symbol period").arg(QChar('A' + result_m.channel));
+        }
+    }
+    else
+    {
+        drawHistograms(&painter, plots, low, high);
+        for(uint8_t ch = 0; ch < MAX_CHANNELS; ch++)
+        {
+            if(0 != result_m.samples[ch])
+            {
+                summary += tr("CH %1: %2 samples  ").arg(QChar('A' + ch)).arg((qulonglong)result_m.samples[ch]);
+            }
+        }
+    }
+    // amplitude axis in volts of the eye channel, else of the first channel with samples
+    for(uint8_t ch = 0; (0 == result_m.samples[axis]) && (ch < MAX_CHANNELS); ch++)
+    {
+        axis = ch;
+    }
+    painter.setPen(Qt::white);
+    painter.drawText(plots, Qt::AlignLeft | Qt::AlignTop, QString("%1 V").arg(binVolts(high, axis), 0, 'g', 3));
+    painter.drawText(plots, Qt::AlignLeft | Qt::AlignBottom, QString("%1 V").arg(binVolts(low, axis), 0, 'g', 3));
+    painter.drawText(text, Qt::AlignLeft | Qt::AlignVCenter, summary);
+}
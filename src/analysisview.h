@@ -0,0 +1,78 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file analysisview.h
+ * @brief Declaration of AnalysisView class.
+ * Amplitude histograms of the channels and eye diagram heat map, drawn
+ * from a copy of the acquisition accumulators.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef ANALYSISVIEW_H
+#define ANALYSISVIEW_H
+
+#include <QImage>
+#include <QWidget>
+
+#include "signalanalyzer.h"
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+class QPaintEvent;
+QT_END_NAMESPACE
+
+class AnalysisView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief constructor
+     * @param[in] parent widget pointer
+     */
+    AnalysisView(QWidget *parent = 0);
+    /**
+     * @brief destructor
+     */
+    virtual ~AnalysisView();
+    /**
+     * @brief show new accumulators
+     * @param[in] copy of the acquisition accumulators
+     */
+    void setResult(const analysis_result_t &result);
+
+protected:
+    virtual void paintEvent(QPaintEvent *event);
+
+private:
+    /** @brief lowest and highest amplitude bins holding samples, false if there are none */
+    bool occupiedBins(uint32_t *low, uint32_t *high) const;
+    void drawHistograms(QPainter *painter, const QRect &area, uint32_t low, uint32_t high);
+    void drawEye(QPainter *painter, const QRect &area, uint32_t low, uint32_t high);
+    /** @brief volts at the middle of an amplitude bin */
+    double binVolts(uint32_t bin, uint8_t channel) const;
+    analysis_result_t result_m;
+    /* heat map, one pixel per column and per occupied bin */
+    QImage eye_m;
+    QVector<QRgb> colors_m;
+};
+
+#endif // ANALYSISVIEW_H
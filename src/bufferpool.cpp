@@ -0,0 +1,223 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file bufferpool.cpp
+ * @brief Definition of BufferPool class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "bufferpool.h"
+
+/****************************************************************************
+ *
+ * constructor
+ *
+ ****************************************************************************/
+BufferPool::BufferPool() :
+    area_m(NULL),
+    area_size_m(0),
+    capacity_m(0),
+    flags_m(0),
+    locked_m(false)
+{
+    memset(raw_m, 0, sizeof(raw_m));
+    memset(screen_m, 0, sizeof(screen_m));
+}
+
+/****************************************************************************
+ *
+ * destructor
+ *
+ ****************************************************************************/
+BufferPool::~BufferPool()
+{
+    release();
+}
+
+/****************************************************************************
+ * align - round a size up to the next multiple of a power of two unit
+ ****************************************************************************/
+size_t BufferPool::align(size_t bytes, size_t unit)
+{
+    return (bytes + unit - 1) & ~(unit - 1);
+}
+
+/****************************************************************************
+ * huge_page_size - default huge page size of the system
+ ****************************************************************************/
+size_t BufferPool::huge_page_size(void)
+{
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    char line[128];
+    unsigned long kb = 0;
+
+    if(NULL != meminfo)
+    {
+        while((0 == kb) && (NULL != fgets(line, sizeof(line), meminfo)))
+        {
+            if(1 != sscanf(line, "Hugepagesize: %lu kB", &kb))
+            {
+                kb = 0;
+            }
+        }
+        fclose(meminfo);
+    }
+    /* 2 MiB on most systems */
+    return (0 != kb) ? (size_t)kb * 1024 : (size_t)2 * 1024 * 1024;
+}
+
+/****************************************************************************
+ * reserve - (re)build the pool if it is too small
+ ****************************************************************************/
+int8_t BufferPool::reserve(uint32_t nb_samples, uint8_t flags)
+{
+    size_t raw_size = align(nb_samples * sizeof(short), (size_t)sysconf(_SC_PAGESIZE));
+    size_t size = 2 * MAX_CHANNELS * raw_size;
+    size_t huge_size = 0;
+    void* area = MAP_FAILED;
+    uint8_t* cursor = NULL;
+    uint8_t ch = 0;
+    int populate = 0;
+
+    if((NULL != area_m) && (nb_samples <= capacity_m) && (flags == flags_m))
+    {
+        return 0;
+    }
+
+    release();
+
+    if(0 == nb_samples)
+    {
+        return 0;
+    }
+
+#ifdef MAP_POPULATE
+    /* pages are faulted in now, not by the capture loop */
+    populate = MAP_POPULATE;
+#endif
+
+#ifdef MAP_HUGETLB
+    if(flags & BUFFER_POOL_HUGE_PAGES)
+    {
+        /* hugetlb mappings are mapped, locked and unmapped in whole huge pages */
+        huge_size = align(size, huge_page_size());
+        area = mmap(NULL, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+        if(MAP_FAILED == area)
+        {
+            DEBUG("no huge pages available, falling back to regular pages\n");
+        }
+        else
+        {
+            size = huge_size;
+        }
+    }
+#endif
+    if(MAP_FAILED == area)
+    {
+        area = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+        if(MAP_FAILED == area)
+        {
+            ERROR("cannot map %lu bytes for %u samples\n", (unsigned long)size, nb_samples);
+            return -1;
+        }
+#ifdef MADV_HUGEPAGE
+        if(flags & BUFFER_POOL_HUGE_PAGES)
+        {
+            madvise(area, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    if(flags & BUFFER_POOL_MLOCK)
+    {
+        if(0 == mlock(area, size))
+        {
+            locked_m = true;
+        }
+        else
+        {
+            WARNING("mlock of %lu bytes failed, buffers stay pageable\n", (unsigned long)size);
+        }
+    }
+
+    area_m = (uint8_t*)area;
+    area_size_m = size;
+    capacity_m = nb_samples;
+    flags_m = flags;
+
+    cursor = area_m;
+    for(ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        raw_m[ch] = (short*)cursor;
+        cursor += raw_size;
+    }
+    for(ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        screen_m[ch] = (short*)cursor;
+        cursor += raw_size;
+    }
+
+    DEBUG("buffer pool holds %u samples per channel (%lu bytes)\n", capacity_m, (unsigned long)area_size_m);
+    return 0;
+}
+
+/****************************************************************************
+ * release - unmap the pool
+ ****************************************************************************/
+void BufferPool::release(void)
+{
+    if(NULL != area_m)
+    {
+        if(locked_m && (0 != munlock(area_m, area_size_m)))
+        {
+            WARNING("munlock of %lu bytes failed\n", (unsigned long)area_size_m);
+        }
+        if(0 != munmap(area_m, area_size_m))
+        {
+            ERROR("cannot unmap %lu bytes of the buffer pool\n", (unsigned long)area_size_m);
+        }
+    }
+    area_m = NULL;
+    area_size_m = 0;
+    capacity_m = 0;
+    flags_m = 0;
+    locked_m = false;
+    memset(raw_m, 0, sizeof(raw_m));
+    memset(screen_m, 0, sizeof(screen_m));
+}
+
+/****************************************************************************
+ * buffers accessors
+ ****************************************************************************/
+short* BufferPool::raw(uint8_t channel) const
+{
+    return (channel < MAX_CHANNELS) ? raw_m[channel] : NULL;
+}
+
+short* BufferPool::screen(uint8_t channel) const
+{
+    return (channel < MAX_CHANNELS) ? screen_m[channel] : NULL;
+}
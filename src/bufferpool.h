@@ -0,0 +1,105 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file bufferpool.h
+ * @brief Declaration of BufferPool class.
+ * BufferPool holds the page aligned sample buffers used by streaming modes.
+ * Buffers are kept between runs and only reallocated when they need to grow.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <stddef.h>
+
+#include "oscilloscope.h"
+
+/** @brief lock pool pages in RAM (mlock) */
+#define BUFFER_POOL_MLOCK       0x01
+/** @brief try to back the pool with huge pages */
+#define BUFFER_POOL_HUGE_PAGES  0x02
+
+class BufferPool
+{
+public:
+    /**
+     * @brief constructor, nothing is allocated until reserve() is called
+     */
+    BufferPool();
+    /**
+     * @brief destructor, releases the pool memory
+     */
+    ~BufferPool();
+    /**
+     * @brief make sure the pool can hold nb_samples samples per channel.
+     * Memory is only reallocated when the pool has to grow or when flags change.
+     * @param[in] nb_samples : number of samples per channel
+     * @param[in] flags : combination of BUFFER_POOL_MLOCK and BUFFER_POOL_HUGE_PAGES
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t reserve(uint32_t nb_samples, uint8_t flags = 0);
+    /**
+     * @brief give the pool memory back to the system
+     */
+    void release(void);
+    /**
+     * @brief get raw ADC counts buffer of a channel
+     * @param[in] channel : channel index (0 for channel A, 1 for channel B, etc)
+     * @return buffer of capacity() shorts, NULL if nothing is reserved
+     */
+    short* raw(uint8_t channel) const;
+    /**
+     * @brief get screen ADC counts buffer of a channel, where the drawn
+     * frame is built while raw() holds the streaming record
+     * @param[in] channel : channel index (0 for channel A, 1 for channel B, etc)
+     * @return buffer of capacity() shorts, NULL if nothing is reserved
+     */
+    short* screen(uint8_t channel) const;
+    /**
+     * @brief get number of samples per channel the pool can hold
+     */
+    uint32_t capacity(void) const { return capacity_m; }
+    /**
+     * @brief tell if the pool memory is locked in RAM
+     */
+    bool locked(void) const { return locked_m; }
+
+private:
+    /* not copyable */
+    BufferPool(const BufferPool&);
+    BufferPool& operator=(const BufferPool&);
+
+    static size_t align(size_t bytes, size_t unit);
+    static size_t huge_page_size(void);
+
+    /** @brief start of the mapping, all buffers are carved into it */
+    uint8_t* area_m;
+    /** @brief mapped length, a multiple of the huge page size for MAP_HUGETLB mappings */
+    size_t area_size_m;
+    uint32_t capacity_m;
+    uint8_t flags_m;
+    bool locked_m;
+    short* raw_m[MAX_CHANNELS];
+    short* screen_m[MAX_CHANNELS];
+};
+
+#endif // BUFFERPOOL_H
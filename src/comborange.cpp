@@ -89,6 +89,16 @@ void ComboRange::setValues(const QStringList &list)
     combo->addItems(list);
 }
 
+QString ComboRange::currentValueText() const
+{
+    return combo->currentText();
+}
+
+int ComboRange::findValue(const QString &text) const
+{
+    return combo->findText(text);
+}
+
 void ComboRange::setText(const QString &text)
 {
     label->setText(text);
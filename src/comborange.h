@@ -82,6 +82,17 @@ public:
      * @param[in]: A list of string that should be inserted within the ComboBox
      */
     void setValues(const QStringList & list);
+    /**
+     * @brief get ComboBox current text
+     * @return text of the current item
+     */
+    QString currentValueText() const;
+    /**
+     * @brief find the ComboBox item with a text
+     * @param[in]: text of the item
+     * @return item index, -1 if no item has this text
+     */
+    int findValue(const QString & text) const;
 
 public slots:
     /**
@@ -0,0 +1,92 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file decoderview.cpp
+ * @brief Definition of DecoderView class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <QLineEdit>
+#include <QStringList>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "decoderview.h"
+#include "screen.h"
+
+DecoderView::DecoderView(Screen *screen, QWidget *parent)
+    : QWidget(parent),
+      screen_m(screen),
+      sequence_m(0)
+{
+    search_m = new QLineEdit;
+    search_m->setPlaceholderText(tr("Search events"));
+    connect(search_m, SIGNAL(textChanged(const QString &)), this, SLOT(search(const QString &)));
+
+    table_m = new QTableWidget(0, 2);
+    table_m->setHorizontalHeaderLabels(QStringList() << tr("Time (s)") << tr("Event"));
+    table_m->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_m->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(search_m);
+    layout->addWidget(table_m);
+    setLayout(layout);
+
+    // events come from the acquisition thread: the table polls the screen
+    timer_m = new QTimer(this);
+    connect(timer_m, SIGNAL(timeout()), this, SLOT(refresh()));
+    timer_m->start(DECODER_VIEW_REFRESH_MS);
+}
+
+DecoderView::~DecoderView()
+{
+    timer_m->stop();
+}
+
+void DecoderView::refresh()
+{
+    char text[32];
+    uint32_t sequence = screen_m->copyEvents(events_m);
+
+    if(sequence == sequence_m)
+    {
+        return;
+    }
+    sequence_m = sequence;
+    table_m->setRowCount(events_m.size());
+    for(uint32_t i = 0; i < events_m.size(); i++)
+    {
+        decoder_event_text(&events_m[i], text, sizeof(text));
+        table_m->setItem(i, 0, new QTableWidgetItem(QString::number(events_m[i].time, 'g', 9)));
+        table_m->setItem(i, 1, new QTableWidgetItem(text));
+    }
+    search(search_m->text());
+}
+
+void DecoderView::search(const QString &text)
+{
+    for(int row = 0; row < table_m->rowCount(); row++)
+    {
+        table_m->setRowHidden(row, !text.isEmpty() && !table_m->item(row, 1)->text().contains(text, Qt::CaseInsensitive));
+    }
+}
@@ -0,0 +1,78 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file decoderview.h
+ * @brief Declaration of DecoderView class.
+ * Table of decoded protocol events shown on the screen, filtered by a
+ * search text.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef DECODERVIEW_H
+#define DECODERVIEW_H
+
+#include <vector>
+
+#include <QWidget>
+
+#include "protocoldecoder.h"
+
+/* the table is refreshed at most at this period */
+#define DECODER_VIEW_REFRESH_MS 500
+
+QT_BEGIN_NAMESPACE
+class QLineEdit;
+class QTableWidget;
+class QTimer;
+QT_END_NAMESPACE
+
+class Screen;
+
+class DecoderView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief constructor
+     * @param[in] screen whose annotated events are listed
+     * @param[in] parent widget pointer
+     */
+    DecoderView(Screen *screen, QWidget *parent = 0);
+    /**
+     * @brief destructor
+     */
+    virtual ~DecoderView();
+
+private slots:
+    void refresh();
+    void search(const QString &text);
+
+private:
+    Screen *screen_m;
+    QLineEdit *search_m;
+    QTableWidget *table_m;
+    QTimer *timer_m;
+    std::vector<decoder_event_t> events_m;
+    uint32_t sequence_m;
+};
+
+#endif // DECODERVIEW_H
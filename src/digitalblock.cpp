@@ -0,0 +1,223 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file digitalblock.cpp
+ * @brief Definition of DigitalBlock class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "digitalblock.h"
+
+/****************************************************************************
+ * DigitalBlock
+ ****************************************************************************/
+DigitalBlock::DigitalBlock() :
+    words_m(NULL),
+    words_per_line_m(0),
+    count_m(0),
+    lines_m(0),
+    t0_m(0.),
+    dt_m(0.)
+{
+}
+
+/****************************************************************************
+ * ~DigitalBlock
+ ****************************************************************************/
+DigitalBlock::~DigitalBlock()
+{
+    if(NULL != words_m)
+    {
+        free(words_m);
+    }
+}
+
+/****************************************************************************
+ * allocate
+ ****************************************************************************/
+int8_t DigitalBlock::allocate(uint32_t nb_samples)
+{
+    uint32_t words = (nb_samples + DIGITAL_WORD_BITS - 1) / DIGITAL_WORD_BITS;
+
+    if(words <= words_per_line_m)
+    {
+        return 0;
+    }
+    if(NULL != words_m)
+    {
+        free(words_m);
+    }
+    count_m = 0;
+    words_per_line_m = 0;
+    words_m = (uint16_t *)malloc(DIGITAL_LINES * words * sizeof(uint16_t));
+    if(NULL == words_m)
+    {
+        ERROR("unable to allocate %u digital samples\n", nb_samples);
+        return -1;
+    }
+    words_per_line_m = words;
+    return 0;
+}
+
+/****************************************************************************
+ * pack ports - transpose sample major port words into line major bits
+ ****************************************************************************/
+int8_t DigitalBlock::pack_ports(const short *port0, const short *port1, uint32_t nb_samples, double t0, double dt)
+{
+    uint16_t packed[DIGITAL_LINES];
+    uint16_t value = 0;
+    uint32_t i = 0;
+    uint32_t word = 0;
+    uint8_t bit = 0;
+    uint8_t line = 0;
+
+    if((NULL == port0) || (0 != allocate(nb_samples)))
+    {
+        return -1;
+    }
+    for(i = 0; i < nb_samples; i += DIGITAL_WORD_BITS)
+    {
+        memset(packed, 0, sizeof(packed));
+        for(bit = 0; (bit < DIGITAL_WORD_BITS) && (i + bit < nb_samples); bit++)
+        {
+            value = (uint16_t)(port0[i + bit] & 0xFF);
+            if(NULL != port1)
+            {
+                value |= (uint16_t)((port1[i + bit] & 0xFF) << 8);
+            }
+            for(line = 0; line < DIGITAL_LINES; line++)
+            {
+                packed[line] |= (uint16_t)(((value >> line) & 1) << bit);
+            }
+        }
+        word = i / DIGITAL_WORD_BITS;
+        for(line = 0; line < DIGITAL_LINES; line++)
+        {
+            words_m[line * words_per_line_m + word] = packed[line];
+        }
+    }
+    count_m = nb_samples;
+    lines_m = (NULL != port1) ? 0xFFFF : 0x00FF;
+    t0_m = t0;
+    dt_m = dt;
+    return 0;
+}
+
+/****************************************************************************
+ * copy
+ ****************************************************************************/
+int8_t DigitalBlock::copy(const DigitalBlock &other)
+{
+    uint32_t words = (other.count_m + DIGITAL_WORD_BITS - 1) / DIGITAL_WORD_BITS;
+    uint8_t line = 0;
+
+    if(0 != allocate(other.count_m))
+    {
+        return -1;
+    }
+    for(line = 0; line < DIGITAL_LINES; line++)
+    {
+        memcpy(words_m + line * words_per_line_m, other.words_m + line * other.words_per_line_m, words * sizeof(uint16_t));
+    }
+    count_m = other.count_m;
+    lines_m = other.lines_m;
+    t0_m = other.t0_m;
+    dt_m = other.dt_m;
+    return 0;
+}
+
+/****************************************************************************
+ * level
+ ****************************************************************************/
+uint8_t DigitalBlock::level(uint8_t line, uint32_t index) const
+{
+    return (words_m[line * words_per_line_m + index / DIGITAL_WORD_BITS] >> (index % DIGITAL_WORD_BITS)) & 1;
+}
+
+/****************************************************************************
+ * next transition
+ ****************************************************************************/
+uint32_t DigitalBlock::next_transition(uint8_t line, uint32_t from) const
+{
+    const uint16_t *words = words_m + line * words_per_line_m;
+    uint32_t w = from / DIGITAL_WORD_BITS;
+    uint32_t last = (count_m + DIGITAL_WORD_BITS - 1) / DIGITAL_WORD_BITS;
+    uint32_t index = 0;
+    /* all ones when the level at from is high */
+    uint16_t run = level(line, from) ? 0xFFFF : 0;
+    uint16_t diff = 0;
+
+    diff = (uint16_t)((words[w] ^ run) & (0xFFFF << (from % DIGITAL_WORD_BITS)));
+    while(0 == diff)
+    {
+        if(++w >= last)
+        {
+            return count_m;
+        }
+        diff = words[w] ^ run;
+    }
+    index = w * DIGITAL_WORD_BITS;
+    while(!(diff & 1))
+    {
+        diff >>= 1;
+        index++;
+    }
+    return (index < count_m) ? index : count_m;
+}
+
+/****************************************************************************
+ * span state
+ ****************************************************************************/
+digital_state_e DigitalBlock::span_state(uint8_t line, uint32_t from, uint32_t to) const
+{
+    const uint16_t *words = words_m + line * words_per_line_m;
+    uint32_t first = from / DIGITAL_WORD_BITS;
+    uint32_t last = (to - 1) / DIGITAL_WORD_BITS;
+    uint32_t w = 0;
+    uint16_t mask = 0;
+    uint16_t bits = 0;
+    uint16_t ones = 0;
+    uint16_t zeros = 0;
+
+    for(w = first; w <= last; w++)
+    {
+        mask = 0xFFFF;
+        if(w == first)
+        {
+            mask &= (uint16_t)(0xFFFF << (from % DIGITAL_WORD_BITS));
+        }
+        if(w == last)
+        {
+            mask &= (uint16_t)(0xFFFF >> (DIGITAL_WORD_BITS - 1 - ((to - 1) % DIGITAL_WORD_BITS)));
+        }
+        bits = words[w] & mask;
+        ones |= bits;
+        zeros |= (uint16_t)(~words[w] & mask);
+        if(ones && zeros)
+        {
+            return E_DIGITAL_TOGGLING;
+        }
+    }
+    return ones ? E_DIGITAL_HIGH : E_DIGITAL_LOW;
+}
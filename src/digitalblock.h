@@ -0,0 +1,111 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file digitalblock.h
+ * @brief Declaration of DigitalBlock class.
+ * Logic lines of mixed signal captures are stored bit-packed, one bit per
+ * sample and per line, 16 samples per word.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef DIGITALBLOCK_H
+#define DIGITALBLOCK_H
+
+#include <stddef.h>
+
+#include "oscilloscope.h"
+
+/* two 8 bits digital ports */
+#define DIGITAL_LINES       16
+#define DIGITAL_WORD_BITS   16
+
+typedef enum
+{
+    E_DIGITAL_LOW = 0,
+    E_DIGITAL_HIGH,
+    E_DIGITAL_TOGGLING
+}digital_state_e;
+
+class DigitalBlock
+{
+public:
+    DigitalBlock();
+    ~DigitalBlock();
+    /**
+     * @brief reserve storage, content is lost when it grows
+     * @param[in] : number of samples per line
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t allocate(uint32_t nb_samples);
+    /**
+     * @brief replace content with driver port buffers, one sample per element,
+     * port 0 holds lines 0 to 7 and port 1 lines 8 to 15 in their low byte
+     * @param[in] : digital port 0 samples
+     * @param[in] : digital port 1 samples, NULL when the port is not captured
+     * @param[in] : number of samples
+     * @param[in] : time of the first sample, in seconds
+     * @param[in] : sample interval, in seconds
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t pack_ports(const short *port0, const short *port1, uint32_t nb_samples, double t0, double dt);
+    /**
+     * @brief copy another block, storage is reused when large enough
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t copy(const DigitalBlock &other);
+    /**
+     * @brief level of a line at a sample
+     * return : 0 or 1
+     */
+    uint8_t level(uint8_t line, uint32_t index) const;
+    /**
+     * @brief state of a line over samples [from, to), tested a word at a time
+     * @param[in] : line index, 0 to DIGITAL_LINES - 1
+     * @param[in] : first sample
+     * @param[in] : end sample, excluded, greater than first sample
+     */
+    digital_state_e span_state(uint8_t line, uint32_t from, uint32_t to) const;
+    /**
+     * @brief find the next level change of a line, runs of identical samples
+     * are skipped a word at a time
+     * @param[in] : line index, 0 to DIGITAL_LINES - 1
+     * @param[in] : sample to start from
+     * return : index of the first sample after from with another level, count() if none
+     */
+    uint32_t next_transition(uint8_t line, uint32_t from) const;
+    uint32_t count() const { return count_m; }
+    double t0() const { return t0_m; }
+    double dt() const { return dt_m; }
+    /** @brief bit mask of captured lines */
+    uint16_t lines() const { return lines_m; }
+private:
+    DigitalBlock(const DigitalBlock &);
+    DigitalBlock &operator=(const DigitalBlock &);
+    /* line major storage: words of line l start at l * words_per_line_m */
+    uint16_t *words_m;
+    uint32_t words_per_line_m;
+    uint32_t count_m;
+    uint16_t lines_m;
+    double t0_m;
+    double dt_m;
+};
+
+#endif // DIGITALBLOCK_H
@@ -29,20 +29,38 @@
 #define DRAWDATA_H
 
 #include "oscilloscope.h"
+#include "sampleblock.h"
+#include "protocoldecoder.h"
 
 class DrawData
 {
 
 public:
     /**
-     * @brief: set data to draw
+     * @brief: set a sample block to draw, raw counts with a uniform time base
      * @param[in] channel_id: when getting multiple channels, a.k.a multiple curves, id between curves must be different
-     * @param[in] x_data table of X-axis. Table has nb_points elements. Table will be copied.
-     * @param[in] y_data table of Y-axis. Table has nb_points elements. Table will be copied.
-     * @param[in] nb_points is the table size.
+     * @param[in] block: sample block. Counts will be copied, no conversion to double is made.
      * return : 0 if successful, -1 in case of error
      */
-    virtual int8_t setData(uint8_t channel_id, double *x_data, double *y_data, uint32_t nb_points) = 0;
+    virtual int8_t setBlock(uint8_t channel_id, const sample_block_t *block) = 0;
+    /**
+     * @brief: set all channels of one capture at once, they are displayed together
+     * @param[in] frame: sample frame. Counts will be copied.
+     * return : 0 if successful, -1 in case of error
+     */
+    virtual int8_t setFrame(const sample_frame_t *frame) = 0;
+    /**
+     * @brief: announce the largest block of the coming frames, from the thread calling setFrame
+     * @param[in] nb_samples: number of samples per channel
+     */
+    virtual void reserveFrame(uint32_t nb_samples) = 0;
+    /**
+     * @brief: set decoded protocol events to annotate
+     * @param[in] events: events in the displayed time base, sorted by time. Events will be copied.
+     * @param[in] nb_events: number of events, 0 to remove annotations
+     * return : 0 if successful, -1 in case of error
+     */
+    virtual int8_t setEvents(const decoder_event_t *events, uint32_t nb_events) = 0;
 
 };
 
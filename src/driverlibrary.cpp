@@ -0,0 +1,98 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file driverlibrary.cpp
+ * @brief Definition of DriverLibrary class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <dlfcn.h>
+
+#include "driverlibrary.h"
+
+/****************************************************************************
+ * DriverLibrary
+ ****************************************************************************/
+DriverLibrary::DriverLibrary() :
+    handle_m(NULL),
+    name_m(NULL)
+{
+}
+
+/****************************************************************************
+ * ~DriverLibrary
+ ****************************************************************************/
+DriverLibrary::~DriverLibrary()
+{
+    close();
+}
+
+/****************************************************************************
+ * open
+ ****************************************************************************/
+int8_t DriverLibrary::open(const char *const *names)
+{
+    if(NULL != handle_m)
+    {
+        return 0;
+    }
+    for(; (NULL != names) && (NULL != *names); names++)
+    {
+        // symbols are only reached through the family table
+        handle_m = dlopen(*names, RTLD_NOW | RTLD_LOCAL);
+        if(NULL != handle_m)
+        {
+            name_m = *names;
+            DEBUG("%s loaded\n", name_m);
+            return 0;
+        }
+        DEBUG("%s\n", dlerror());
+    }
+    return -1;
+}
+
+/****************************************************************************
+ * close
+ ****************************************************************************/
+void DriverLibrary::close(void)
+{
+    if(NULL != handle_m)
+    {
+        dlclose(handle_m);
+        DEBUG("%s unloaded\n", name_m);
+        handle_m = NULL;
+        name_m = NULL;
+    }
+}
+
+/****************************************************************************
+ * resolve
+ ****************************************************************************/
+int8_t DriverLibrary::resolve(const char *symbol, void **address)
+{
+    *address = (NULL != handle_m) ? dlsym(handle_m, symbol) : NULL;
+    if(NULL == *address)
+    {
+        ERROR("%s does not export %s\n", (NULL != name_m) ? name_m : "driver library", symbol);
+        return -1;
+    }
+    return 0;
+}
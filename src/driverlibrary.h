@@ -0,0 +1,80 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file driverlibrary.h
+ * @brief Declaration of DriverLibrary class.
+ * A Picotech driver library opened at run time with dlopen, for builds
+ * where DYNLINK is defined. Each acquisition family resolves the routines it
+ * calls into its own table of function pointers, so only the libraries of
+ * the probed families are loaded, and a missing library only disables its
+ * family.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef DRIVERLIBRARY_H
+#define DRIVERLIBRARY_H
+
+#include "oscilloscope.h"
+
+/**
+ * @brief resolve a driver routine into the table entry its name is defined to
+ * the name is stringified before expansion, the address after
+ */
+#define DRIVER_RESOLVE(library, routine) (library).resolve(#routine, (void **)&(routine))
+
+class DriverLibrary
+{
+public:
+    DriverLibrary();
+    /**
+     * @brief destructor, closes the library
+     */
+    ~DriverLibrary();
+    /**
+     * @brief open the first library found
+     * @param[in] names : NULL terminated table of library names, tried in order
+     * return : 0 if successful, -1 if none can be opened
+     */
+    int8_t open(const char *const *names);
+    /**
+     * @brief close the library, resolved routines must not be called anymore
+     */
+    void close(void);
+    /** @brief true when a library is open */
+    bool loaded(void) const { return NULL != handle_m; }
+    /**
+     * @brief get the address of a routine
+     * @param[in] symbol : routine name
+     * @param[out] address : routine address, NULL if not found
+     * return : 0 if successful, -1 if the library does not export the routine
+     */
+    int8_t resolve(const char *symbol, void **address);
+
+private:
+    /* not copyable */
+    DriverLibrary(const DriverLibrary&);
+    DriverLibrary& operator=(const DriverLibrary&);
+
+    void *handle_m;
+    const char *name_m;
+};
+
+#endif // DRIVERLIBRARY_H
@@ -0,0 +1,220 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file etsreconstructor.cpp
+ * @brief Definition of EtsReconstructor class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "etsreconstructor.h"
+
+/****************************************************************************
+ * EtsReconstructor
+ ****************************************************************************/
+EtsReconstructor::EtsReconstructor() :
+    capacity_m(0),
+    samples_per_pass_m(0),
+    passes_m(0),
+    stored_m(0),
+    slot_m(0),
+    channels_m(0),
+    count_m(0),
+    times_m(NULL),
+    slots_m(NULL),
+    values_m(NULL)
+{
+}
+
+/****************************************************************************
+ * ~EtsReconstructor
+ ****************************************************************************/
+EtsReconstructor::~EtsReconstructor()
+{
+    release();
+}
+
+/****************************************************************************
+ * release
+ ****************************************************************************/
+void EtsReconstructor::release()
+{
+    free(times_m);
+    free(slots_m);
+    free(values_m);
+    times_m = NULL;
+    slots_m = NULL;
+    values_m = NULL;
+    capacity_m = 0;
+    samples_per_pass_m = 0;
+    passes_m = 0;
+}
+
+/****************************************************************************
+ * allocate
+ ****************************************************************************/
+int8_t EtsReconstructor::allocate(uint32_t samples_per_pass, uint8_t passes)
+{
+    uint32_t capacity = 0;
+
+    if((0 == samples_per_pass) || (0 == passes) || (passes > ETS_PASSES))
+    {
+        return -1;
+    }
+    reset();
+    capacity = samples_per_pass * passes;
+    if(capacity > capacity_m)
+    {
+        release();
+        times_m = (double *)malloc(capacity * sizeof(double));
+        slots_m = (uint8_t *)malloc(capacity * sizeof(uint8_t));
+        values_m = (short *)malloc(MAX_CHANNELS * capacity * sizeof(short));
+        if((NULL == times_m) || (NULL == slots_m) || (NULL == values_m))
+        {
+            ERROR("unable to allocate %u ETS samples\n", capacity);
+            release();
+            return -1;
+        }
+        capacity_m = capacity;
+    }
+    samples_per_pass_m = samples_per_pass;
+    passes_m = passes;
+    return 0;
+}
+
+/****************************************************************************
+ * reset
+ ****************************************************************************/
+void EtsReconstructor::reset()
+{
+    count_m = 0;
+    stored_m = 0;
+    slot_m = 0;
+}
+
+/****************************************************************************
+ * drop
+ ****************************************************************************/
+void EtsReconstructor::drop(uint8_t slot)
+{
+    uint32_t i = 0;
+    uint32_t kept = 0;
+    uint8_t ch = 0;
+
+    for(i = 0; i < count_m; i++)
+    {
+        if(slot != slots_m[i])
+        {
+            times_m[kept] = times_m[i];
+            slots_m[kept] = slots_m[i];
+            for(ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                if(channels_m & (1 << ch))
+                {
+                    values_m[ch * capacity_m + kept] = values_m[ch * capacity_m + i];
+                }
+            }
+            kept++;
+        }
+    }
+    count_m = kept;
+}
+
+/****************************************************************************
+ * merge - backward merge, each sample moves once
+ ****************************************************************************/
+int8_t EtsReconstructor::merge(const double *times, const short * const *values, uint8_t channels, uint32_t count)
+{
+    uint32_t i = 0;
+    uint32_t j = 0;
+    uint32_t k = 0;
+    uint8_t ch = 0;
+
+    if((NULL == times) || (0 == count) || (count > samples_per_pass_m))
+    {
+        return -1;
+    }
+    for(i = 1; i < count; i++)
+    {
+        if(times[i] < times[i - 1])
+        {
+            WARNING("ETS pass is not sorted at sample %u\n", i);
+            return -1;
+        }
+    }
+    for(ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        if((channels & (1 << ch)) && (NULL == values[ch]))
+        {
+            return -1;
+        }
+    }
+    if(channels != channels_m)
+    {
+        reset();
+        channels_m = channels;
+    }
+    // the slot of the oldest pass is reused for the new one
+    if(stored_m == passes_m)
+    {
+        drop(slot_m);
+        stored_m--;
+    }
+    i = count_m;
+    j = count;
+    k = count_m + count;
+    while(j > 0)
+    {
+        k--;
+        if((i > 0) && (times_m[i - 1] > times[j - 1]))
+        {
+            i--;
+            times_m[k] = times_m[i];
+            slots_m[k] = slots_m[i];
+            for(ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                if(channels & (1 << ch))
+                {
+                    values_m[ch * capacity_m + k] = values_m[ch * capacity_m + i];
+                }
+            }
+        }
+        else
+        {
+            j--;
+            times_m[k] = times[j];
+            slots_m[k] = slot_m;
+            for(ch = 0; ch < MAX_CHANNELS; ch++)
+            {
+                if(channels & (1 << ch))
+                {
+                    values_m[ch * capacity_m + k] = values[ch][j];
+                }
+            }
+        }
+    }
+    count_m += count;
+    stored_m++;
+    slot_m = (uint8_t)((slot_m + 1) % passes_m);
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file etsreconstructor.h
+ * @brief Declaration of EtsReconstructor class.
+ * Equivalent time sampling passes are merged into one waveform sorted by
+ * time. Each pass is already sorted, so it is merged in linear time into
+ * storage allocated once, the oldest pass being dropped when full.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef ETSRECONSTRUCTOR_H
+#define ETSRECONSTRUCTOR_H
+
+#include "oscilloscope.h"
+
+/* number of ETS passes kept in the reconstructed waveform */
+#define ETS_PASSES 8
+
+class EtsReconstructor
+{
+public:
+    EtsReconstructor();
+    ~EtsReconstructor();
+    /**
+     * @brief reserve storage, storage only grows, the waveform is cleared
+     * @param[in] : maximum number of samples of a pass
+     * @param[in] : number of passes kept, 1 to ETS_PASSES
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t allocate(uint32_t samples_per_pass, uint8_t passes);
+    /** @brief clear the waveform */
+    void reset();
+    /**
+     * @brief merge a pass into the waveform, dropping the oldest pass when full
+     * @param[in] : sample times of the pass in seconds, in increasing order
+     * @param[in] : table of MAX_CHANNELS raw ADC counts, NULL for absent channels
+     * @param[in] : bit mask of channels (bit 0 for channel A, etc), the waveform
+     * restarts when it changes
+     * @param[in] : number of samples of the pass
+     * return : 0 if successful, -1 if the pass is too long or not sorted
+     */
+    int8_t merge(const double *times, const short * const *values, uint8_t channels, uint32_t count);
+    uint32_t count() const { return count_m; }
+    const double *times() const { return times_m; }
+    /** @brief raw ADC counts of a channel, in time order */
+    const short *values(uint8_t channel) const { return values_m + channel * capacity_m; }
+private:
+    EtsReconstructor(const EtsReconstructor &);
+    EtsReconstructor &operator=(const EtsReconstructor &);
+    void release();
+    /** @brief remove samples of a pass slot, keeping time order */
+    void drop(uint8_t slot);
+    uint32_t capacity_m;
+    uint32_t samples_per_pass_m;
+    uint8_t passes_m;
+    uint8_t stored_m;
+    uint8_t slot_m;
+    uint8_t channels_m;
+    uint32_t count_m;
+    double *times_m;
+    /* pass slot of each sample */
+    uint8_t *slots_m;
+    /* channel major storage: samples of channel c start at c * capacity_m */
+    short *values_m;
+};
+
+#endif // ETSRECONSTRUCTOR_H
@@ -0,0 +1,86 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file eventitem.cpp
+ * @brief Definition of EventItem class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <QPainter>
+#include <QFontMetrics>
+#include <qwt_scale_map.h>
+
+#include "eventitem.h"
+
+/****************************************************************************
+ * EventItem
+ ****************************************************************************/
+EventItem::EventItem(std::vector<decoder_event_t> * const *front) :
+    front_m(front),
+    color_m(255, 160, 0)
+{
+}
+
+/****************************************************************************
+ * draw - events are sorted by time, only the visible ones are drawn
+ ****************************************************************************/
+#if ( QWT_VERSION >= 0x060000)
+void EventItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
+#else
+void EventItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRect &canvasRect) const
+#endif
+{
+    const std::vector<decoder_event_t> *events = *front_m;
+    char text[32];
+    double top = canvasRect.top() + 2;
+    double left = 0.;
+    double right = 0.;
+    uint32_t i = 0;
+
+    (void)yMap;
+    painter->setPen(color_m);
+    for(i = 0; i < events->size(); i++)
+    {
+        left = xMap.transform(events->at(i).time);
+        right = xMap.transform(events->at(i).end);
+        if(right < canvasRect.left())
+        {
+            continue;
+        }
+        if(left > canvasRect.right())
+        {
+            break;
+        }
+        if((E_EVENT_START == events->at(i).type) || (E_EVENT_STOP == events->at(i).type))
+        {
+            // conditions are instants: a marker across the lane
+            painter->drawLine(QLineF(left, top, left, top + EVENT_LANE_HEIGHT));
+            continue;
+        }
+        painter->drawRect(QRectF(left, top, right - left, EVENT_LANE_HEIGHT));
+        decoder_event_text(&events->at(i), text, sizeof(text));
+        // labels wider than their box are left out, the table has them
+        if(painter->fontMetrics().width(text) < right - left)
+        {
+            painter->drawText(QRectF(left, top, right - left, EVENT_LANE_HEIGHT), Qt::AlignCenter, text);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file eventitem.h
+ * @brief Declaration of EventItem class.
+ * Decoded protocol events are annotated as labelled boxes at the top of the
+ * canvas.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef EVENTITEM_H
+#define EVENTITEM_H
+
+#include <vector>
+
+#include <QColor>
+#include <qwt_plot_item.h>
+
+#include "protocoldecoder.h"
+
+/* height of the annotation lane, in pixels */
+#define EVENT_LANE_HEIGHT   16
+
+class EventItem : public QwtPlotItem
+{
+public:
+    /**
+     * @brief constructor
+     * @param[in] : location of the current event table pointer, read at each draw
+     */
+    EventItem(std::vector<decoder_event_t> * const *front);
+#if ( QWT_VERSION >= 0x060000)
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const;
+#else
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRect &canvasRect) const;
+#endif
+private:
+    std::vector<decoder_event_t> * const *front_m;
+    QColor color_m;
+};
+
+#endif // EVENTITEM_H
@@ -0,0 +1,844 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file exporter.cpp
+ * @brief Definition of Exporter class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "exporter.h"
+#include "acquisition.h"
+
+/* CSV text formatted before each disk write */
+#define EXPORT_TEXT_SIZE   (1024 * 1024)
+/* MATLAB level 4 matrix types: M * 1000 + P * 10, P being the data type */
+#define MAT_BIG_ENDIAN     1000
+#define MAT_DOUBLE         0
+#define MAT_INT16          30
+
+/* two digits per division: half the divisions of a digit by digit conversion */
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/****************************************************************************
+ * format_digits - write the last nb_digits digits of value, zero padded
+ ****************************************************************************/
+static char *format_digits(char *out, uint64_t value, uint8_t nb_digits)
+{
+    char *p = out + nb_digits;
+    uint32_t pair = 0;
+
+    while(p - out >= 2)
+    {
+        pair = (uint32_t)(value % 100) * 2;
+        value /= 100;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+    if(p > out)
+    {
+        *--p = '0' + (char)(value % 10);
+    }
+    return out + nb_digits;
+}
+
+/****************************************************************************
+ * format_fixed - write value / 10^decimals with all its decimals, without printf
+ ****************************************************************************/
+static char *format_fixed(char *out, int64_t value, uint8_t decimals, uint64_t unit)
+{
+    uint64_t magnitude = (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    uint64_t integer = magnitude / unit;
+    uint8_t nb_digits = 1;
+    uint64_t limit = 10;
+
+    if(value < 0)
+    {
+        *out++ = '-';
+    }
+    while((nb_digits < 20) && (integer >= limit))
+    {
+        nb_digits++;
+        limit *= 10;
+    }
+    out = format_digits(out, integer, nb_digits);
+    *out++ = '.';
+    return format_digits(out, magnitude % unit, decimals);
+}
+
+/****************************************************************************
+ * host_little_endian
+ ****************************************************************************/
+static bool host_little_endian(void)
+{
+    const uint16_t one = 1;
+    return 1 == *(const uint8_t *)&one;
+}
+
+/****************************************************************************
+ * put_le16 / put_le32 - little endian fields of file headers
+ ****************************************************************************/
+static uint8_t *put_le16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    return out + 2;
+}
+
+static uint8_t *put_le32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+    return out + 4;
+}
+
+/****************************************************************************
+ * FrameExportSource
+ ****************************************************************************/
+FrameExportSource::FrameExportSource() :
+    base_m(NULL),
+    count_m(0)
+{
+    memset(&kept_m, 0, sizeof(kept_m));
+}
+
+/****************************************************************************
+ * FrameExportSource::load
+ ****************************************************************************/
+int8_t FrameExportSource::load(Acquisition *acquisition, uint32_t age)
+{
+    uint8_t ch = 0;
+
+    base_m = NULL;
+    count_m = 0;
+    if( (NULL == acquisition) ||
+        (0 != acquisition->get_history_frame(age, &kept_m, samples_m, times_m)) )
+    {
+        return -1;
+    }
+    // channels share the time base, the shortest one gives the count
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        if( !(kept_m.frame.channels & (1 << ch)) )
+            continue;
+        if( (NULL == base_m) || (kept_m.frame.blocks[ch].count < count_m) )
+            count_m = kept_m.frame.blocks[ch].count;
+        if( NULL == base_m )
+            base_m = &kept_m.frame.blocks[ch];
+    }
+    return (NULL != base_m) ? 0 : -1;
+}
+
+uint8_t FrameExportSource::channels(void) const
+{
+    return kept_m.frame.channels;
+}
+
+uint64_t FrameExportSource::count(void) const
+{
+    return count_m;
+}
+
+double FrameExportSource::scale(uint8_t ch) const
+{
+    return (ch < FRAME_CHANNELS) ? kept_m.frame.blocks[ch].scale : 0.;
+}
+
+double FrameExportSource::t0(void) const
+{
+    return (NULL != base_m) ? base_m->t0 : 0.;
+}
+
+double FrameExportSource::dt(void) const
+{
+    return (NULL != base_m) ? base_m->dt : 0.;
+}
+
+bool FrameExportSource::timed(void) const
+{
+    return (NULL != base_m) && (NULL != base_m->times);
+}
+
+/****************************************************************************
+ * FrameExportSource::read
+ ****************************************************************************/
+uint32_t FrameExportSource::read(uint8_t ch, uint64_t first, short *out, uint32_t nb_samples)
+{
+    if( (ch >= FRAME_CHANNELS) || !(kept_m.frame.channels & (1 << ch)) || (first >= count_m) )
+    {
+        return 0;
+    }
+    if( nb_samples > count_m - first )
+    {
+        nb_samples = (uint32_t)(count_m - first);
+    }
+    memcpy(out, kept_m.frame.blocks[ch].raw + first, nb_samples * sizeof(short));
+    return nb_samples;
+}
+
+/****************************************************************************
+ * FrameExportSource::read_times
+ ****************************************************************************/
+uint32_t FrameExportSource::read_times(uint64_t first, double *out, uint32_t nb_samples)
+{
+    if( !timed() || (first >= count_m) )
+    {
+        return 0;
+    }
+    if( nb_samples > count_m - first )
+    {
+        nb_samples = (uint32_t)(count_m - first);
+    }
+    memcpy(out, base_m->times + first, nb_samples * sizeof(double));
+    return nb_samples;
+}
+
+/****************************************************************************
+ * RecordExportSource
+ ****************************************************************************/
+RecordExportSource::RecordExportSource() :
+    acquisition_m(NULL),
+    channels_m(0),
+    first_m(0),
+    count_m(0),
+    dt_m(0.)
+{
+    memset(scale_m, 0, sizeof(scale_m));
+}
+
+/****************************************************************************
+ * RecordExportSource::load - the export range is fixed here, later samples are not exported
+ ****************************************************************************/
+int8_t RecordExportSource::load(Acquisition *acquisition)
+{
+    record_info_t info;
+
+    if( (NULL == acquisition) || (0 != acquisition->get_record_info(&info)) )
+    {
+        return -1;
+    }
+    acquisition_m = acquisition;
+    channels_m = info.channels;
+    first_m = info.first;
+    count_m = info.count;
+    dt_m = info.dt;
+    memcpy(scale_m, info.scale, sizeof(scale_m));
+    return 0;
+}
+
+uint8_t RecordExportSource::channels(void) const
+{
+    return channels_m;
+}
+
+uint64_t RecordExportSource::count(void) const
+{
+    return count_m;
+}
+
+double RecordExportSource::scale(uint8_t ch) const
+{
+    return (ch < MAX_CHANNELS) ? scale_m[ch] : 0.;
+}
+
+double RecordExportSource::t0(void) const
+{
+    return 0.;
+}
+
+double RecordExportSource::dt(void) const
+{
+    return dt_m;
+}
+
+bool RecordExportSource::timed(void) const
+{
+    return false;
+}
+
+/****************************************************************************
+ * RecordExportSource::read
+ ****************************************************************************/
+uint32_t RecordExportSource::read(uint8_t ch, uint64_t first, short *out, uint32_t nb_samples)
+{
+    if( (NULL == acquisition_m) || (first >= count_m) )
+    {
+        return 0;
+    }
+    if( nb_samples > count_m - first )
+    {
+        nb_samples = (uint32_t)(count_m - first);
+    }
+    return acquisition_m->read_record(ch, first_m + first, out, nb_samples);
+}
+
+uint32_t RecordExportSource::read_times(uint64_t first, double *out, uint32_t nb_samples)
+{
+    (void)first;
+    (void)out;
+    (void)nb_samples;
+    return 0;
+}
+
+/****************************************************************************
+ * Exporter
+ ****************************************************************************/
+Exporter::Exporter() :
+    joinable_m(false),
+    running_m(false),
+    cancel_m(false),
+    done_m(0),
+    total_m(0),
+    result_m(0),
+    source_m(NULL),
+    file_m(NULL),
+    format_m(E_EXPORT_CSV),
+    nb_channels_m(0),
+    samples_m(NULL),
+    interleaved_m(NULL),
+    times_m(NULL),
+    text_m(NULL)
+{
+    memset(&thread_m, 0, sizeof(thread_m));
+    memset(channel_list_m, 0, sizeof(channel_list_m));
+    pthread_mutex_init(&lock_m, NULL);
+}
+
+/****************************************************************************
+ * ~Exporter
+ ****************************************************************************/
+Exporter::~Exporter()
+{
+    cancel();
+    join();
+    pthread_mutex_destroy(&lock_m);
+    free(samples_m);
+    free(interleaved_m);
+    free(times_m);
+    free(text_m);
+}
+
+/****************************************************************************
+ * start
+ ****************************************************************************/
+int8_t Exporter::start(ExportSource *source, const std::string &path, export_format_e format)
+{
+    uint8_t ch = 0;
+    int ret = 0;
+
+    if( NULL == source )
+    {
+        return -1;
+    }
+    if( busy() )
+    {
+        ERROR("an export is already running\n");
+        delete source;
+        return -1;
+    }
+    join();
+    // chunk buffers are allocated by the first export and kept
+    if( NULL == samples_m )
+    {
+        samples_m = (short *)malloc(FRAME_CHANNELS * EXPORT_CHUNK_SAMPLES * sizeof(short));
+        interleaved_m = (short *)malloc(FRAME_CHANNELS * EXPORT_CHUNK_SAMPLES * sizeof(short));
+        times_m = (double *)malloc(EXPORT_CHUNK_SAMPLES * sizeof(double));
+        text_m = (char *)malloc(EXPORT_TEXT_SIZE);
+        if( (NULL == samples_m) || (NULL == interleaved_m) || (NULL == times_m) || (NULL == text_m) )
+        {
+            ERROR("unable to allocate export buffers\n");
+            free(samples_m);
+            free(interleaved_m);
+            free(times_m);
+            free(text_m);
+            samples_m = NULL;
+            interleaved_m = NULL;
+            times_m = NULL;
+            text_m = NULL;
+            delete source;
+            return -1;
+        }
+    }
+    nb_channels_m = 0;
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        if( source->channels() & (1 << ch) )
+            channel_list_m[nb_channels_m++] = ch;
+    }
+    if( (0 == nb_channels_m) || (0 == source->count()) )
+    {
+        ERROR("nothing to export\n");
+        delete source;
+        return -1;
+    }
+    file_m = fopen(path.c_str(), "wb");
+    if( NULL == file_m )
+    {
+        ERROR("cannot open %s for writing\n", path.c_str());
+        delete source;
+        return -1;
+    }
+    source_m = source;
+    path_m = path;
+    format_m = format;
+    pthread_mutex_lock(&lock_m);
+    running_m = true;
+    cancel_m = false;
+    done_m = 0;
+    total_m = source->count() * nb_channels_m;
+    result_m = -1;
+    pthread_mutex_unlock(&lock_m);
+    ret = pthread_create(&thread_m, NULL, Exporter::threadExport, this);
+    if( 0 != ret )
+    {
+        ERROR("pthread_create failed and returned %d\n", ret);
+        fclose(file_m);
+        file_m = NULL;
+        delete source_m;
+        source_m = NULL;
+        pthread_mutex_lock(&lock_m);
+        running_m = false;
+        pthread_mutex_unlock(&lock_m);
+        return -1;
+    }
+    joinable_m = true;
+    return 0;
+}
+
+/****************************************************************************
+ * busy
+ ****************************************************************************/
+bool Exporter::busy(void)
+{
+    bool running = false;
+
+    pthread_mutex_lock(&lock_m);
+    running = running_m;
+    pthread_mutex_unlock(&lock_m);
+    return running;
+}
+
+/****************************************************************************
+ * progress
+ ****************************************************************************/
+void Exporter::progress(uint64_t *done, uint64_t *total)
+{
+    pthread_mutex_lock(&lock_m);
+    *done = done_m;
+    *total = total_m;
+    pthread_mutex_unlock(&lock_m);
+}
+
+/****************************************************************************
+ * cancel
+ ****************************************************************************/
+void Exporter::cancel(void)
+{
+    pthread_mutex_lock(&lock_m);
+    cancel_m = true;
+    pthread_mutex_unlock(&lock_m);
+}
+
+/****************************************************************************
+ * result
+ ****************************************************************************/
+int8_t Exporter::result(void)
+{
+    int8_t result = 0;
+
+    pthread_mutex_lock(&lock_m);
+    result = result_m;
+    pthread_mutex_unlock(&lock_m);
+    return result;
+}
+
+/****************************************************************************
+ * join
+ ****************************************************************************/
+void Exporter::join(void)
+{
+    if( joinable_m )
+    {
+        pthread_join(thread_m, NULL);
+        joinable_m = false;
+    }
+}
+
+/****************************************************************************
+ * threadExport
+ ****************************************************************************/
+void* Exporter::threadExport(void *arg)
+{
+    Exporter *exporter = (Exporter *)arg;
+    int8_t ret = -1;
+
+    switch(exporter->format_m)
+    {
+        case E_EXPORT_CSV:
+            ret = exporter->write_csv();
+            break;
+        case E_EXPORT_RAW:
+            ret = exporter->write_raw();
+            break;
+        case E_EXPORT_WAV:
+            ret = exporter->write_wav();
+            break;
+        case E_EXPORT_MAT:
+            ret = exporter->write_mat();
+            break;
+        default:
+            ERROR("unknown export format %d\n", exporter->format_m);
+            break;
+    }
+    if( (0 != fclose(exporter->file_m)) && (0 == ret) )
+    {
+        ERROR("cannot write %s\n", exporter->path_m.c_str());
+        ret = -1;
+    }
+    exporter->file_m = NULL;
+    delete exporter->source_m;
+    exporter->source_m = NULL;
+    DEBUG("export of %s ended with %d\n", exporter->path_m.c_str(), ret);
+    pthread_mutex_lock(&exporter->lock_m);
+    exporter->result_m = ret;
+    exporter->running_m = false;
+    pthread_mutex_unlock(&exporter->lock_m);
+    return NULL;
+}
+
+/****************************************************************************
+ * cancelled
+ ****************************************************************************/
+bool Exporter::cancelled(void)
+{
+    bool cancel = false;
+
+    pthread_mutex_lock(&lock_m);
+    cancel = cancel_m;
+    pthread_mutex_unlock(&lock_m);
+    return cancel;
+}
+
+/****************************************************************************
+ * set_done
+ ****************************************************************************/
+void Exporter::set_done(uint64_t done)
+{
+    pthread_mutex_lock(&lock_m);
+    done_m = done;
+    pthread_mutex_unlock(&lock_m);
+}
+
+/****************************************************************************
+ * write
+ ****************************************************************************/
+int8_t Exporter::write(const void *data, size_t size)
+{
+    if( fwrite(data, 1, size, file_m) != size )
+    {
+        ERROR("cannot write %s\n", path_m.c_str());
+        return -1;
+    }
+    return 0;
+}
+
+/****************************************************************************
+ * read_chunk - all channels or none, a short read means samples are lost
+ ****************************************************************************/
+uint32_t Exporter::read_chunk(uint64_t first, uint32_t nb_samples)
+{
+    uint8_t c = 0;
+
+    for(c = 0; c < nb_channels_m; c++)
+    {
+        if( source_m->read(channel_list_m[c], first, samples_m + c * EXPORT_CHUNK_SAMPLES, nb_samples) != nb_samples )
+        {
+            ERROR("samples %lu to %lu are no longer available\n",
+                  (unsigned long)first, (unsigned long)(first + nb_samples));
+            return 0;
+        }
+    }
+    if( source_m->timed() && (source_m->read_times(first, times_m, nb_samples) != nb_samples) )
+    {
+        return 0;
+    }
+    return nb_samples;
+}
+
+/****************************************************************************
+ * write_csv
+ ****************************************************************************/
+int8_t Exporter::write_csv(void)
+{
+    const uint64_t count = source_m->count();
+    const double t0 = source_m->t0();
+    const double dt = source_m->dt();
+    uint64_t first = 0;
+    uint32_t nb_samples = 0;
+    uint32_t i = 0;
+    uint8_t c = 0;
+    double scale[FRAME_CHANNELS];
+    double time = 0.;
+    char *p = text_m;
+
+    // header lines are written once, printf is fine here
+    p += snprintf(p, EXPORT_LINE_MAX, "# qpicoscope export, %lu samples, dt %g s\ntime (s)",
+                  (unsigned long)count, dt);
+    for(c = 0; c < nb_channels_m; c++)
+    {
+        if( MATH_CHANNEL == channel_list_m[c] )
+            p += snprintf(p, EXPORT_LINE_MAX, ",math (V)");
+        else
+            p += snprintf(p, EXPORT_LINE_MAX, ",%c (V)", 'A' + channel_list_m[c]);
+        scale[c] = source_m->scale(channel_list_m[c]) * 1e6;
+    }
+    *p++ = '\n';
+
+    for(first = 0; first < count; first += nb_samples)
+    {
+        nb_samples = (count - first > EXPORT_CHUNK_SAMPLES) ? EXPORT_CHUNK_SAMPLES : (uint32_t)(count - first);
+        if( cancelled() || (0 == read_chunk(first, nb_samples)) )
+        {
+            return -1;
+        }
+        for(i = 0; i < nb_samples; i++)
+        {
+            if( p - text_m > EXPORT_TEXT_SIZE - EXPORT_LINE_MAX )
+            {
+                if( 0 != write(text_m, p - text_m) )
+                    return -1;
+                p = text_m;
+            }
+            // picoseconds and microvolts, written as fixed point seconds and volts
+            time = source_m->timed() ? times_m[i] : t0 + (first + i) * dt;
+            p = format_fixed(p, llround(time * 1e12), 12, 1000000000000ULL);
+            for(c = 0; c < nb_channels_m; c++)
+            {
+                *p++ = ',';
+                p = format_fixed(p, llround(samples_m[c * EXPORT_CHUNK_SAMPLES + i] * scale[c]), 6, 1000000ULL);
+            }
+            *p++ = '\n';
+        }
+        set_done((first + nb_samples) * nb_channels_m);
+    }
+    return write(text_m, p - text_m);
+}
+
+/****************************************************************************
+ * interleave - one frame of channels per sample, little endian
+ ****************************************************************************/
+static void interleave(short *out, const short *samples, uint8_t nb_channels, uint32_t nb_samples, bool swap)
+{
+    uint32_t i = 0;
+    uint8_t c = 0;
+    uint16_t value = 0;
+
+    for(c = 0; c < nb_channels; c++)
+    {
+        for(i = 0; i < nb_samples; i++)
+        {
+            value = (uint16_t)samples[c * EXPORT_CHUNK_SAMPLES + i];
+            if( swap )
+                value = (uint16_t)((value << 8) | (value >> 8));
+            out[i * nb_channels + c] = (short)value;
+        }
+    }
+}
+
+/****************************************************************************
+ * write_raw
+ ****************************************************************************/
+int8_t Exporter::write_raw(void)
+{
+    const uint64_t count = source_m->count();
+    const bool swap = !host_little_endian();
+    uint64_t first = 0;
+    uint32_t nb_samples = 0;
+
+    for(first = 0; first < count; first += nb_samples)
+    {
+        nb_samples = (count - first > EXPORT_CHUNK_SAMPLES) ? EXPORT_CHUNK_SAMPLES : (uint32_t)(count - first);
+        if( cancelled() || (0 == read_chunk(first, nb_samples)) )
+        {
+            return -1;
+        }
+        interleave(interleaved_m, samples_m, nb_channels_m, nb_samples, swap);
+        if( 0 != write(interleaved_m, nb_samples * nb_channels_m * sizeof(short)) )
+        {
+            return -1;
+        }
+        set_done((first + nb_samples) * nb_channels_m);
+    }
+    return 0;
+}
+
+/****************************************************************************
+ * write_wav - RIFF header then the same samples as raw export
+ ****************************************************************************/
+int8_t Exporter::write_wav(void)
+{
+    const uint64_t data_size = source_m->count() * nb_channels_m * sizeof(short);
+    const double rate = (source_m->dt() > 0.) ? 1. / source_m->dt() : 0.;
+    uint32_t sample_rate = 0;
+    uint8_t header[44];
+    uint8_t *p = header;
+
+    if( data_size > 0xFFFFFFFFULL - 36 )
+    {
+        ERROR("%lu samples do not fit in a wave file\n", (unsigned long)source_m->count());
+        return -1;
+    }
+    // wave rates are integers, faster sampling is kept as the highest rate
+    sample_rate = (rate >= 4294967295.) ? 0xFFFFFFFFU : (rate < 1.) ? 1 : (uint32_t)llround(rate);
+    memcpy(p, "RIFF", 4);
+    p = put_le32(p + 4, (uint32_t)(36 + data_size));
+    memcpy(p, "WAVEfmt ", 8);
+    p = put_le32(p + 8, 16);
+    p = put_le16(p, 1);
+    p = put_le16(p, nb_channels_m);
+    p = put_le32(p, sample_rate);
+    p = put_le32(p, (uint32_t)((uint64_t)sample_rate * nb_channels_m * sizeof(short)));
+    p = put_le16(p, (uint16_t)(nb_channels_m * sizeof(short)));
+    p = put_le16(p, 16);
+    memcpy(p, "data", 4);
+    put_le32(p + 4, (uint32_t)data_size);
+    if( 0 != write(header, sizeof(header)) )
+    {
+        return -1;
+    }
+    return write_raw();
+}
+
+/****************************************************************************
+ * write_mat_header
+ ****************************************************************************/
+int8_t Exporter::write_mat_header(const char *name, uint32_t type, uint32_t rows, uint32_t cols)
+{
+    uint32_t header[5];
+
+    // level 4 headers are in the byte order given by the type
+    header[0] = type + (host_little_endian() ? 0 : MAT_BIG_ENDIAN);
+    header[1] = rows;
+    header[2] = cols;
+    header[3] = 0;
+    header[4] = strlen(name) + 1;
+    if( 0 != write(header, sizeof(header)) )
+    {
+        return -1;
+    }
+    return write(name, header[4]);
+}
+
+/****************************************************************************
+ * write_mat - counts matrix is column major: written one channel after the other
+ ****************************************************************************/
+int8_t Exporter::write_mat(void)
+{
+    const uint64_t count = source_m->count();
+    double value = 0.;
+    uint64_t first = 0;
+    uint32_t nb_samples = 0;
+    uint8_t c = 0;
+
+    if( count > 0x7FFFFFFFULL )
+    {
+        ERROR("%lu samples do not fit in a MATLAB level 4 matrix\n", (unsigned long)count);
+        return -1;
+    }
+    if( 0 != write_mat_header("counts", MAT_INT16, (uint32_t)count, nb_channels_m) )
+    {
+        return -1;
+    }
+    for(c = 0; c < nb_channels_m; c++)
+    {
+        for(first = 0; first < count; first += nb_samples)
+        {
+            nb_samples = (count - first > EXPORT_CHUNK_SAMPLES) ? EXPORT_CHUNK_SAMPLES : (uint32_t)(count - first);
+            if( cancelled() ||
+                (source_m->read(channel_list_m[c], first, samples_m, nb_samples) != nb_samples) )
+            {
+                ERROR("samples %lu to %lu are no longer available\n",
+                      (unsigned long)first, (unsigned long)(first + nb_samples));
+                return -1;
+            }
+            if( 0 != write(samples_m, nb_samples * sizeof(short)) )
+            {
+                return -1;
+            }
+            set_done(c * count + first + nb_samples);
+        }
+    }
+
+    if( 0 != write_mat_header("scale", MAT_DOUBLE, 1, nb_channels_m) )
+    {
+        return -1;
+    }
+    for(c = 0; c < nb_channels_m; c++)
+    {
+        value = source_m->scale(channel_list_m[c]);
+        if( 0 != write(&value, sizeof(value)) )
+            return -1;
+    }
+    value = source_m->t0();
+    if( (0 != write_mat_header("t0", MAT_DOUBLE, 1, 1)) || (0 != write(&value, sizeof(value))) )
+    {
+        return -1;
+    }
+    value = source_m->dt();
+    if( (0 != write_mat_header("dt", MAT_DOUBLE, 1, 1)) || (0 != write(&value, sizeof(value))) )
+    {
+        return -1;
+    }
+    if( !source_m->timed() )
+    {
+        return 0;
+    }
+    // equivalent time samples are not evenly spaced
+    if( 0 != write_mat_header("time", MAT_DOUBLE, (uint32_t)count, 1) )
+    {
+        return -1;
+    }
+    for(first = 0; first < count; first += nb_samples)
+    {
+        nb_samples = (count - first > EXPORT_CHUNK_SAMPLES) ? EXPORT_CHUNK_SAMPLES : (uint32_t)(count - first);
+        if( cancelled() || (source_m->read_times(first, times_m, nb_samples) != nb_samples) ||
+            (0 != write(times_m, nb_samples * sizeof(double))) )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file exporter.h
+ * @brief Declaration of Exporter class.
+ * Captures and records are written to disk by a dedicated thread, so that
+ * neither the acquisition nor the GUI wait for the formatting or the disk.
+ * Samples are read from their source one chunk at a time: memory used by an
+ * export does not depend on its length.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+#include "oscilloscope.h"
+#include "sampleblock.h"
+#include "waveformhistory.h"
+
+class Acquisition;
+
+/* samples per channel formatted and written at once */
+#define EXPORT_CHUNK_SAMPLES   65536
+/* longest CSV line: time, then one value per channel */
+#define EXPORT_LINE_MAX        (32 + 24 * FRAME_CHANNELS)
+
+typedef enum
+{
+    /** @brief text, one line per sample: time in seconds then volts of each channel */
+    E_EXPORT_CSV = 0,
+    /** @brief interleaved 16 bits little endian ADC counts, no header */
+    E_EXPORT_RAW,
+    /** @brief 16 bits PCM wave file, one wave channel per channel */
+    E_EXPORT_WAV,
+    /** @brief MATLAB level 4 file: counts, scale, t0, dt and time matrices */
+    E_EXPORT_MAT
+}export_format_e;
+
+/**
+ * @brief samples to export, read one chunk at a time by the writer thread
+ */
+class ExportSource
+{
+public:
+    virtual ~ExportSource() {}
+    /** @brief bit mask of exported channels, bit MATH_CHANNEL for math */
+    virtual uint8_t channels(void) const = 0;
+    /** @brief number of samples of each channel */
+    virtual uint64_t count(void) const = 0;
+    /** @brief volts per ADC count of a channel */
+    virtual double scale(uint8_t ch) const = 0;
+    /** @brief time of the first sample, in seconds */
+    virtual double t0(void) const = 0;
+    /** @brief sample interval, in seconds */
+    virtual double dt(void) const = 0;
+    /** @brief true when samples have explicit times (ETS) */
+    virtual bool timed(void) const = 0;
+    /**
+     * @brief copy samples of a channel
+     * @param[in] : channel
+     * @param[in] : index of the first sample, from 0 to count()
+     * @param[out] : table of at least nb_samples elements
+     * @param[in] : number of samples wanted
+     * return : number of samples copied, less than asked if samples are lost
+     */
+    virtual uint32_t read(uint8_t ch, uint64_t first, short *out, uint32_t nb_samples) = 0;
+    /**
+     * @brief copy sample times of a timed source, in seconds
+     * return : number of times copied
+     */
+    virtual uint32_t read_times(uint64_t first, double *out, uint32_t nb_samples) = 0;
+};
+
+/**
+ * @brief a kept block capture, copied out of the history when loaded
+ */
+class FrameExportSource : public ExportSource
+{
+public:
+    FrameExportSource();
+    /**
+     * @brief copy a kept capture
+     * @param[in] : acquisition keeping the captures
+     * @param[in] : age, 0 for the newest capture
+     * return : 0 if successful, -1 if there is no such capture
+     */
+    int8_t load(Acquisition *acquisition, uint32_t age);
+    uint8_t channels(void) const;
+    uint64_t count(void) const;
+    double scale(uint8_t ch) const;
+    double t0(void) const;
+    double dt(void) const;
+    bool timed(void) const;
+    uint32_t read(uint8_t ch, uint64_t first, short *out, uint32_t nb_samples);
+    uint32_t read_times(uint64_t first, double *out, uint32_t nb_samples);
+private:
+    /* not copyable: blocks point in the tables */
+    FrameExportSource(const FrameExportSource&);
+    FrameExportSource& operator=(const FrameExportSource&);
+
+    history_frame_t kept_m;
+    std::vector<short> samples_m;
+    std::vector<double> times_m;
+    /* first channel, giving the time base */
+    const sample_block_t *base_m;
+    uint32_t count_m;
+};
+
+/**
+ * @brief full resolution record of fast streaming and roll modes, read in
+ * place while streaming goes on: export fails if samples are overwritten
+ */
+class RecordExportSource : public ExportSource
+{
+public:
+    RecordExportSource();
+    /**
+     * @brief take the samples currently recorded
+     * @param[in] : acquisition holding the record
+     * return : 0 if successful, -1 if nothing is recorded
+     */
+    int8_t load(Acquisition *acquisition);
+    uint8_t channels(void) const;
+    uint64_t count(void) const;
+    double scale(uint8_t ch) const;
+    double t0(void) const;
+    double dt(void) const;
+    bool timed(void) const;
+    uint32_t read(uint8_t ch, uint64_t first, short *out, uint32_t nb_samples);
+    uint32_t read_times(uint64_t first, double *out, uint32_t nb_samples);
+private:
+    Acquisition *acquisition_m;
+    uint8_t channels_m;
+    uint64_t first_m;
+    uint64_t count_m;
+    double dt_m;
+    double scale_m[MAX_CHANNELS];
+};
+
+class Exporter
+{
+public:
+    Exporter();
+    /**
+     * @brief destructor, a running export is cancelled
+     */
+    ~Exporter();
+    /**
+     * @brief start an export, only one export runs at a time
+     * @param[in] : samples to export, deleted by the exporter
+     * @param[in] : file path
+     * @param[in] : file format
+     * return : 0 if the export started, -1 in case of error
+     */
+    int8_t start(ExportSource *source, const std::string &path, export_format_e format);
+    /** @brief true while an export runs */
+    bool busy(void);
+    /**
+     * @brief get progress of the running or last export
+     * @param[out] : samples written, all channels
+     * @param[out] : samples to write, all channels
+     */
+    void progress(uint64_t *done, uint64_t *total);
+    /** @brief stop the running export, the file is left incomplete */
+    void cancel(void);
+    /** @brief 0 if the last export succeeded, -1 if it failed or was cancelled */
+    int8_t result(void);
+
+private:
+    /* not copyable */
+    Exporter(const Exporter&);
+    Exporter& operator=(const Exporter&);
+
+    static void* threadExport(void *arg);
+    /** @brief join the thread of the last export */
+    void join(void);
+    int8_t write_csv(void);
+    int8_t write_raw(void);
+    int8_t write_wav(void);
+    int8_t write_mat(void);
+    /** @brief write a MATLAB level 4 matrix header */
+    int8_t write_mat_header(const char *name, uint32_t type, uint32_t rows, uint32_t cols);
+    /** @brief read a chunk of every channel, samples_m is channel major */
+    uint32_t read_chunk(uint64_t first, uint32_t nb_samples);
+    int8_t write(const void *data, size_t size);
+    bool cancelled(void);
+    void set_done(uint64_t done);
+
+    pthread_t thread_m;
+    bool joinable_m;
+    pthread_mutex_t lock_m;
+    /* state shared with the GUI, under lock_m */
+    bool running_m;
+    bool cancel_m;
+    uint64_t done_m;
+    uint64_t total_m;
+    int8_t result_m;
+    /* export in progress, used by the writer thread only */
+    ExportSource *source_m;
+    FILE *file_m;
+    std::string path_m;
+    export_format_e format_m;
+    uint8_t nb_channels_m;
+    uint8_t channel_list_m[FRAME_CHANNELS];
+    /* chunk buffers, allocated once */
+    short *samples_m;
+    short *interleaved_m;
+    double *times_m;
+    char *text_m;
+};
+
+#endif // EXPORTER_H
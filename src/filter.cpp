@@ -0,0 +1,331 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file filter.cpp
+ * @brief Definition of Filter class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#include "filter.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/****************************************************************************
+ * saturate a filtered value to an ADC count
+ ****************************************************************************/
+static inline short to_count(float value)
+{
+    value = (value > SHRT_MAX) ? SHRT_MAX : ((value < SHRT_MIN) ? SHRT_MIN : value);
+    return (short)lrintf(value);
+}
+
+/****************************************************************************
+ * windowed sinc low pass, normalized cutoff (cycles per sample)
+ ****************************************************************************/
+static void sinc_low_pass(double fc, std::vector<float> &taps)
+{
+    const int middle = FILTER_FIR_TAPS / 2;
+    double sum = 0.;
+    std::vector<double> h(FILTER_FIR_TAPS);
+
+    for(int n = 0; n < FILTER_FIR_TAPS; n++)
+    {
+        const int m = n - middle;
+        const double sinc = (0 == m) ? 2. * fc : sin(2. * M_PI * fc * m) / (M_PI * m);
+        const double hamming = 0.54 - 0.46 * cos(2. * M_PI * n / (FILTER_FIR_TAPS - 1));
+        h[n] = sinc * hamming;
+        sum += h[n];
+    }
+    /* unity gain in DC */
+    taps.resize(FILTER_FIR_TAPS);
+    for(int n = 0; n < FILTER_FIR_TAPS; n++)
+        taps[n] = (float)(h[n] / sum);
+}
+
+/****************************************************************************
+ * Filter
+ ****************************************************************************/
+Filter::Filter() :
+    sample_interval_m(0.),
+    active_m(false),
+    designed_m(false),
+    primed_m(false)
+{
+    spec_m.type = E_FILTER_NONE;
+    spec_m.cutoff_hz = 0.;
+    spec_m.cutoff2_hz = 0.;
+}
+
+/****************************************************************************
+ * configure
+ ****************************************************************************/
+void Filter::configure(const filter_spec_t &spec)
+{
+    spec_m = spec;
+    designed_m = false;
+}
+
+/****************************************************************************
+ * reserve
+ ****************************************************************************/
+void Filter::reserve(uint32_t nb_samples)
+{
+    /* FIR blocks are preceded by the previous block tail */
+    work_m.reserve(FILTER_FIR_TAPS - 1 + nb_samples);
+}
+
+/****************************************************************************
+ * prepare
+ ****************************************************************************/
+void Filter::prepare(double sample_interval)
+{
+    if(!designed_m || (sample_interval != sample_interval_m))
+    {
+        sample_interval_m = sample_interval;
+        active_m = false;
+        designed_m = true;
+        if((E_FILTER_NONE == spec_m.type) || (sample_interval <= 0.))
+        {
+            return;
+        }
+        /* cutoffs must stay below Nyquist */
+        if((spec_m.cutoff_hz * 2. * sample_interval >= 1.) ||
+           (((E_FILTER_FIR_BAND_PASS == spec_m.type) || (E_FILTER_IIR_BAND_PASS == spec_m.type)) &&
+            ((spec_m.cutoff2_hz * 2. * sample_interval >= 1.) || (spec_m.cutoff2_hz <= spec_m.cutoff_hz))))
+        {
+            WARNING("filter cutoff %g Hz does not fit %g Hz sampling, bypassed\n", spec_m.cutoff_hz, 1. / sample_interval);
+            return;
+        }
+        if(spec_m.type <= E_FILTER_FIR_BAND_PASS)
+            design_fir();
+        else
+            design_iir();
+        active_m = true;
+    }
+    /* new run: clear the state */
+    if(!history_m.empty())
+        memset(&history_m[0], 0, history_m.size() * sizeof(float));
+    for(size_t s = 0; s < sections_m.size(); s++)
+        sections_m[s].z1 = sections_m[s].z2 = 0.f;
+    primed_m = false;
+}
+
+/****************************************************************************
+ * prime - state of a filter fed with value forever, a run then starts
+ * without the step from zero
+ ****************************************************************************/
+void Filter::prime(float value)
+{
+    float x = value;
+    float y = 0.f;
+
+    for(size_t i = 0; i < history_m.size(); i++)
+        history_m[i] = value;
+    for(size_t s = 0; s < sections_m.size(); s++)
+    {
+        biquad_t &bq = sections_m[s];
+        /* steady state of a direct form II transposed section, its output feeds the next one */
+        y = x * (bq.b0 + bq.b1 + bq.b2) / (1.f + bq.a1 + bq.a2);
+        bq.z2 = bq.b2 * x - bq.a2 * y;
+        bq.z1 = bq.b1 * x - bq.a1 * y + bq.z2;
+        x = y;
+    }
+    primed_m = true;
+}
+
+/****************************************************************************
+ * design_fir
+ ****************************************************************************/
+void Filter::design_fir(void)
+{
+    const double f1 = spec_m.cutoff_hz * sample_interval_m;
+    const double f2 = spec_m.cutoff2_hz * sample_interval_m;
+    std::vector<float> upper;
+
+    sections_m.clear();
+    switch(spec_m.type)
+    {
+        case E_FILTER_FIR_HIGH_PASS:
+            /* spectral inversion of the low pass */
+            sinc_low_pass(f1, taps_m);
+            for(int n = 0; n < FILTER_FIR_TAPS; n++)
+                taps_m[n] = -taps_m[n];
+            taps_m[FILTER_FIR_TAPS / 2] += 1.f;
+            break;
+        case E_FILTER_FIR_BAND_PASS:
+            sinc_low_pass(f1, taps_m);
+            sinc_low_pass(f2, upper);
+            for(int n = 0; n < FILTER_FIR_TAPS; n++)
+                taps_m[n] = upper[n] - taps_m[n];
+            break;
+        case E_FILTER_FIR_LOW_PASS:
+        default:
+            sinc_low_pass(f1, taps_m);
+            break;
+    }
+    history_m.assign(FILTER_FIR_TAPS - 1, 0.f);
+}
+
+/****************************************************************************
+ * design_iir - RBJ audio EQ cookbook biquads
+ ****************************************************************************/
+void Filter::design_iir(void)
+{
+    /* Q of a 4th order Butterworth made of two sections */
+    static const double butterworth_q[FILTER_IIR_SECTIONS] = { 0.54119610, 1.30656296 };
+    double f0 = spec_m.cutoff_hz;
+    double q = 0.;
+    double w0 = 0.;
+    double alpha = 0.;
+    double cosw0 = 0.;
+    double a0 = 0.;
+    int nb_sections = FILTER_IIR_SECTIONS;
+    biquad_t section;
+
+    taps_m.clear();
+    history_m.clear();
+    sections_m.clear();
+    if(E_FILTER_IIR_BAND_PASS == spec_m.type)
+    {
+        f0 = sqrt(spec_m.cutoff_hz * spec_m.cutoff2_hz);
+        nb_sections = 1;
+    }
+    w0 = 2. * M_PI * f0 * sample_interval_m;
+    cosw0 = cos(w0);
+    for(int s = 0; s < nb_sections; s++)
+    {
+        q = (E_FILTER_IIR_BAND_PASS == spec_m.type) ?
+            f0 / (spec_m.cutoff2_hz - spec_m.cutoff_hz) : butterworth_q[s];
+        alpha = sin(w0) / (2. * q);
+        a0 = 1. + alpha;
+        switch(spec_m.type)
+        {
+            case E_FILTER_IIR_HIGH_PASS:
+                section.b0 = (float)(((1. + cosw0) / 2.) / a0);
+                section.b1 = (float)(-(1. + cosw0) / a0);
+                section.b2 = section.b0;
+                break;
+            case E_FILTER_IIR_BAND_PASS:
+                /* constant 0 dB peak gain */
+                section.b0 = (float)(alpha / a0);
+                section.b1 = 0.f;
+                section.b2 = -section.b0;
+                break;
+            case E_FILTER_IIR_LOW_PASS:
+            default:
+                section.b0 = (float)(((1. - cosw0) / 2.) / a0);
+                section.b1 = (float)((1. - cosw0) / a0);
+                section.b2 = section.b0;
+                break;
+        }
+        section.a1 = (float)((-2. * cosw0) / a0);
+        section.a2 = (float)((1. - alpha) / a0);
+        section.z1 = section.z2 = 0.f;
+        sections_m.push_back(section);
+    }
+}
+
+/****************************************************************************
+ * process
+ ****************************************************************************/
+void Filter::process(const short *in, short *out, uint32_t nb_samples)
+{
+    if(!active_m)
+    {
+        if(in != out)
+            memmove(out, in, nb_samples * sizeof(short));
+        return;
+    }
+    if(!primed_m && (nb_samples > 0))
+        prime(in[0]);
+    if(!taps_m.empty())
+        process_fir(in, out, nb_samples);
+    else
+        process_iir(in, out, nb_samples);
+}
+
+/****************************************************************************
+ * process_fir - block convolution, the history carries the previous block tail
+ ****************************************************************************/
+void Filter::process_fir(const short *in, short *out, uint32_t nb_samples)
+{
+    const uint32_t order = FILTER_FIR_TAPS - 1;
+    const float *taps = &taps_m[0];
+    float *x = NULL;
+    uint32_t i = 0;
+    int k = 0;
+
+    /* x = last inputs of previous block followed by this block */
+    work_m.resize(order + nb_samples);
+    x = &work_m[0];
+    memcpy(x, &history_m[0], order * sizeof(float));
+    for(i = 0; i < nb_samples; i++)
+        x[order + i] = in[i];
+    memcpy(&history_m[0], x + nb_samples, order * sizeof(float));
+
+    /* taps are symmetric, so out[i] is a plain dot product over x[i..i+order] */
+    for(i = 0; i < nb_samples; i++)
+    {
+        const float *window = x + i;
+        float acc = 0.f;
+        for(k = 0; k < FILTER_FIR_TAPS; k++)
+            acc += taps[k] * window[k];
+        out[i] = to_count(acc);
+    }
+}
+
+/****************************************************************************
+ * process_iir - cascade of direct form II transposed biquads, one pass per section
+ ****************************************************************************/
+void Filter::process_iir(const short *in, short *out, uint32_t nb_samples)
+{
+    float *y = NULL;
+    uint32_t i = 0;
+
+    work_m.resize(nb_samples);
+    if(0 == nb_samples)
+        return;
+    y = &work_m[0];
+    for(i = 0; i < nb_samples; i++)
+        y[i] = in[i];
+    for(size_t s = 0; s < sections_m.size(); s++)
+    {
+        biquad_t bq = sections_m[s];
+        for(i = 0; i < nb_samples; i++)
+        {
+            const float x = y[i];
+            const float v = bq.b0 * x + bq.z1;
+            bq.z1 = bq.b1 * x - bq.a1 * v + bq.z2;
+            bq.z2 = bq.b2 * x - bq.a2 * v;
+            y[i] = v;
+        }
+        sections_m[s].z1 = bq.z1;
+        sections_m[s].z2 = bq.z2;
+    }
+    for(i = 0; i < nb_samples; i++)
+        out[i] = to_count(y[i]);
+}
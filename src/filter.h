@@ -0,0 +1,116 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file filter.h
+ * @brief Declaration of Filter class.
+ * Digital filter applied to raw counts between the driver and the display:
+ * windowed-sinc FIR (low, high, band pass) or biquad IIR cascades. Filter
+ * state is kept between blocks so streamed data is filtered seamlessly.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <vector>
+
+#include "oscilloscope.h"
+
+/** @brief number of FIR taps, odd for a linear phase type I filter */
+#define FILTER_FIR_TAPS        63
+/** @brief number of biquad sections of low and high pass IIR filters */
+#define FILTER_IIR_SECTIONS    2
+
+typedef enum {
+    E_FILTER_NONE = 0,
+    E_FILTER_FIR_LOW_PASS,
+    E_FILTER_FIR_HIGH_PASS,
+    E_FILTER_FIR_BAND_PASS,
+    E_FILTER_IIR_LOW_PASS,
+    E_FILTER_IIR_HIGH_PASS,
+    E_FILTER_IIR_BAND_PASS
+}filter_type_e;
+
+typedef struct
+{
+    filter_type_e type;
+    /** @brief cutoff frequency in Hertz, lower edge for band pass */
+    double cutoff_hz;
+    /** @brief upper edge in Hertz for band pass, unused otherwise */
+    double cutoff2_hz;
+}filter_spec_t;
+
+class Filter
+{
+public:
+    Filter();
+    /**
+     * @brief set filter specification, used from next prepare
+     * @param[in] : filter specification
+     */
+    void configure(const filter_spec_t &spec);
+    /**
+     * @brief design coefficients for a sample rate if needed and clear the state,
+     * the next block primes it with its first sample
+     * @param[in] : sample interval in seconds
+     */
+    void prepare(double sample_interval);
+    /** @brief true when samples are modified by process */
+    bool active() const { return active_m; }
+    /** @brief group delay of the linear phase FIR in samples, 0 for IIR and bypass */
+    uint32_t delay() const { return (active_m && !taps_m.empty()) ? FILTER_FIR_TAPS / 2 : 0; }
+    /**
+     * @brief filter a block, continuing from the previous block
+     * @param[in] : raw ADC counts
+     * @param[out] : filtered counts, may be the input table
+     * @param[in] : number of samples
+     */
+    void process(const short *in, short *out, uint32_t nb_samples);
+    /**
+     * @brief size the work buffer for blocks up to nb_samples, process then does not allocate
+     * @param[in] : number of samples of the largest block
+     */
+    void reserve(uint32_t nb_samples);
+private:
+    typedef struct
+    {
+        float b0, b1, b2, a1, a2;
+        float z1, z2;
+    }biquad_t;
+    void design_fir(void);
+    void design_iir(void);
+    void prime(float value);
+    void process_fir(const short *in, short *out, uint32_t nb_samples);
+    void process_iir(const short *in, short *out, uint32_t nb_samples);
+    filter_spec_t spec_m;
+    double sample_interval_m;
+    bool active_m;
+    bool designed_m;
+    /** @brief state holds the signal of the run, not the zeros of prepare */
+    bool primed_m;
+    /** @brief FIR taps and the last FILTER_FIR_TAPS-1 inputs followed by the block */
+    std::vector<float> taps_m;
+    std::vector<float> history_m;
+    std::vector<biquad_t> sections_m;
+    std::vector<float> work_m;
+};
+
+#endif // FILTER_H
@@ -37,12 +37,16 @@
 #include <QShortcut>
 #include <QWidget>
 #include <QComboBox>
+#include <QDateTime>
+#include <QFileDialog>
 #include <QStatusBar>
 #include <QtGui>
 
 #include "screen.h"
 #include "frontpanel.h"
 #include "comborange.h"
+#include "decoderview.h"
+#include "analysisview.h"
 
 
 FrontPanel::FrontPanel(QWidget *parent)
@@ -66,12 +70,40 @@ FrontPanel::FrontPanel(QWidget *parent)
     current_m = NULL;
     time_m = NULL;
     trigger_m = NULL;
+    mode_m = NULL;
+    math_m = NULL;
+    filter_m = NULL;
+    average_m = NULL;
+    decoder_m = NULL;
+    mask_m = NULL;
+    mask_results_m = NULL;
+    mask_timer_m = NULL;
+    mask_failure_m = NULL;
+    analysis_m = NULL;
+    analysis_view_m = NULL;
+    analysis_timer_m = NULL;
+    history_budget_m = NULL;
+    history_m = NULL;
+    history_label_m = NULL;
+    history_timer_m = NULL;
+    export_m = NULL;
+    exporter_m = NULL;
+    export_timer_m = NULL;
 
     /* initialize items */
     volt_items_m = NULL;
     current_items_m = NULL;
     time_items_m = NULL;
     trigger_items_m = NULL;
+    mode_items_m = NULL;
+    math_items_m = NULL;
+    filter_items_m = NULL;
+    average_items_m = NULL;
+    decoder_items_m = NULL;
+    mask_items_m = NULL;
+    analysis_items_m = NULL;
+    history_budget_items_m = NULL;
+    export_items_m = NULL;
 
     /* initialize spinbox */
     trigger_value_m = NULL;
@@ -158,6 +190,100 @@ FrontPanel::FrontPanel(QWidget *parent)
     // set screen values
     setTriggerChanged(0);
 
+    mode_m = new ComboRange(tr("MODE"));
+    for(uint32_t i = 0; i < mode_items_m->size(); i++)
+        mode_m->setValue(i, (mode_items_m->at(i)).name.c_str());
+    // connect mode combo to the font panel
+    connect(mode_m, SIGNAL(valueChanged(int)), this, SLOT(setModeChanged(int)));
+    leftLayout->addWidget(mode_m);
+
+    math_m = new ComboRange(tr("MATH"));
+    for(uint32_t i = 0; i < math_items_m->size(); i++)
+        math_m->setValue(i, math_items_m->at(i).c_str());
+    // connect math combo to the font panel
+    connect(math_m, SIGNAL(valueChanged(int)), this, SLOT(setMathChanged(int)));
+    leftLayout->addWidget(math_m);
+
+    filter_m = new ComboRange(tr("FILTER"));
+    for(uint32_t i = 0; i < filter_items_m->size(); i++)
+        filter_m->setValue(i, (filter_items_m->at(i)).name.c_str());
+    // connect filter combo to the font panel
+    connect(filter_m, SIGNAL(valueChanged(int)), this, SLOT(setFilterChanged(int)));
+    leftLayout->addWidget(filter_m);
+
+    average_m = new ComboRange(tr("AVERAGE"));
+    for(uint32_t i = 0; i < average_items_m->size(); i++)
+        average_m->setValue(i, (average_items_m->at(i)).name.c_str());
+    // connect average combo to the font panel
+    connect(average_m, SIGNAL(valueChanged(int)), this, SLOT(setAverageChanged(int)));
+    leftLayout->addWidget(average_m);
+
+    decoder_m = new ComboRange(tr("DECODE"));
+    for(uint32_t i = 0; i < decoder_items_m->size(); i++)
+        decoder_m->setValue(i, (decoder_items_m->at(i)).name.c_str());
+    // connect decoder combo to the font panel
+    connect(decoder_m, SIGNAL(valueChanged(int)), this, SLOT(setDecoderChanged(int)));
+    leftLayout->addWidget(decoder_m);
+
+    mask_m = new ComboRange(tr("MASK"));
+    for(uint32_t i = 0; i < mask_items_m->size(); i++)
+        mask_m->setValue(i, (mask_items_m->at(i)).name.c_str());
+    // connect mask combo to the font panel
+    connect(mask_m, SIGNAL(valueChanged(int)), this, SLOT(setMaskChanged(int)));
+    leftLayout->addWidget(mask_m);
+    mask_results_m = new QLabel;
+    mask_results_m->setAlignment(Qt::AlignHCenter);
+    leftLayout->addWidget(mask_results_m);
+    mask_timer_m = new QTimer(this);
+    connect(mask_timer_m, SIGNAL(timeout()), this, SLOT(updateMaskResults()));
+    mask_failure_m = new QSpinBox;
+    mask_failure_m->setRange(0, 0);
+    mask_failure_m->setPrefix(tr("FAIL -"));
+    mask_failure_m->setSpecialValueText(tr("Live"));
+    connect(mask_failure_m, SIGNAL(valueChanged(int)), this, SLOT(setMaskFailureChanged(int)));
+    leftLayout->addWidget(mask_failure_m);
+
+    analysis_m = new ComboRange(tr("ANALYSIS"));
+    for(uint32_t i = 0; i < analysis_items_m->size(); i++)
+        analysis_m->setValue(i, (analysis_items_m->at(i)).name.c_str());
+    // connect analysis combo to the font panel
+    connect(analysis_m, SIGNAL(valueChanged(int)), this, SLOT(setAnalysisChanged(int)));
+    leftLayout->addWidget(analysis_m);
+    analysis_timer_m = new QTimer(this);
+    connect(analysis_timer_m, SIGNAL(timeout()), this, SLOT(updateAnalysis()));
+
+    history_budget_m = new ComboRange(tr("HISTORY"));
+    for(uint32_t i = 0; i < history_budget_items_m->size(); i++)
+        history_budget_m->setValue(i, (history_budget_items_m->at(i)).name.c_str());
+    // connect history combo to the font panel
+    connect(history_budget_m, SIGNAL(valueChanged(int)), this, SLOT(setHistoryBudgetChanged(int)));
+    leftLayout->addWidget(history_budget_m);
+
+    export_m = new ComboRange(tr("EXPORT"));
+    for(uint32_t i = 0; i < export_items_m->size(); i++)
+        export_m->setValue(i, (export_items_m->at(i)).name.c_str());
+    // connect export combo to the font panel
+    connect(export_m, SIGNAL(valueChanged(int)), this, SLOT(setExportChanged(int)));
+    leftLayout->addWidget(export_m);
+    exporter_m = new Exporter();
+    // any change of the configuration is kept for the next start
+    connect(volt_channel_A_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(volt_channel_B_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(time_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(current_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(trigger_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(trigger_value_m, SIGNAL(valueChanged(double)), this, SLOT(saveSession()));
+    connect(mode_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(math_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(filter_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(average_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(decoder_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(mask_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(analysis_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    connect(history_budget_m, SIGNAL(valueChanged(int)), this, SLOT(saveSession()));
+    export_timer_m = new QTimer(this);
+    connect(export_timer_m, SIGNAL(timeout()), this, SLOT(updateExportProgress()));
+
     screenBox->setFrameStyle(QFrame::WinPanel | QFrame::Sunken);
 
     (void) new QShortcut(Qt::CTRL + Qt::Key_Q, this, SLOT(close()));
@@ -165,6 +291,24 @@ FrontPanel::FrontPanel(QWidget *parent)
     topLayout->addStretch(1);
 
     screenLayout->addWidget(screen_m);
+    // scrollback: rightmost is live, each step left is one capture older
+    QHBoxLayout *historyLayout = new QHBoxLayout;
+    history_m = new QSlider(Qt::Horizontal);
+    history_m->setInvertedAppearance(true);
+    history_m->setRange(0, 0);
+    connect(history_m, SIGNAL(valueChanged(int)), this, SLOT(setHistoryChanged(int)));
+    historyLayout->addWidget(history_m, 1);
+    history_label_m = new QLabel(tr("Live"));
+    historyLayout->addWidget(history_label_m);
+    screenLayout->addLayout(historyLayout);
+    history_timer_m = new QTimer(this);
+    connect(history_timer_m, SIGNAL(timeout()), this, SLOT(updateHistoryRange()));
+    history_timer_m->start(500);
+    decoder_view_m = new DecoderView(screen_m);
+    screenLayout->addWidget(decoder_view_m);
+    analysis_view_m = new AnalysisView;
+    analysis_view_m->setVisible(false);
+    screenLayout->addWidget(analysis_view_m);
     screenBox->setLayout(screenLayout);
 
     gridLayout->addLayout(topLayout, 0, 1);
@@ -189,6 +333,13 @@ FrontPanel::FrontPanel(QWidget *parent)
             SIGNAL(newStatusBarMessage(QString)), 
             this,
             SLOT(setStatusBarMessage(QString)));
+    connect(searchForAcquisitionDeviceWorker,
+            SIGNAL(deviceFound()),
+            this,
+            SLOT(setDeviceFound()));
+    // the family of the last session is probed first
+    QSettings settings(SETTINGS_ORGANIZATION, SETTINGS_APPLICATION);
+    Acquisition::set_preferred_family(settings.value("session/family").toString().toLocal8Bit().constData());
     searchForAcquisitionDeviceWorker->moveToThread(searchForAcquisitionDeviceThread);
     searchForAcquisitionDeviceThread->start();
 }
@@ -206,6 +357,28 @@ FrontPanel::~FrontPanel()
         delete time_m;
     if( NULL != trigger_m )
         delete trigger_m;
+    if( NULL != mode_m )
+        delete mode_m;
+    if( NULL != math_m )
+        delete math_m;
+    if( NULL != filter_m )
+        delete filter_m;
+    if( NULL != average_m )
+        delete average_m;
+    if( NULL != decoder_m )
+        delete decoder_m;
+    if( NULL != mask_m )
+        delete mask_m;
+    if( NULL != mask_results_m )
+        delete mask_results_m;
+    if( NULL != mask_failure_m )
+        delete mask_failure_m;
+    if( NULL != analysis_m )
+        delete analysis_m;
+    if( NULL != history_budget_m )
+        delete history_budget_m;
+    if( NULL != export_m )
+        delete export_m;
 
     /* delete items */
     if( NULL != volt_items_m )
@@ -216,9 +389,31 @@ FrontPanel::~FrontPanel()
         delete time_items_m;
     if( NULL != trigger_items_m )
         delete trigger_items_m;
+    if( NULL != mode_items_m )
+        delete mode_items_m;
+    if( NULL != math_items_m )
+        delete math_items_m;
+    if( NULL != filter_items_m )
+        delete filter_items_m;
+    if( NULL != average_items_m )
+        delete average_items_m;
+    if( NULL != decoder_items_m )
+        delete decoder_items_m;
+    if( NULL != mask_items_m )
+        delete mask_items_m;
+    if( NULL != analysis_items_m )
+        delete analysis_items_m;
+    if( NULL != history_budget_items_m )
+        delete history_budget_items_m;
+    if( NULL != export_items_m )
+        delete export_items_m;
     if( NULL != trigger_value_m )
         delete trigger_value_m;
 
+    /* a running export may read the acquisition record */
+    if( NULL != exporter_m )
+        delete exporter_m;
+
     /* delete acquisition */
     if(NULL != acquisition_m)
     {
@@ -234,6 +429,7 @@ void FrontPanel::create_menu_items()
     time_item_t new_time_item;
     current_item_t new_current_item;
     trigger_item_t new_trigger_item;
+    mode_item_t new_mode_item;
 
     /* create voltage items */
     volt_items_m = new std::vector<volt_item_t>();
@@ -384,6 +580,222 @@ void FrontPanel::create_menu_items()
     new_trigger_item.value = E_TRIGGER_FALLING;
     trigger_items_m->push_back(new_trigger_item);
 
+    /* create acquisition mode items */
+    mode_items_m = new std::vector<mode_item_t>();
+    new_mode_item.name = "Block";
+    new_mode_item.value = E_ACQUISITION_BLOCK;
+    mode_items_m->push_back(new_mode_item);
+    new_mode_item.name = "Fast streaming";
+    new_mode_item.value = E_ACQUISITION_FAST_STREAMING;
+    mode_items_m->push_back(new_mode_item);
+    new_mode_item.name = "Roll";
+    new_mode_item.value = E_ACQUISITION_ROLL;
+    mode_items_m->push_back(new_mode_item);
+    new_mode_item.name = "ETS";
+    new_mode_item.value = E_ACQUISITION_ETS;
+    mode_items_m->push_back(new_mode_item);
+
+    /* create math channel presets */
+    math_items_m = new std::vector<std::string>();
+    math_items_m->push_back("Off");
+    math_items_m->push_back("A+B");
+    math_items_m->push_back("A-B");
+    math_items_m->push_back("A*B");
+    math_items_m->push_back("A/B");
+    math_items_m->push_back("-1*A");
+    math_items_m->push_back("abs(A)");
+    math_items_m->push_back("intg(A)");
+    math_items_m->push_back("diff(A)");
+
+    /* create filter presets */
+    filter_items_m = new std::vector<filter_item_t>();
+    filter_item_t new_filter_item;
+    new_filter_item.name = "Off";
+    new_filter_item.value.type = E_FILTER_NONE;
+    new_filter_item.value.cutoff_hz = 0.;
+    new_filter_item.value.cutoff2_hz = 0.;
+    filter_items_m->push_back(new_filter_item);
+    new_filter_item.name = "FIR LP 10kHz";
+    new_filter_item.value.type = E_FILTER_FIR_LOW_PASS;
+    new_filter_item.value.cutoff_hz = 10e3;
+    filter_items_m->push_back(new_filter_item);
+    new_filter_item.name = "FIR LP 100kHz";
+    new_filter_item.value.type = E_FILTER_FIR_LOW_PASS;
+    new_filter_item.value.cutoff_hz = 100e3;
+    filter_items_m->push_back(new_filter_item);
+    new_filter_item.name = "IIR LP 10kHz";
+    new_filter_item.value.type = E_FILTER_IIR_LOW_PASS;
+    new_filter_item.value.cutoff_hz = 10e3;
+    filter_items_m->push_back(new_filter_item);
+    new_filter_item.name = "IIR HP 50Hz";
+    new_filter_item.value.type = E_FILTER_IIR_HIGH_PASS;
+    new_filter_item.value.cutoff_hz = 50.;
+    filter_items_m->push_back(new_filter_item);
+    new_filter_item.name = "FIR BP 1-10kHz";
+    new_filter_item.value.type = E_FILTER_FIR_BAND_PASS;
+    new_filter_item.value.cutoff_hz = 1e3;
+    new_filter_item.value.cutoff2_hz = 10e3;
+    filter_items_m->push_back(new_filter_item);
+
+    /* create protocol decoder presets, analog lines switch at 1.65V (3.3V logic) */
+    decoder_items_m = new std::vector<decoder_item_t>();
+    decoder_item_t new_decoder_item;
+    new_decoder_item.name = "Off";
+    new_decoder_item.value.protocol = E_DECODER_NONE;
+    new_decoder_item.value.digital = 0;
+    new_decoder_item.value.lines[0] = DECODER_NO_LINE;
+    new_decoder_item.value.lines[1] = DECODER_NO_LINE;
+    new_decoder_item.value.lines[2] = DECODER_NO_LINE;
+    new_decoder_item.value.threshold = 1.65;
+    new_decoder_item.value.hysteresis = 0.2;
+    new_decoder_item.value.baud_rate = 0.;
+    decoder_items_m->push_back(new_decoder_item);
+    new_decoder_item.name = "UART 9600 A";
+    new_decoder_item.value.protocol = E_DECODER_UART;
+    new_decoder_item.value.lines[0] = Acquisition::CHANNEL_A;
+    new_decoder_item.value.baud_rate = 9600.;
+    decoder_items_m->push_back(new_decoder_item);
+    new_decoder_item.name = "UART 115200 A";
+    new_decoder_item.value.baud_rate = 115200.;
+    decoder_items_m->push_back(new_decoder_item);
+    new_decoder_item.name = "SPI A clk B data";
+    new_decoder_item.value.protocol = E_DECODER_SPI;
+    new_decoder_item.value.lines[0] = Acquisition::CHANNEL_A;
+    new_decoder_item.value.lines[1] = Acquisition::CHANNEL_B;
+    decoder_items_m->push_back(new_decoder_item);
+    new_decoder_item.name = "I2C A scl B sda";
+    new_decoder_item.value.protocol = E_DECODER_I2C;
+    decoder_items_m->push_back(new_decoder_item);
+    new_decoder_item.name = "UART 115200 D0";
+    new_decoder_item.value.protocol = E_DECODER_UART;
+    new_decoder_item.value.digital = 1;
+    new_decoder_item.value.lines[0] = 0;
+    new_decoder_item.value.lines[1] = DECODER_NO_LINE;
+    decoder_items_m->push_back(new_decoder_item);
+    new_decoder_item.name = "SPI D0 clk D1 data D2 cs";
+    new_decoder_item.value.protocol = E_DECODER_SPI;
+    new_decoder_item.value.lines[1] = 1;
+    new_decoder_item.value.lines[2] = 2;
+    decoder_items_m->push_back(new_decoder_item);
+    new_decoder_item.name = "I2C D0 scl D1 sda";
+    new_decoder_item.value.protocol = E_DECODER_I2C;
+    new_decoder_item.value.lines[2] = DECODER_NO_LINE;
+    decoder_items_m->push_back(new_decoder_item);
+
+    /* create averaging presets, block captures only */
+    average_items_m = new std::vector<average_item_t>();
+    average_item_t new_average_item;
+    new_average_item.name = "Off";
+    new_average_item.value.mode = E_AVERAGE_NONE;
+    new_average_item.value.captures = 2;
+    average_items_m->push_back(new_average_item);
+    new_average_item.name = "Average 16";
+    new_average_item.value.mode = E_AVERAGE_RUNNING;
+    new_average_item.value.captures = 16;
+    average_items_m->push_back(new_average_item);
+    new_average_item.name = "Average 1024";
+    new_average_item.value.captures = 1024;
+    average_items_m->push_back(new_average_item);
+    new_average_item.name = "Exponential 1/16";
+    new_average_item.value.mode = E_AVERAGE_EXPONENTIAL;
+    new_average_item.value.captures = 16;
+    average_items_m->push_back(new_average_item);
+    new_average_item.name = "Envelope";
+    new_average_item.value.mode = E_AVERAGE_ENVELOPE;
+    average_items_m->push_back(new_average_item);
+
+    /* create mask presets, on channel A, reference is the next capture */
+    mask_items_m = new std::vector<mask_item_t>();
+    mask_item_t new_mask_item;
+    new_mask_item.name = "Off";
+    new_mask_item.value.mode = E_MASK_NONE;
+    new_mask_item.value.channel = Acquisition::CHANNEL_A;
+    new_mask_item.value.tolerance_volts = 0.;
+    new_mask_item.value.tolerance_samples = 0;
+    mask_items_m->push_back(new_mask_item);
+    new_mask_item.name = "Ref +/-0.1V";
+    new_mask_item.value.mode = E_MASK_REFERENCE;
+    new_mask_item.value.tolerance_volts = 0.1;
+    mask_items_m->push_back(new_mask_item);
+    new_mask_item.name = "Ref +/-0.5V";
+    new_mask_item.value.tolerance_volts = 0.5;
+    mask_items_m->push_back(new_mask_item);
+    new_mask_item.name = "Ref +/-0.5V +/-4 samples";
+    new_mask_item.value.tolerance_samples = 4;
+    mask_items_m->push_back(new_mask_item);
+    // limits are read from a file chosen when the item is selected
+    new_mask_item.name = "Polygon file";
+    new_mask_item.value.mode = E_MASK_POLYGON;
+    new_mask_item.value.tolerance_volts = 0.;
+    new_mask_item.value.tolerance_samples = 0;
+    mask_items_m->push_back(new_mask_item);
+
+    /* create analysis presets, the eye folds channel A at a recovered or usual serial symbol period */
+    analysis_items_m = new std::vector<analysis_item_t>();
+    analysis_item_t new_analysis_item;
+    new_analysis_item.name = "Off";
+    new_analysis_item.value.mode = E_ANALYSIS_NONE;
+    new_analysis_item.value.channel = Acquisition::CHANNEL_A;
+    new_analysis_item.value.shift = 8;
+    new_analysis_item.value.symbol_period = 0.;
+    new_analysis_item.value.columns = 256;
+    analysis_items_m->push_back(new_analysis_item);
+    new_analysis_item.name = "Histogram";
+    new_analysis_item.value.mode = E_ANALYSIS_HISTOGRAM;
+    analysis_items_m->push_back(new_analysis_item);
+    new_analysis_item.name = "Eye auto";
+    new_analysis_item.value.mode = E_ANALYSIS_EYE;
+    analysis_items_m->push_back(new_analysis_item);
+    new_analysis_item.name = "Eye 1 us";
+    new_analysis_item.value.symbol_period = 1e-6;
+    analysis_items_m->push_back(new_analysis_item);
+    new_analysis_item.name = "Eye 115200 bd";
+    new_analysis_item.value.symbol_period = 1. / 115200.;
+    analysis_items_m->push_back(new_analysis_item);
+    new_analysis_item.name = "Eye 9600 bd";
+    new_analysis_item.value.symbol_period = 1. / 9600.;
+    analysis_items_m->push_back(new_analysis_item);
+
+    /* create history budgets, the acquisition starts with the first one */
+    history_budget_items_m = new std::vector<history_budget_item_t>();
+    history_budget_item_t new_history_budget_item;
+    new_history_budget_item.name = "64 MB";
+    new_history_budget_item.value = WAVEFORM_HISTORY_BUDGET;
+    history_budget_items_m->push_back(new_history_budget_item);
+    new_history_budget_item.name = "256 MB";
+    new_history_budget_item.value = 256 * 1024 * 1024;
+    history_budget_items_m->push_back(new_history_budget_item);
+    new_history_budget_item.name = "16 MB";
+    new_history_budget_item.value = 16 * 1024 * 1024;
+    history_budget_items_m->push_back(new_history_budget_item);
+    new_history_budget_item.name = "Off";
+    new_history_budget_item.value = 0;
+    history_budget_items_m->push_back(new_history_budget_item);
+
+    /* create export formats, first item is the idle combo */
+    export_items_m = new std::vector<export_item_t>();
+    export_item_t new_export_item;
+    new_export_item.name = "-";
+    new_export_item.filter = "";
+    new_export_item.value = E_EXPORT_CSV;
+    export_items_m->push_back(new_export_item);
+    new_export_item.name = "CSV";
+    new_export_item.filter = "CSV files (*.csv)";
+    new_export_item.value = E_EXPORT_CSV;
+    export_items_m->push_back(new_export_item);
+    new_export_item.name = "Raw";
+    new_export_item.filter = "Raw 16 bits files (*.raw *.bin)";
+    new_export_item.value = E_EXPORT_RAW;
+    export_items_m->push_back(new_export_item);
+    new_export_item.name = "WAV";
+    new_export_item.filter = "Wave files (*.wav)";
+    new_export_item.value = E_EXPORT_WAV;
+    export_items_m->push_back(new_export_item);
+    new_export_item.name = "MATLAB";
+    new_export_item.filter = "MATLAB files (*.mat)";
+    new_export_item.value = E_EXPORT_MAT;
+    export_items_m->push_back(new_export_item);
+
 }
 
 void FrontPanel::setVoltChannelAChanged(int comboIndex)
@@ -470,7 +882,434 @@ void FrontPanel::setTriggerChanged(double trigger_value)
     setTriggerChanged(trigger_m->value());
 }
 
+void FrontPanel::setModeChanged(int comboIndex)
+{
+    DEBUG("Combo index %d\n", comboIndex);
+    if( NULL != acquisition_m )
+    {
+        acquisition_m->stop();
+        acquisition_m->set_acquisition_mode((mode_items_m->at(comboIndex)).value);
+        acquisition_m->start();
+    }
+}
+
+void FrontPanel::setMathChanged(int comboIndex)
+{
+    DEBUG("Combo index %d\n", comboIndex);
+    if( NULL != acquisition_m )
+    {
+        // no need to restart, the expression is used from the next frame
+        acquisition_m->set_math_expression(math_items_m->at(comboIndex));
+    }
+}
+
+void FrontPanel::setFilterChanged(int comboIndex)
+{
+    DEBUG("Combo index %d\n", comboIndex);
+    if( NULL != acquisition_m )
+    {
+        // no need to restart, the filter is redesigned in place
+        acquisition_m->set_filter((filter_items_m->at(comboIndex)).value);
+    }
+}
+
+void FrontPanel::setAverageChanged(int comboIndex)
+{
+    DEBUG("Combo index %d\n", comboIndex);
+    if( NULL != acquisition_m )
+    {
+        // no need to restart, the average restarts on the next capture
+        acquisition_m->set_averaging((average_items_m->at(comboIndex)).value);
+    }
+}
+
+void FrontPanel::setDecoderChanged(int comboIndex)
+{
+    DEBUG("Combo index %d\n", comboIndex);
+    if( NULL != acquisition_m )
+    {
+        // no need to restart, the decoder starts on the next samples
+        acquisition_m->set_decoder((decoder_items_m->at(comboIndex)).value);
+    }
+}
+
+int8_t FrontPanel::maskSpec(int comboIndex, mask_spec_t *spec)
+{
+    *spec = (mask_items_m->at(comboIndex)).value;
+    if( E_MASK_POLYGON == spec->mode )
+    {
+        return MaskTest::load_polygon(mask_polygon_m.toLocal8Bit().constData(), spec);
+    }
+    return 0;
+}
+
+void FrontPanel::setMaskChanged(int comboIndex)
+{
+    mask_spec_t spec;
+    QString path;
+
+    DEBUG("Combo index %d\n", comboIndex);
+    if( E_MASK_POLYGON == (mask_items_m->at(comboIndex)).value.mode )
+    {
+        path = QFileDialog::getOpenFileName(this, tr("Polygon mask"), mask_polygon_m,
+                                            tr("Mask limits (*.txt);;All files (*)"));
+        if( path.isEmpty() )
+        {
+            // no file chosen: the mask is turned off
+            mask_m->setCurrentIndex(0);
+            return;
+        }
+        mask_polygon_m = path;
+    }
+    if( 0 != maskSpec(comboIndex, &spec) )
+    {
+        setStatusBarMessage(tr("Cannot read polygon mask %1").arg(mask_polygon_m));
+        mask_m->setCurrentIndex(0);
+        return;
+    }
+    if( NULL != acquisition_m )
+    {
+        // no need to restart, the mask applies to the next capture
+        acquisition_m->set_mask(spec);
+    }
+    mask_failure_m->setValue(0);
+    mask_failure_m->setMaximum(0);
+    if( E_MASK_NONE == spec.mode )
+    {
+        mask_timer_m->stop();
+        mask_results_m->clear();
+    }
+    else
+    {
+        mask_timer_m->start(500);
+    }
+}
+
+void FrontPanel::updateMaskResults()
+{
+    uint32_t passed = 0;
+    uint32_t failed = 0;
+
+    if( NULL != acquisition_m )
+    {
+        acquisition_m->get_mask_results(&passed, &failed);
+        mask_results_m->setText(QString("PASS %1 / FAIL %2").arg(passed).arg(failed));
+        // the last MASK_FAILURE_HISTORY failures are kept, whatever the history evicted
+        mask_failure_m->setMaximum( (failed < (uint32_t)MASK_FAILURE_HISTORY) ? (int)failed : MASK_FAILURE_HISTORY );
+    }
+}
+
+void FrontPanel::setMaskFailureChanged(int index)
+{
+    mask_failure_t failure;
+    sample_frame_t frame;
+
+    if( (0 == index) || (NULL == acquisition_m) ||
+        (0 != acquisition_m->get_mask_failure(index - 1, &failure, mask_failure_samples_m)) )
+    {
+        // back to the scrollback position
+        setHistoryChanged(history_m->value());
+        return;
+    }
+    memset(&frame, 0, sizeof(frame));
+    frame.sequence = failure.sequence;
+    frame.channels = (1 << failure.channel);
+    frame.blocks[failure.channel] = failure.block;
+    screen_m->showFrame(&frame);
+    history_label_m->setText(tr("FAIL -%1  %2 samples out from %3").arg(index).arg(failure.violations).arg(failure.first_violation));
+}
+
+void FrontPanel::setAnalysisChanged(int comboIndex)
+{
+    DEBUG("Combo index %d\n", comboIndex);
+    if( NULL != acquisition_m )
+    {
+        // no need to restart, accumulation starts on the next capture
+        acquisition_m->set_analysis((analysis_items_m->at(comboIndex)).value);
+    }
+    if( E_ANALYSIS_NONE == (analysis_items_m->at(comboIndex)).value.mode )
+    {
+        analysis_timer_m->stop();
+        analysis_view_m->setVisible(false);
+    }
+    else
+    {
+        analysis_view_m->setVisible(true);
+        analysis_timer_m->start(500);
+    }
+}
+
+void FrontPanel::updateAnalysis()
+{
+    if( NULL != acquisition_m )
+    {
+        acquisition_m->get_analysis(&analysis_result_m);
+        analysis_view_m->setResult(analysis_result_m);
+    }
+}
+
+void FrontPanel::setHistoryBudgetChanged(int comboIndex)
+{
+    DEBUG("Combo index %d\n", comboIndex);
+    if( NULL != acquisition_m )
+    {
+        // no need to restart, kept captures are dropped
+        acquisition_m->set_history_budget((history_budget_items_m->at(comboIndex)).value);
+    }
+    history_m->setValue(0);
+    updateHistoryRange();
+}
+
+void FrontPanel::setHistoryChanged(int age)
+{
+    history_frame_t kept;
+    QDateTime when;
+
+    // a kept capture replaces the recalled failure on screen
+    mask_failure_m->blockSignals(true);
+    mask_failure_m->setValue(0);
+    mask_failure_m->blockSignals(false);
+    if( (0 == age) || (NULL == acquisition_m) ||
+        (0 != acquisition_m->get_history_frame(age, &kept, history_samples_m, history_times_m)) )
+    {
+        screen_m->showLive();
+        history_label_m->setText(tr("Live"));
+        return;
+    }
+    // acquisition goes on, its frames are not drawn while a kept one is shown
+    screen_m->showFrame(&kept.frame);
+    when = QDateTime::fromTime_t((uint)kept.timestamp).addMSecs((qint64)((kept.timestamp - (uint)kept.timestamp) * 1000));
+    history_label_m->setText(QString("-%1  %2%3").arg(age).arg(when.toString("hh:mm:ss.zzz")).arg(kept.failed ? tr("  FAIL") : QString()));
+}
+
+void FrontPanel::updateHistoryRange()
+{
+    uint32_t count = 0;
+
+    if( NULL != acquisition_m )
+    {
+        count = acquisition_m->get_history_count();
+    }
+    history_m->setMaximum( (count > 0) ? (int)(count - 1) : 0 );
+}
+
+void FrontPanel::setExportChanged(int comboIndex)
+{
+    acquisition_mode_e mode = E_ACQUISITION_BLOCK;
+    FrameExportSource *frame = NULL;
+    RecordExportSource *record = NULL;
+    ExportSource *source = NULL;
+    QString path;
+
+    DEBUG("Combo index %d\n", comboIndex);
+    if( (0 == comboIndex) || (NULL == acquisition_m) )
+    {
+        return;
+    }
+    if( exporter_m->busy() )
+    {
+        setStatusBarMessage(tr("An export is already running"));
+        export_m->setCurrentIndex(0);
+        return;
+    }
+    path = QFileDialog::getSaveFileName(this, tr("Export"), QString(),
+                                        tr((export_items_m->at(comboIndex)).filter.c_str()));
+    if( !path.isEmpty() )
+    {
+        // streaming modes export their whole record, block modes the capture on screen
+        mode = (mode_items_m->at(mode_m->value())).value;
+        if( (E_ACQUISITION_FAST_STREAMING == mode) || (E_ACQUISITION_ROLL == mode) )
+        {
+            record = new RecordExportSource();
+            source = record;
+            if( 0 != record->load(acquisition_m) )
+                source = NULL;
+        }
+        else
+        {
+            frame = new FrameExportSource();
+            source = frame;
+            if( 0 != frame->load(acquisition_m, history_m->value()) )
+                source = NULL;
+        }
+        if( NULL == source )
+        {
+            delete record;
+            delete frame;
+            setStatusBarMessage(tr("Nothing to export"));
+        }
+        else if( 0 != exporter_m->start(source, path.toLocal8Bit().constData(), (export_items_m->at(comboIndex)).value) )
+        {
+            setStatusBarMessage(tr("Cannot export to %1").arg(path));
+        }
+        else
+        {
+            setStatusBarMessage(tr("Exporting to %1").arg(path));
+            export_timer_m->start(500);
+        }
+    }
+    export_m->setCurrentIndex(0);
+}
+
+void FrontPanel::updateExportProgress()
+{
+    uint64_t done = 0;
+    uint64_t total = 0;
+
+    exporter_m->progress(&done, &total);
+    if( exporter_m->busy() )
+    {
+        setStatusBarMessage(tr("Exporting... %1%").arg((total > 0) ? (int)(100 * done / total) : 0));
+        return;
+    }
+    export_timer_m->stop();
+    setStatusBarMessage( (0 == exporter_m->result()) ? tr("Export done") : tr("Export failed") );
+}
+
 void FrontPanel::setStatusBarMessage(QString text)
 {
   ((QMainWindow*)(parent_m))->statusBar()->showMessage(text, 30000);
 }
+
+void FrontPanel::restoreCombo(QSettings &settings, const char *key, ComboRange *combo)
+{
+    int index = combo->findValue(settings.value(key).toString());
+
+    if( index >= 0 )
+    {
+        combo->blockSignals(true);
+        combo->setCurrentIndex(index);
+        combo->blockSignals(false);
+    }
+}
+
+void FrontPanel::setDeviceFound()
+{
+    Acquisition::device_info_t device_info;
+    QSettings settings(SETTINGS_ORGANIZATION, SETTINGS_APPLICATION);
+    trigger_e trigger = E_TRIGGER_AUTO;
+    mask_spec_t mask;
+
+    if( NULL == acquisition_m )
+    {
+        ERROR("no acquisition device.\n");
+        return;
+    }
+    memset(&device_info, 0, sizeof(Acquisition::device_info_t));
+    acquisition_m->get_device_info(&device_info);
+    if(device_info.nb_channels < 1)
+    {
+        // stupid if a device has no channel...
+        ERROR("This device has no channel\n");
+        volt_channel_A_m->setVisible(false);
+    }
+    if(device_info.nb_channels < 2)
+    {
+        volt_channel_B_m->setVisible(false);
+    }
+
+    // warm restart: the configuration of the last session is restored on the same model,
+    // else the front panel keeps its defaults (largest range, shortest timebase)
+    if( settings.value("session/device").toString() == QString(device_info.device_name) )
+    {
+        if( settings.value("session/serial").toString() != QString(device_info.serial) )
+        {
+            WARNING("%s serial %s is not the unit of the last session, restoring its configuration anyway.\n",
+                    device_info.device_name, device_info.serial);
+        }
+        restoreCombo(settings, "session/volt_a", volt_channel_A_m);
+        restoreCombo(settings, "session/volt_b", volt_channel_B_m);
+        restoreCombo(settings, "session/time", time_m);
+        restoreCombo(settings, "session/current", current_m);
+        restoreCombo(settings, "session/trigger", trigger_m);
+        restoreCombo(settings, "session/mode", mode_m);
+        restoreCombo(settings, "session/math", math_m);
+        restoreCombo(settings, "session/filter", filter_m);
+        restoreCombo(settings, "session/average", average_m);
+        restoreCombo(settings, "session/decoder", decoder_m);
+        restoreCombo(settings, "session/mask", mask_m);
+        mask_polygon_m = settings.value("session/mask_polygon").toString();
+        restoreCombo(settings, "session/analysis", analysis_m);
+        restoreCombo(settings, "session/history", history_budget_m);
+        trigger_value_m->blockSignals(true);
+        trigger_value_m->setValue(settings.value("session/trigger_level", 0.0).toDouble());
+        trigger_value_m->blockSignals(false);
+    }
+
+    // set screen values
+    screen_m->setVoltCaliber((volt_items_m->at(volt_channel_A_m->value())).value);
+    screen_m->setTimeCaliber((time_items_m->at(time_m->value())).value);
+    screen_m->setCurrent((current_items_m->at(current_m->value())).value);
+    trigger = (trigger_items_m->at(trigger_m->value())).value;
+    screen_m->setTrigger(trigger);
+    trigger_value_m->setVisible(E_TRIGGER_AUTO != trigger);
+    if( 0 != maskSpec(mask_m->value(), &mask) )
+    {
+        // the polygon file of the last session is gone: the mask is off
+        mask_m->blockSignals(true);
+        mask_m->setCurrentIndex(0);
+        mask_m->blockSignals(false);
+        maskSpec(0, &mask);
+    }
+    if( E_MASK_NONE != mask.mode )
+    {
+        mask_timer_m->start(500);
+    }
+    if( E_ANALYSIS_NONE != (analysis_items_m->at(analysis_m->value())).value.mode )
+    {
+        analysis_view_m->setVisible(true);
+        analysis_timer_m->start(500);
+    }
+
+    // the whole configuration is applied once, before the first capture
+    if(device_info.nb_channels >= 1)
+        acquisition_m->set_voltages(Acquisition::CHANNEL_A, (volt_items_m->at(volt_channel_A_m->value())).value);
+    if(device_info.nb_channels >= 2)
+        acquisition_m->set_voltages(Acquisition::CHANNEL_B, (volt_items_m->at(volt_channel_B_m->value())).value);
+    acquisition_m->set_timebase((time_items_m->at(time_m->value())).value);
+    acquisition_m->set_DC_coupled((current_items_m->at(current_m->value())).value);
+    acquisition_m->set_trigger(trigger, trigger_value_m->value());
+    acquisition_m->set_acquisition_mode((mode_items_m->at(mode_m->value())).value);
+    acquisition_m->set_math_expression(math_items_m->at(math_m->value()));
+    acquisition_m->set_filter((filter_items_m->at(filter_m->value())).value);
+    acquisition_m->set_averaging((average_items_m->at(average_m->value())).value);
+    acquisition_m->set_decoder((decoder_items_m->at(decoder_m->value())).value);
+    acquisition_m->set_mask(mask);
+    acquisition_m->set_analysis((analysis_items_m->at(analysis_m->value())).value);
+    acquisition_m->set_history_budget((history_budget_items_m->at(history_budget_m->value())).value);
+    acquisition_m->start();
+
+    saveSession();
+}
+
+void FrontPanel::saveSession()
+{
+    Acquisition::device_info_t device_info;
+
+    // nothing to keep till the device is configured
+    if( NULL == acquisition_m )
+    {
+        return;
+    }
+    QSettings settings(SETTINGS_ORGANIZATION, SETTINGS_APPLICATION);
+    memset(&device_info, 0, sizeof(Acquisition::device_info_t));
+    acquisition_m->get_device_info(&device_info);
+    settings.setValue("session/family", QString(Acquisition::get_family().c_str()));
+    settings.setValue("session/device", QString(device_info.device_name));
+    settings.setValue("session/serial", QString(device_info.serial));
+    settings.setValue("session/volt_a", volt_channel_A_m->currentValueText());
+    settings.setValue("session/volt_b", volt_channel_B_m->currentValueText());
+    settings.setValue("session/time", time_m->currentValueText());
+    settings.setValue("session/current", current_m->currentValueText());
+    settings.setValue("session/trigger", trigger_m->currentValueText());
+    settings.setValue("session/trigger_level", trigger_value_m->value());
+    settings.setValue("session/mode", mode_m->currentValueText());
+    settings.setValue("session/math", math_m->currentValueText());
+    settings.setValue("session/filter", filter_m->currentValueText());
+    settings.setValue("session/average", average_m->currentValueText());
+    settings.setValue("session/decoder", decoder_m->currentValueText());
+    settings.setValue("session/mask", mask_m->currentValueText());
+    settings.setValue("session/mask_polygon", mask_polygon_m);
+    settings.setValue("session/analysis", analysis_m->currentValueText());
+    settings.setValue("session/history", history_budget_m->currentValueText());
+}
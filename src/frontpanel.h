@@ -34,17 +34,25 @@
 #include <QFrame>
 #include <QGridLayout>
 #include <QHBoxLayout>
+#include <QLabel>
+#include <QSettings>
+#include <QSlider>
+#include <QSpinBox>
 #include <QThread>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <string>
 #include <vector>
 
 #include "oscilloscope.h"
 #include "acquisition.h"
+#include "exporter.h"
 #include "search-for-acquisition-device-worker.h"
 
 class ComboRange;
 class Screen;
+class DecoderView;
+class AnalysisView;
 
 class FrontPanel : public QWidget
 {
@@ -68,11 +76,42 @@ protected slots:
     void setCurrentChanged(int);
     void setTriggerChanged(int);
     void setTriggerChanged(double);
+    void setModeChanged(int);
+    void setMathChanged(int);
+    void setFilterChanged(int);
+    void setAverageChanged(int);
+    void setDecoderChanged(int);
+    void setMaskChanged(int);
+    void updateMaskResults();
+    void setMaskFailureChanged(int);
+    void setAnalysisChanged(int);
+    void updateAnalysis();
+    void setHistoryBudgetChanged(int);
+    void setHistoryChanged(int);
+    void updateHistoryRange();
+    void setExportChanged(int);
+    void updateExportProgress();
     void setStatusBarMessage(QString);
+    void setDeviceFound(void);
+    void saveSession(void);
 
 private:
     /** @brief create menu items */
     void create_menu_items();
+    /**
+     * @brief select the combo item saved under a key, with the combo signals blocked
+     * @param[in] settings of the last session
+     * @param[in] key of the item name
+     * @param[in] combo to update, it keeps its current item if the name is not found
+     */
+    void restoreCombo(QSettings &settings, const char *key, ComboRange *combo);
+    /**
+     * @brief get the mask of a combo item, polygon limits are read from mask_polygon_m
+     * @param[in] mask combo index
+     * @param[out] mask specification
+     * return : 0 if successful, -1 if the polygon file cannot be read
+     */
+    int8_t maskSpec(int comboIndex, mask_spec_t *spec);
     /** @brief acquisition device search thread */
     QThread* searchForAcquisitionDeviceThread;
     /** @brief acquisition device search class */
@@ -116,6 +155,96 @@ private:
     }trigger_item_t;
     std::vector<trigger_item_t> *trigger_items_m;
     QDoubleSpinBox *trigger_value_m;
+    /** @brief acquisition mode selection on the front panel */
+    ComboRange *mode_m;
+    typedef struct
+    {
+        std::string name;
+        acquisition_mode_e value;
+    }mode_item_t;
+    std::vector<mode_item_t> *mode_items_m;
+    /** @brief math channel selection on the front panel */
+    ComboRange *math_m;
+    std::vector<std::string> *math_items_m;
+    /** @brief filter selection on the front panel */
+    ComboRange *filter_m;
+    typedef struct
+    {
+        std::string name;
+        filter_spec_t value;
+    }filter_item_t;
+    std::vector<filter_item_t> *filter_items_m;
+    /** @brief block captures averaging selection on the front panel */
+    ComboRange *average_m;
+    typedef struct
+    {
+        std::string name;
+        average_spec_t value;
+    }average_item_t;
+    std::vector<average_item_t> *average_items_m;
+    /** @brief protocol decoder selection on the front panel */
+    ComboRange *decoder_m;
+    typedef struct
+    {
+        std::string name;
+        decoder_spec_t value;
+    }decoder_item_t;
+    std::vector<decoder_item_t> *decoder_items_m;
+    DecoderView *decoder_view_m;
+    /** @brief pass/fail mask selection and results on the front panel */
+    ComboRange *mask_m;
+    typedef struct
+    {
+        std::string name;
+        mask_spec_t value;
+    }mask_item_t;
+    std::vector<mask_item_t> *mask_items_m;
+    QLabel *mask_results_m;
+    QTimer *mask_timer_m;
+    /* file of the polygon mask limits */
+    QString mask_polygon_m;
+    /** @brief recall of the last failed captures, 0 is live */
+    QSpinBox *mask_failure_m;
+    /* copy of the failed capture on screen */
+    std::vector<short> mask_failure_samples_m;
+    /** @brief amplitude histograms and eye diagram selection and view */
+    ComboRange *analysis_m;
+    typedef struct
+    {
+        std::string name;
+        analysis_spec_t value;
+    }analysis_item_t;
+    std::vector<analysis_item_t> *analysis_items_m;
+    AnalysisView *analysis_view_m;
+    QTimer *analysis_timer_m;
+    /* copy of the accumulators, kept to reuse its tables */
+    analysis_result_t analysis_result_m;
+    /** @brief memory kept for the last captures, and scrollback through them */
+    ComboRange *history_budget_m;
+    typedef struct
+    {
+        std::string name;
+        size_t value;
+    }history_budget_item_t;
+    std::vector<history_budget_item_t> *history_budget_items_m;
+    QSlider *history_m;
+    QLabel *history_label_m;
+    QTimer *history_timer_m;
+    /* copy of the kept capture on screen */
+    std::vector<short> history_samples_m;
+    std::vector<double> history_times_m;
+    /** @brief export of the capture on screen or of the streaming record */
+    ComboRange *export_m;
+    typedef struct
+    {
+        std::string name;
+        /* file name filter of the save dialog */
+        std::string filter;
+        export_format_e value;
+    }export_item_t;
+    std::vector<export_item_t> *export_items_m;
+    Exporter *exporter_m;
+    QTimer *export_timer_m;
     /* Store the parent class */
     QWidget *parent_m;
 
@@ -0,0 +1,236 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file log.cpp
+ * @brief Definition of the asynchronous log writer.
+ * The ring is a bounded queue of fixed size records with one sequence number
+ * per record: producers reserve a record with a compare and swap of the head,
+ * the writer is the only consumer.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "log.h"
+
+#define LOG_RING_MASK   (LOG_RING_SIZE - 1)
+
+static const char *level_names[] = { "ERROR", "WARNING", "DEBUG" };
+
+typedef struct
+{
+    /**
+     * @brief sequence minus record index, so that a zeroed ring is empty:
+     * free for position p when it equals p - index, written when p + 1 - index
+     */
+    uint32_t sequence;
+    int level;
+    const char *file;
+    const char *function;
+    int line;
+    char text[LOG_TEXT_SIZE];
+}log_record_t;
+
+volatile int log_level_g = LOG_LEVEL_DEFAULT;
+
+/* sequences are loaded with acquire and stored with release ordering:
+ * record fields written before a store are seen after the matching load */
+#define LOG_LOAD(x)       __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define LOG_STORE(x, v)   __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+static log_record_t log_ring[LOG_RING_SIZE];
+/* next position to write, shared by producers */
+static uint32_t log_head = 0;
+/* next position to read, writer thread only */
+static uint32_t log_tail = 0;
+static uint32_t log_dropped = 0;
+static int log_running = 0;
+static pthread_t log_thread;
+
+/****************************************************************************
+ * log_write - one record on stderr, the prefix is the one of former macros
+ ****************************************************************************/
+static void log_write(int level, const char *file, const char *function, int line, const char *text)
+{
+    fprintf(stderr, "%s\t- %s:\t[%d]\t%s: %s", file, function, line, level_names[level], text);
+}
+
+/****************************************************************************
+ * log_drain - write the records of the ring, writer thread only
+ ****************************************************************************/
+static void log_drain(void)
+{
+    static uint32_t reported = 0;
+    log_record_t *record = NULL;
+    uint32_t index = 0;
+    uint32_t dropped = 0;
+
+    for(;;)
+    {
+        index = log_tail & LOG_RING_MASK;
+        record = &log_ring[index];
+        if( LOG_LOAD(record->sequence) + index != log_tail + 1 )
+        {
+            break;
+        }
+        log_write(record->level, record->file, record->function, record->line, record->text);
+        // free for the producer one lap ahead
+        LOG_STORE(record->sequence, log_tail + LOG_RING_SIZE - index);
+        log_tail++;
+    }
+    dropped = LOG_LOAD(log_dropped);
+    if( dropped != reported )
+    {
+        fprintf(stderr, "%u log records dropped\n", dropped - reported);
+        reported = dropped;
+    }
+    fflush(stderr);
+}
+
+/****************************************************************************
+ * log_thread_main
+ ****************************************************************************/
+static void* log_thread_main(void *arg)
+{
+    struct timespec delay;
+
+    (void)arg;
+    delay.tv_sec = 0;
+    delay.tv_nsec = LOG_DRAIN_MS * 1000000L;
+    while( LOG_LOAD(log_running) )
+    {
+        log_drain();
+        nanosleep(&delay, NULL);
+    }
+    log_drain();
+    return NULL;
+}
+
+/****************************************************************************
+ * log_start
+ ****************************************************************************/
+int8_t log_start(void)
+{
+    const char *level = getenv("QPICOSCOPE_LOG_LEVEL");
+    int ret = 0;
+
+    if( NULL != level )
+    {
+        log_set_level(atoi(level));
+    }
+    if( LOG_LOAD(log_running) )
+    {
+        return 0;
+    }
+    LOG_STORE(log_running, 1);
+    ret = pthread_create(&log_thread, NULL, log_thread_main, NULL);
+    if( 0 != ret )
+    {
+        LOG_STORE(log_running, 0);
+        fprintf(stderr, "log writer pthread_create failed and returned %d\n", ret);
+        return -1;
+    }
+    return 0;
+}
+
+/****************************************************************************
+ * log_stop
+ ****************************************************************************/
+void log_stop(void)
+{
+    if( LOG_LOAD(log_running) )
+    {
+        LOG_STORE(log_running, 0);
+        pthread_join(log_thread, NULL);
+    }
+}
+
+/****************************************************************************
+ * log_set_level
+ ****************************************************************************/
+void log_set_level(int level)
+{
+    if( level < LOG_LEVEL_ERROR )
+        level = LOG_LEVEL_ERROR;
+    if( level > LOG_LEVEL_DEBUG )
+        level = LOG_LEVEL_DEBUG;
+    log_level_g = level;
+}
+
+/****************************************************************************
+ * log_printf - never blocks while the writer runs, drops the record if the ring is full
+ ****************************************************************************/
+void log_printf(int level, const char *file, const char *function, int line, const char *format, ...)
+{
+    log_record_t *record = NULL;
+    uint32_t position = 0;
+    uint32_t index = 0;
+    int32_t diff = 0;
+    va_list args;
+    char text[LOG_TEXT_SIZE];
+
+    if( !LOG_LOAD(log_running) )
+    {
+        va_start(args, format);
+        vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        log_write(level, file, function, line, text);
+        return;
+    }
+
+    position = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+    for(;;)
+    {
+        index = position & LOG_RING_MASK;
+        record = &log_ring[index];
+        diff = (int32_t)(LOG_LOAD(record->sequence) + index - position);
+        if( 0 == diff )
+        {
+            // on failure position is updated to the current head
+            if( __atomic_compare_exchange_n(&log_head, &position, position + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED) )
+                break;
+        }
+        else if( diff < 0 )
+        {
+            // writer is one lap behind
+            __atomic_fetch_add(&log_dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        else
+        {
+            position = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+        }
+    }
+
+    record->level = level;
+    record->file = file;
+    record->function = function;
+    record->line = line;
+    va_start(args, format);
+    vsnprintf(record->text, sizeof(record->text), format, args);
+    va_end(args);
+    LOG_STORE(record->sequence, position + 1 - index);
+}
@@ -0,0 +1,92 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file log.h
+ * @brief Logging macros and their asynchronous writer.
+ * Records are formatted by the calling thread in a lock free ring, and
+ * written to stderr by a background thread: acquisition and driver threads
+ * never wait for the terminal. Levels above LOG_LEVEL_MAX are removed at
+ * compile time, the others are filtered at run time by log_set_level().
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+#define LOG_LEVEL_ERROR      0
+#define LOG_LEVEL_WARNING    1
+#define LOG_LEVEL_DEBUG      2
+
+/* highest level compiled in, i.e. -DLOG_LEVEL_MAX=LOG_LEVEL_WARNING removes DEBUG calls */
+#ifndef LOG_LEVEL_MAX
+#define LOG_LEVEL_MAX        LOG_LEVEL_DEBUG
+#endif
+
+/* run time level when QPICOSCOPE_LOG_LEVEL is not set */
+#define LOG_LEVEL_DEFAULT    LOG_LEVEL_WARNING
+/* records waiting for the writer, a power of 2: further ones are dropped */
+#define LOG_RING_SIZE        1024
+/* longest message of a record, longer ones are truncated */
+#define LOG_TEXT_SIZE        224
+/* delay between two drains of the ring by the writer */
+#define LOG_DRAIN_MS         20
+
+#ifdef __GNUC__
+#define LOG_PRINTF_CHECK(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define LOG_PRINTF_CHECK(fmt, args)
+#endif
+
+/** @brief run time level, read by every macro call */
+extern volatile int log_level_g;
+
+/**
+ * @brief start the writer thread, run time level is read from QPICOSCOPE_LOG_LEVEL
+ * records logged before are kept in the ring and written first
+ * return : 0 if successful, -1 in case of error
+ */
+int8_t log_start(void);
+/**
+ * @brief write remaining records and stop the writer thread,
+ * records logged afterwards are written synchronously
+ */
+void log_stop(void);
+/**
+ * @brief set the run time level
+ * @param[in] : LOG_LEVEL_ERROR, LOG_LEVEL_WARNING or LOG_LEVEL_DEBUG
+ */
+void log_set_level(int level);
+/**
+ * @brief queue a record, use the macros instead
+ */
+void log_printf(int level, const char *file, const char *function, int line, const char *format, ...) LOG_PRINTF_CHECK(5, 6);
+
+/* elided calls still check their arguments, the compiler removes them */
+#define LOG_AT(level, ...)   do{ if( ((level) <= LOG_LEVEL_MAX) && ((level) <= log_level_g) ) \
+                                     log_printf((level), __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__); }while(0)
+
+#define DEBUG(...)     LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define ERROR(...)     LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define WARNING(...)   LOG_AT(LOG_LEVEL_WARNING, __VA_ARGS__)
+
+#endif // LOG_H
@@ -0,0 +1,120 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file logicitem.cpp
+ * @brief Definition of LogicItem class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <QPainter>
+#include <qwt_scale_map.h>
+
+#include "logicitem.h"
+
+/****************************************************************************
+ * LogicItem
+ ****************************************************************************/
+LogicItem::LogicItem(DigitalBlock * const *front) :
+    front_m(front),
+    color_m(0, 255, 255)
+{
+}
+
+/****************************************************************************
+ * draw - each column costs one word scan of the samples it covers
+ ****************************************************************************/
+#if ( QWT_VERSION >= 0x060000)
+void LogicItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
+#else
+void LogicItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRect &canvasRect) const
+#endif
+{
+    const DigitalBlock *front = *front_m;
+    double lane = 0.;
+    double high = 0.;
+    double low = 0.;
+    double left = canvasRect.left();
+    double right = canvasRect.right();
+    double x = 0.;
+    double segment = 0.;
+    double position = 0.;
+    uint32_t from = 0;
+    uint32_t to = 0;
+    uint8_t line = 0;
+    digital_state_e state = E_DIGITAL_LOW;
+    digital_state_e previous = E_DIGITAL_LOW;
+
+    (void)yMap;
+    if((0 == front->count()) || (front->dt() <= 0.))
+    {
+        return;
+    }
+    lane = canvasRect.height() * LOGIC_LANES_RATIO / DIGITAL_LINES;
+    painter->setPen(color_m);
+    for(line = 0; line < DIGITAL_LINES; line++)
+    {
+        if(!(front->lines() & (1 << line)))
+        {
+            continue;
+        }
+        high = canvasRect.bottom() - (DIGITAL_LINES - line) * lane + lane * 0.2;
+        low = canvasRect.bottom() - (DIGITAL_LINES - line - 1) * lane - lane * 0.2;
+        segment = -1.;
+        for(x = left; x < right; x += 1.)
+        {
+            position = (xMap.invTransform(x) - front->t0()) / front->dt();
+            if(position < 0.)
+            {
+                continue;
+            }
+            from = (uint32_t)position;
+            if(from >= front->count())
+            {
+                break;
+            }
+            position = (xMap.invTransform(x + 1.) - front->t0()) / front->dt();
+            to = (position > (double)front->count()) ? front->count() : (uint32_t)position;
+            if(to <= from)
+            {
+                to = from + 1;
+            }
+            state = front->span_state(line, from, to);
+            // toggling within the column, or edge between two columns
+            if((state == E_DIGITAL_TOGGLING) || ((segment >= 0.) && (state != previous)))
+            {
+                painter->drawLine(QLineF(x, high, x, low));
+            }
+            if((segment >= 0.) && (state != previous) && (previous != E_DIGITAL_TOGGLING))
+            {
+                painter->drawLine(QLineF(segment, (previous == E_DIGITAL_HIGH) ? high : low, x, (previous == E_DIGITAL_HIGH) ? high : low));
+            }
+            if((segment < 0.) || (state != previous))
+            {
+                segment = x;
+                previous = state;
+            }
+        }
+        if((segment >= 0.) && (previous != E_DIGITAL_TOGGLING))
+        {
+            painter->drawLine(QLineF(segment, (previous == E_DIGITAL_HIGH) ? high : low, x, (previous == E_DIGITAL_HIGH) ? high : low));
+        }
+    }
+}
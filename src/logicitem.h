@@ -0,0 +1,58 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file logicitem.h
+ * @brief Declaration of LogicItem class.
+ * Digital lines are drawn as logic traces in lanes at the bottom of the
+ * canvas, one level or edge per pixel column.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef LOGICITEM_H
+#define LOGICITEM_H
+
+#include <QColor>
+#include <qwt_plot_item.h>
+
+#include "digitalblock.h"
+
+/* logic lanes use the bottom half of the canvas */
+#define LOGIC_LANES_RATIO   0.5
+
+class LogicItem : public QwtPlotItem
+{
+public:
+    /**
+     * @brief constructor
+     * @param[in] : location of the current digital block pointer, read at each draw
+     */
+    LogicItem(DigitalBlock * const *front);
+#if ( QWT_VERSION >= 0x060000)
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const;
+#else
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRect &canvasRect) const;
+#endif
+private:
+    DigitalBlock * const *front_m;
+    QColor color_m;
+};
+
+#endif // LOGICITEM_H
@@ -30,10 +30,17 @@
 
 #include "mainwindow.h"
 #include "oscilloscope.h"
+#include "acquisition.h"
 
 /** @brief all programs have a start point... */
 int main(int argc, char *argv[])
 {
+    int ret = 0;
+    realtime_spec_t realtime;
+    /* before any thread is created, they inherit the CPU affinity */
+    Acquisition::get_realtime_from_env(&realtime);
+    Acquisition::set_realtime(realtime);
+    log_start();
     QApplication app(argc, argv);
     /* Setting pathes like that is horrible 
      * For some reason QCoreApplication::applicationDirPath returns always "/" on my machine
@@ -44,9 +51,11 @@ int main(int argc, char *argv[])
     icons_pathes << "../images";
     QDir::setSearchPaths("icons", icons_pathes);
     MainWindow mainwindow;
-    mainwindow.setGeometry(100, 100, 800, 600);
     mainwindow.setWindowIcon(QIcon("icons:icon50.png"));
     mainwindow.setWindowTitle(QString("QPicoscope"));
     mainwindow.show();
-    return app.exec();
+    ret = app.exec();
+    /* messages of the windows destruction are written synchronously */
+    log_stop();
+    return ret;
 }
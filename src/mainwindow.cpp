@@ -33,6 +33,10 @@ MainWindow::MainWindow()
     createMenus();
     frontpanel_m = new FrontPanel(this);    
     setCentralWidget(frontpanel_m);
+    // default geometry, replaced by the one of the last session if any
+    setGeometry(100, 100, 800, 600);
+    QSettings settings(SETTINGS_ORGANIZATION, SETTINGS_APPLICATION);
+    restoreGeometry(settings.value("window/geometry").toByteArray());
 }
 
 MainWindow::~MainWindow()
@@ -41,6 +45,13 @@ MainWindow::~MainWindow()
 }
 
 
+void MainWindow::closeEvent(QCloseEvent *event)
+{
+    QSettings settings(SETTINGS_ORGANIZATION, SETTINGS_APPLICATION);
+    settings.setValue("window/geometry", saveGeometry());
+    QMainWindow::closeEvent(event);
+}
+
 void MainWindow::about()
 {
     QMessageBox msgBox(this);
@@ -46,6 +46,10 @@ public:
      */
     virtual ~MainWindow();
 
+protected:
+    /** @brief keep the window geometry for the next start */
+    void closeEvent(QCloseEvent *event);
+
 private slots:
     void about();
     void aboutQt();
@@ -0,0 +1,358 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file masktest.cpp
+ * @brief Definition of MaskTest class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include "masktest.h"
+
+/****************************************************************************
+ * volts to ADC counts, saturated
+ ****************************************************************************/
+static short mask_counts(double counts)
+{
+    if(counts >= SHRT_MAX)
+        return SHRT_MAX;
+    if(counts <= SHRT_MIN)
+        return SHRT_MIN;
+    return (short)counts;
+}
+
+/****************************************************************************
+ * polyline value at a time, flat beyond the ends
+ ****************************************************************************/
+static double mask_polyline(const std::vector<mask_point_t> &points, uint32_t *segment, double time)
+{
+    uint32_t k = *segment;
+    const mask_point_t *a = NULL;
+    const mask_point_t *b = NULL;
+
+    if(time <= points.front().time)
+        return points.front().volts;
+    if(time >= points.back().time)
+        return points.back().volts;
+    // times only increase: the segment is searched from the previous one
+    while((k + 1 < points.size()) && (points[k + 1].time < time))
+        k++;
+    *segment = k;
+    a = &points[k];
+    b = &points[k + 1];
+    if(b->time <= a->time)
+        return b->volts;
+    return a->volts + (b->volts - a->volts) * (time - a->time) / (b->time - a->time);
+}
+
+/****************************************************************************
+ * polyline points order
+ ****************************************************************************/
+static bool mask_point_before(const mask_point_t &a, const mask_point_t &b)
+{
+    return a.time < b.time;
+}
+
+/****************************************************************************
+ * MaskTest
+ ****************************************************************************/
+MaskTest::MaskTest() :
+    limits_t0_m(0.),
+    limits_dt_m(0.),
+    limits_scale_m(0.),
+    reference_pending_m(false),
+    passed_m(0),
+    failed_m(0),
+    next_failure_m(0)
+{
+    spec_m.mode = E_MASK_NONE;
+    spec_m.channel = 0;
+    spec_m.tolerance_volts = 0.;
+    spec_m.tolerance_samples = 0;
+    memset(failures_m, 0, sizeof(failures_m));
+}
+
+/****************************************************************************
+ * configure
+ ****************************************************************************/
+int8_t MaskTest::configure(const mask_spec_t &spec)
+{
+    if(spec.channel >= MAX_CHANNELS)
+    {
+        ERROR("invalid mask channel %d\n", spec.channel);
+        return -1;
+    }
+    if((E_MASK_POLYGON == spec.mode) && spec.upper.empty() && spec.lower.empty())
+    {
+        ERROR("polygon mask without limits\n");
+        return -1;
+    }
+    spec_m = spec;
+    upper_m.clear();
+    lower_m.clear();
+    reference_pending_m = (E_MASK_REFERENCE == spec.mode);
+    reset_counts();
+    return 0;
+}
+
+/****************************************************************************
+ * load polygon
+ ****************************************************************************/
+int8_t MaskTest::load_polygon(const char *path, mask_spec_t *spec)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+    char limit[16];
+    char *comment = NULL;
+    mask_point_t point;
+    uint32_t number = 0;
+    int8_t ret = 0;
+
+    if(NULL == file)
+    {
+        ERROR("cannot open polygon mask %s\n", path);
+        return -1;
+    }
+    spec->mode = E_MASK_POLYGON;
+    spec->tolerance_volts = 0.;
+    spec->tolerance_samples = 0;
+    spec->upper.clear();
+    spec->lower.clear();
+    while((0 == ret) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        number++;
+        comment = strchr(line, '#');
+        if(NULL != comment)
+            *comment = '\0';
+        if(strspn(line, " \t\r\n") == strlen(line))
+            continue;
+        if(3 != sscanf(line, "%15s %lf %lf", limit, &point.time, &point.volts))
+            ret = -1;
+        else if(0 == strcmp(limit, "upper"))
+            spec->upper.push_back(point);
+        else if(0 == strcmp(limit, "lower"))
+            spec->lower.push_back(point);
+        else
+            ret = -1;
+        if(0 != ret)
+        {
+            ERROR("%s:%u: expected \"upper|lower <time> <volts>\"\n", path, number);
+        }
+    }
+    fclose(file);
+    if((0 == ret) && spec->upper.empty() && spec->lower.empty())
+    {
+        ERROR("polygon mask %s has no limits\n", path);
+        ret = -1;
+    }
+    // limits are looked up as times increase
+    std::stable_sort(spec->upper.begin(), spec->upper.end(), mask_point_before);
+    std::stable_sort(spec->lower.begin(), spec->lower.end(), mask_point_before);
+    return ret;
+}
+
+/****************************************************************************
+ * reset counts
+ ****************************************************************************/
+void MaskTest::reset_counts()
+{
+    passed_m = 0;
+    failed_m = 0;
+    next_failure_m = 0;
+    memset(failures_m, 0, sizeof(failures_m));
+}
+
+/****************************************************************************
+ * prepare - limits for samples [0, end) of the block geometry
+ ****************************************************************************/
+int8_t MaskTest::prepare(const sample_block_t *block, uint32_t end)
+{
+    bool same = (block->t0 == limits_t0_m) && (block->dt == limits_dt_m) && (block->scale == limits_scale_m);
+    double tolerance = 0.;
+    uint32_t segment_upper = 0;
+    uint32_t segment_lower = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    uint32_t k = spec_m.tolerance_samples;
+    short max = 0;
+    short min = 0;
+    double time = 0.;
+
+    if(reference_pending_m)
+    {
+        // reference limits: widest reference value within +/- k samples, plus tolerance
+        tolerance = spec_m.tolerance_volts / block->scale;
+        upper_m.resize(end);
+        lower_m.resize(end);
+        for(i = 0; i < end; i++)
+        {
+            max = SHRT_MIN;
+            min = SHRT_MAX;
+            for(j = (i > k) ? i - k : 0; (j <= i + k) && (j < end); j++)
+            {
+                if(block->raw[j] > max)
+                    max = block->raw[j];
+                if(block->raw[j] < min)
+                    min = block->raw[j];
+            }
+            upper_m[i] = mask_counts(floor(max + tolerance));
+            lower_m[i] = mask_counts(ceil(min - tolerance));
+        }
+        reference_pending_m = false;
+    }
+    else if(E_MASK_REFERENCE == spec_m.mode)
+    {
+        // a reference only applies to its own time base and range
+        return (same && (upper_m.size() > 0)) ? 0 : -1;
+    }
+    else if(!same || (end > upper_m.size()))
+    {
+        upper_m.resize(end);
+        lower_m.resize(end);
+        for(i = 0; i < end; i++)
+        {
+            time = block->t0 + i * block->dt;
+            upper_m[i] = spec_m.upper.empty() ? SHRT_MAX :
+                         mask_counts(floor(mask_polyline(spec_m.upper, &segment_upper, time) / block->scale));
+            lower_m[i] = spec_m.lower.empty() ? SHRT_MIN :
+                         mask_counts(ceil(mask_polyline(spec_m.lower, &segment_lower, time) / block->scale));
+        }
+    }
+    limits_t0_m = block->t0;
+    limits_dt_m = block->dt;
+    limits_scale_m = block->scale;
+    return 0;
+}
+
+/****************************************************************************
+ * test
+ ****************************************************************************/
+int8_t MaskTest::test(const sample_block_t *block, uint32_t first, uint32_t count, uint32_t sequence)
+{
+    const short *raw = NULL;
+    const short *upper = NULL;
+    const short *lower = NULL;
+    uint32_t violations = 0;
+    uint32_t i = 0;
+
+    if(!enabled() || (NULL == block) || (NULL == block->raw) || (NULL != block->times) ||
+       (block->scale <= 0.) || (0 == count) || (first + count > block->count))
+    {
+        return -1;
+    }
+    if(0 != prepare(block, first + count))
+    {
+        return -1;
+    }
+    // a reference shorter than the capture only tests its own span
+    if(first >= upper_m.size())
+    {
+        return -1;
+    }
+    if(first + count > upper_m.size())
+    {
+        count = upper_m.size() - first;
+    }
+    raw = block->raw + first;
+    upper = &upper_m[first];
+    lower = &lower_m[first];
+    // no branch in the loop: compilers turn it into packed compares
+    for(i = 0; i < count; i++)
+    {
+        violations += (raw[i] > upper[i]) | (raw[i] < lower[i]);
+    }
+    if(0 == violations)
+    {
+        passed_m++;
+        return 0;
+    }
+    failed_m++;
+    keep_failure(block, first, count, sequence, violations);
+    return 1;
+}
+
+/****************************************************************************
+ * keep failure - oldest failure is overwritten
+ ****************************************************************************/
+void MaskTest::keep_failure(const sample_block_t *block, uint32_t first, uint32_t count, uint32_t sequence, uint32_t violations)
+{
+    uint32_t slot = next_failure_m % MASK_FAILURE_HISTORY;
+    mask_failure_t *failure = &failures_m[slot];
+    const short *raw = block->raw + first;
+    uint32_t i = 0;
+
+    failure_samples_m[slot].assign(raw, raw + count);
+    for(i = 0; i < count; i++)
+    {
+        if((raw[i] > upper_m[first + i]) || (raw[i] < lower_m[first + i]))
+            break;
+    }
+    failure->sequence = sequence;
+    failure->channel = spec_m.channel;
+    failure->first_violation = first + i;
+    failure->violations = violations;
+    failure->block = *block;
+    failure->block.raw = &failure_samples_m[slot][0];
+    failure->block.t0 = block->t0 + first * block->dt;
+    failure->block.count = count;
+    failure->block.stable = 0;
+    next_failure_m++;
+}
+
+/****************************************************************************
+ * reserve
+ ****************************************************************************/
+void MaskTest::reserve(uint32_t nb_samples)
+{
+    uint32_t slot = 0;
+
+    upper_m.reserve(nb_samples);
+    lower_m.reserve(nb_samples);
+    for(slot = 0; slot < MASK_FAILURE_HISTORY; slot++)
+    {
+        failure_samples_m[slot].reserve(nb_samples);
+    }
+}
+
+/****************************************************************************
+ * failures
+ ****************************************************************************/
+uint32_t MaskTest::failures() const
+{
+    return (next_failure_m < MASK_FAILURE_HISTORY) ? next_failure_m : MASK_FAILURE_HISTORY;
+}
+
+/****************************************************************************
+ * failure
+ ****************************************************************************/
+const mask_failure_t *MaskTest::failure(uint32_t index) const
+{
+    if(index >= failures())
+    {
+        return NULL;
+    }
+    return &failures_m[(next_failure_m - 1 - index) % MASK_FAILURE_HISTORY];
+}
@@ -0,0 +1,145 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file masktest.h
+ * @brief Declaration of MaskTest class.
+ * Captured waveforms are checked against upper and lower limits precomputed
+ * per sample, from a polygon mask or from a reference trace with tolerance.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef MASKTEST_H
+#define MASKTEST_H
+
+#include <vector>
+
+#include "oscilloscope.h"
+#include "sampleblock.h"
+
+/* number of failed waveforms kept */
+#define MASK_FAILURE_HISTORY 16
+
+typedef enum
+{
+    E_MASK_NONE = 0,
+    /* next tested waveform becomes the reference, limits are reference +/- tolerance */
+    E_MASK_REFERENCE,
+    /* limits are upper and lower polylines, the allowed area is between them */
+    E_MASK_POLYGON
+}mask_mode_e;
+
+typedef struct
+{
+    /** @brief time in seconds, volts */
+    double time;
+    double volts;
+}mask_point_t;
+
+typedef struct
+{
+    mask_mode_e mode;
+    /** @brief tested channel index (0 for channel A, 1 for channel B, etc) */
+    uint8_t channel;
+    /** @brief E_MASK_REFERENCE: vertical tolerance in volts, horizontal tolerance in samples */
+    double tolerance_volts;
+    uint32_t tolerance_samples;
+    /** @brief E_MASK_POLYGON: limits sorted by time, flat beyond their ends */
+    std::vector<mask_point_t> upper;
+    std::vector<mask_point_t> lower;
+}mask_spec_t;
+
+typedef struct
+{
+    /** @brief sequence number of the failed frame */
+    uint32_t sequence;
+    /** @brief tested channel index (0 for channel A, 1 for channel B, etc) */
+    uint8_t channel;
+    /** @brief index of the first sample out of the mask */
+    uint32_t first_violation;
+    /** @brief number of samples out of the mask */
+    uint32_t violations;
+    /** @brief failed samples, raw points to the history storage */
+    sample_block_t block;
+}mask_failure_t;
+
+class MaskTest
+{
+public:
+    MaskTest();
+    /**
+     * @brief set the mask, counts and failures are reset
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t configure(const mask_spec_t &spec);
+    /**
+     * @brief read polygon limits from a text file, one point per line:
+     * "upper <time in s> <volts>" or "lower <time in s> <volts>", '#' starts a comment
+     * @param[in] : file path
+     * @param[in,out] : mask set to E_MASK_POLYGON with the read limits, its channel is kept
+     * return : 0 if successful, -1 in case of error
+     */
+    static int8_t load_polygon(const char *path, mask_spec_t *spec);
+    bool enabled() const { return E_MASK_NONE != spec_m.mode; }
+    uint8_t channel() const { return spec_m.channel; }
+    /**
+     * @brief test samples [first, first + count) of a block, one branch free
+     * compare pass over the samples
+     * @param[in] : block, sample times are counted from its t0
+     * @param[in] : first sample
+     * @param[in] : number of samples
+     * @param[in] : frame sequence number, kept with failures
+     * return : 0 if passed, 1 if failed, -1 if not tested
+     */
+    int8_t test(const sample_block_t *block, uint32_t first, uint32_t count, uint32_t sequence);
+    void reset_counts();
+    /**
+     * @brief size limits and failure storage for screens up to nb_samples,
+     * testing then does not allocate
+     * @param[in] : number of samples of a screen
+     */
+    void reserve(uint32_t nb_samples);
+    uint32_t passed() const { return passed_m; }
+    uint32_t failed() const { return failed_m; }
+    /** @brief number of failures kept, at most MASK_FAILURE_HISTORY */
+    uint32_t failures() const;
+    /**
+     * @brief kept failure, 0 is the newest
+     */
+    const mask_failure_t *failure(uint32_t index) const;
+private:
+    int8_t prepare(const sample_block_t *block, uint32_t end);
+    void keep_failure(const sample_block_t *block, uint32_t first, uint32_t count, uint32_t sequence, uint32_t violations);
+    mask_spec_t spec_m;
+    /* limits in ADC counts per sample index, for the block geometry below */
+    std::vector<short> upper_m;
+    std::vector<short> lower_m;
+    double limits_t0_m;
+    double limits_dt_m;
+    double limits_scale_m;
+    bool reference_pending_m;
+    uint32_t passed_m;
+    uint32_t failed_m;
+    mask_failure_t failures_m[MASK_FAILURE_HISTORY];
+    std::vector<short> failure_samples_m[MASK_FAILURE_HISTORY];
+    uint32_t next_failure_m;
+};
+
+#endif // MASKTEST_H
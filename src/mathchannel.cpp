@@ -0,0 +1,328 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file mathchannel.cpp
+ * @brief Definition of MathChannel class.
+ * Kernels are plain loops over contiguous arrays without branches, so the
+ * compiler can vectorize them.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mathchannel.h"
+
+/****************************************************************************
+ * kernels
+ ****************************************************************************/
+static void kernel_copy(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    const float k = (float)(p->gain * p->scale_a);
+    const float c = (float)p->offset;
+    (void)b;
+    for(uint32_t i = 0; i < n; i++)
+        out[i] = k * a[i] + c;
+}
+
+static void kernel_add(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    const float ka = (float)(p->gain * p->scale_a);
+    const float kb = (float)(p->gain * p->scale_b);
+    const float c = (float)p->offset;
+    for(uint32_t i = 0; i < n; i++)
+        out[i] = ka * a[i] + kb * b[i] + c;
+}
+
+static void kernel_sub(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    const float ka = (float)(p->gain * p->scale_a);
+    const float kb = (float)(p->gain * p->scale_b);
+    const float c = (float)p->offset;
+    for(uint32_t i = 0; i < n; i++)
+        out[i] = ka * a[i] - kb * b[i] + c;
+}
+
+static void kernel_mul(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    const float k = (float)(p->gain * p->scale_a * p->scale_b);
+    const float c = (float)p->offset;
+    for(uint32_t i = 0; i < n; i++)
+        out[i] = k * ((float)a[i] * (float)b[i]) + c;
+}
+
+static void kernel_div(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    const float k = (float)(p->gain * p->scale_a / p->scale_b);
+    const float c = (float)p->offset;
+    for(uint32_t i = 0; i < n; i++)
+    {
+        // zero divisor gives 0 instead of inf, keeps the result drawable
+        const float divisor = b[i] ? (float)b[i] : 1.f;
+        const float valid = b[i] ? 1.f : 0.f;
+        out[i] = k * valid * (float)a[i] / divisor + c;
+    }
+}
+
+static void kernel_abs(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    const float k = (float)(p->gain * p->scale_a);
+    const float c = (float)p->offset;
+    (void)b;
+    for(uint32_t i = 0; i < n; i++)
+        out[i] = k * fabsf((float)a[i]) + c;
+}
+
+static void kernel_integrate(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    /* running sum is a dependency chain, accumulate in double to keep precision */
+    const double k = p->gain * p->scale_a * p->dt;
+    double sum = 0.;
+    (void)b;
+    for(uint32_t i = 0; i < n; i++)
+    {
+        sum += a[i];
+        out[i] = (float)(k * sum + p->offset);
+    }
+}
+
+static void kernel_differentiate(const short *a, const short *b, float *out, uint32_t n, const MathChannel::params_t *p)
+{
+    const float k = (float)(p->gain * p->scale_a / p->dt);
+    const float c = (float)p->offset;
+    (void)b;
+    if(0 == n)
+        return;
+    out[0] = c;
+    for(uint32_t i = 1; i < n; i++)
+        out[i] = k * (float)(a[i] - a[i - 1]) + c;
+}
+
+/****************************************************************************
+ * parser helpers
+ ****************************************************************************/
+static bool parse_channel(const char **s, uint8_t *channel)
+{
+    if((**s >= 'A') && (**s <= 'D'))
+    {
+        *channel = (uint8_t)(**s - 'A');
+        (*s)++;
+        return true;
+    }
+    return false;
+}
+
+static bool parse_number(const char **s, double *value)
+{
+    char *end = NULL;
+    *value = strtod(*s, &end);
+    if(end == *s)
+        return false;
+    *s = end;
+    return true;
+}
+
+/****************************************************************************
+ * MathChannel
+ ****************************************************************************/
+MathChannel::MathChannel() :
+    kernel_m(NULL),
+    source_a_m(0),
+    source_b_m(0),
+    gain_m(1.),
+    offset_m(0.)
+{
+}
+
+/****************************************************************************
+ * compile
+ ****************************************************************************/
+int8_t MathChannel::compile(const std::string &expression)
+{
+    std::string e;
+    const char *s = NULL;
+    kernel_t kernel = kernel_copy;
+    uint8_t a = 0;
+    uint8_t b = 0;
+    double gain = 1.;
+    double offset = 0.;
+    bool parenthesis = false;
+
+    for(size_t i = 0; i < expression.size(); i++)
+    {
+        if(!isspace((unsigned char)expression[i]))
+            e += (char)toupper((unsigned char)expression[i]);
+    }
+    if(e.empty() || (e == "OFF"))
+    {
+        kernel_m = NULL;
+        return 0;
+    }
+    s = e.c_str();
+
+    /* optional gain */
+    if(((*s >= '0') && (*s <= '9')) || (*s == '.') || (*s == '-'))
+    {
+        if(!parse_number(&s, &gain) || (*s++ != '*'))
+            goto error;
+    }
+    /* function, channel or channel pair */
+    if(0 == strncmp(s, "ABS(", 4))
+    {
+        kernel = kernel_abs;
+        s += 4;
+        parenthesis = true;
+    }
+    else if(0 == strncmp(s, "INTG(", 5))
+    {
+        kernel = kernel_integrate;
+        s += 5;
+        parenthesis = true;
+    }
+    else if(0 == strncmp(s, "DIFF(", 5))
+    {
+        kernel = kernel_differentiate;
+        s += 5;
+        parenthesis = true;
+    }
+    else if(*s == '(')
+    {
+        s++;
+        parenthesis = true;
+    }
+    if(!parse_channel(&s, &a))
+        goto error;
+    /* an operator followed by a channel makes a pair, otherwise it is the offset */
+    if((kernel == kernel_copy) && (*s != '\0') && (NULL != strchr("+-*/", *s)) &&
+       (s[1] >= 'A') && (s[1] <= 'D'))
+    {
+        switch(*s++)
+        {
+            case '+': kernel = kernel_add; break;
+            case '-': kernel = kernel_sub; break;
+            case '*': kernel = kernel_mul; break;
+            case '/': kernel = kernel_div; break;
+            default: goto error;
+        }
+        if(!parse_channel(&s, &b))
+            goto error;
+    }
+    if(parenthesis && (*s++ != ')'))
+        goto error;
+    /* optional offset */
+    if(*s != '\0')
+    {
+        if(((*s != '+') && (*s != '-')) || !parse_number(&s, &offset) || (*s != '\0'))
+            goto error;
+    }
+
+    kernel_m = kernel;
+    source_a_m = a;
+    source_b_m = b;
+    gain_m = gain;
+    offset_m = offset;
+    DEBUG("math channel: %s\n", e.c_str());
+    return 0;
+
+error:
+    ERROR("invalid math expression: %s\n", expression.c_str());
+    return -1;
+}
+
+/****************************************************************************
+ * binary
+ ****************************************************************************/
+bool MathChannel::binary() const
+{
+    return (kernel_m == kernel_add) || (kernel_m == kernel_sub) ||
+           (kernel_m == kernel_mul) || (kernel_m == kernel_div);
+}
+
+/****************************************************************************
+ * sources
+ ****************************************************************************/
+uint8_t MathChannel::sources() const
+{
+    if(NULL == kernel_m)
+        return 0;
+    // unary kernels leave source_b_m unset
+    return binary() ? ((1 << source_a_m) | (1 << source_b_m)) : (1 << source_a_m);
+}
+
+/****************************************************************************
+ * evaluate
+ ****************************************************************************/
+int8_t MathChannel::evaluate(const sample_frame_t *frame, sample_block_t *result)
+{
+    const sample_block_t *a = NULL;
+    const sample_block_t *b = NULL;
+    uint32_t n = 0;
+    uint32_t i = 0;
+    params_t params;
+    float peak = 0.f;
+    float inverse = 0.f;
+
+    if((NULL == kernel_m) || ((frame->channels & sources()) != sources()))
+    {
+        return -1;
+    }
+    a = &frame->blocks[source_a_m];
+    b = binary() ? &frame->blocks[source_b_m] : a;
+    n = (a->count < b->count) ? a->count : b->count;
+    if(values_m.size() < n)
+    {
+        values_m.resize(n);
+        counts_m.resize(n);
+    }
+    params.scale_a = a->scale;
+    params.scale_b = b->scale;
+    params.gain = gain_m;
+    params.offset = offset_m;
+    params.dt = a->dt;
+
+    /* fused pass: channel scales, operation, gain and offset */
+    if(n > 0)
+        kernel_m(a->raw, b->raw, &values_m[0], n, &params);
+
+    /* back to counts, full scale is the block peak */
+    for(i = 0; i < n; i++)
+    {
+        const float v = fabsf(values_m[i]);
+        peak = (v > peak) ? v : peak;
+    }
+    if(peak <= 0.f)
+        peak = 1.f;
+    inverse = SHRT_MAX / peak;
+    for(i = 0; i < n; i++)
+        counts_m[i] = (short)lrintf(values_m[i] * inverse);
+
+    result->raw = (n > 0) ? &counts_m[0] : NULL;
+    result->scale = peak / SHRT_MAX;
+    result->t0 = a->t0;
+    result->dt = a->dt;
+    result->times = a->times;
+    result->count = n;
+    result->stable = 0;
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file mathchannel.h
+ * @brief Declaration of MathChannel class.
+ * A math channel combines the physical channels of a frame, e.g. A-B or
+ * 2*A+0.5. The expression is compiled once into a kernel working on whole
+ * blocks, the result is quantized back to a sample block.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef MATHCHANNEL_H
+#define MATHCHANNEL_H
+
+#include <string>
+#include <vector>
+
+#include "oscilloscope.h"
+#include "sampleblock.h"
+
+class MathChannel
+{
+public:
+    /**
+     * @brief kernel parameters, folded from the expression and the frame
+     */
+    typedef struct
+    {
+        double scale_a;
+        double scale_b;
+        double gain;
+        double offset;
+        double dt;
+    }params_t;
+    /**
+     * @brief block kernel: out[i] = gain * op(a[i], b[i]) + offset, in volts
+     */
+    typedef void (*kernel_t)(const short *a, const short *b, float *out, uint32_t n, const params_t *params);
+
+    MathChannel();
+    /**
+     * @brief compile an expression.
+     * Accepted forms are [k*]X[+c], [k*](X op Y)[+c] and [k*]f(X)[+c] with
+     * X, Y channels A to D, op one of + - * / and f one of abs, intg, diff.
+     * An empty expression or "off" disables the channel.
+     * @param[in] : expression
+     * return : 0 if successful, -1 if the expression is not understood
+     */
+    int8_t compile(const std::string &expression);
+    /** @brief true when an expression is compiled */
+    bool enabled() const { return NULL != kernel_m; }
+    /** @brief bit mask of the channels the expression reads */
+    uint8_t sources() const;
+    /**
+     * @brief evaluate the expression on a frame
+     * @param[in] : frame with the source channels
+     * @param[out] : result, valid until next call
+     * return : 0 if successful, -1 if a source channel is missing
+     */
+    int8_t evaluate(const sample_frame_t *frame, sample_block_t *result);
+private:
+    /** @brief true when the kernel reads a second channel */
+    bool binary() const;
+    kernel_t kernel_m;
+    uint8_t source_a_m;
+    uint8_t source_b_m;
+    double gain_m;
+    double offset_m;
+    std::vector<float> values_m;
+    std::vector<short> counts_m;
+};
+
+#endif // MATHCHANNEL_H
@@ -0,0 +1,234 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file minmaxpyramid.cpp
+ * @brief Definition of MinMaxPyramid class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "minmaxpyramid.h"
+
+/****************************************************************************
+ * MinMaxPyramid
+ ****************************************************************************/
+MinMaxPyramid::MinMaxPyramid() :
+    capacity_m(0),
+    count_m(0)
+{
+    memset(min_m, 0, sizeof(min_m));
+    memset(max_m, 0, sizeof(max_m));
+}
+
+/****************************************************************************
+ * ~MinMaxPyramid
+ ****************************************************************************/
+MinMaxPyramid::~MinMaxPyramid()
+{
+    uint8_t level = 0;
+
+    for(level = 0; level < MINMAX_PYRAMID_LEVELS; level++)
+    {
+        free(min_m[level]);
+        free(max_m[level]);
+    }
+}
+
+/****************************************************************************
+ * swap
+ ****************************************************************************/
+void MinMaxPyramid::swap(MinMaxPyramid &other)
+{
+    uint8_t level = 0;
+    short *levels = NULL;
+    uint32_t value = 0;
+
+    for(level = 0; level < MINMAX_PYRAMID_LEVELS; level++)
+    {
+        levels = min_m[level];
+        min_m[level] = other.min_m[level];
+        other.min_m[level] = levels;
+        levels = max_m[level];
+        max_m[level] = other.max_m[level];
+        other.max_m[level] = levels;
+    }
+    value = capacity_m;
+    capacity_m = other.capacity_m;
+    other.capacity_m = value;
+    value = count_m;
+    count_m = other.count_m;
+    other.count_m = value;
+}
+
+/****************************************************************************
+ * reserve
+ ****************************************************************************/
+int8_t MinMaxPyramid::reserve(uint32_t count)
+{
+    uint8_t level = 0;
+    short *level_min = NULL;
+    short *level_max = NULL;
+
+    if(count <= capacity_m)
+    {
+        return 0;
+    }
+    for(level = 1; (level < MINMAX_PYRAMID_LEVELS) && ((count >> level) > 0); level++)
+    {
+        level_min = (short *)realloc(min_m[level], (count >> level) * sizeof(short));
+        if(NULL != level_min)
+            min_m[level] = level_min;
+        level_max = (short *)realloc(max_m[level], (count >> level) * sizeof(short));
+        if(NULL != level_max)
+            max_m[level] = level_max;
+        if((NULL == level_min) || (NULL == level_max))
+        {
+            ERROR("unable to allocate min/max levels of %u samples\n", count);
+            // levels already grown are fine, keep the old capacity
+            return -1;
+        }
+    }
+    capacity_m = count;
+    return 0;
+}
+
+/****************************************************************************
+ * append
+ ****************************************************************************/
+int8_t MinMaxPyramid::append(const short *raw, uint32_t count)
+{
+    uint32_t j = 0;
+    uint32_t from = 0;
+    uint32_t to = 0;
+    uint8_t level = 0;
+    short *lower_min = NULL;
+    short *lower_max = NULL;
+    short *level_min = NULL;
+    short *level_max = NULL;
+
+    if((NULL == raw) || (count < count_m))
+    {
+        return -1;
+    }
+    // grow by half again to keep appends amortized
+    if((count > capacity_m) &&
+       (0 != reserve((count > capacity_m + capacity_m / 2) ? count : capacity_m + capacity_m / 2)))
+    {
+        return -1;
+    }
+    // each level only gets the cells completed by the new samples
+    for(level = 1; (level < MINMAX_PYRAMID_LEVELS) && ((count >> level) > 0); level++)
+    {
+        from = count_m >> level;
+        to = count >> level;
+        level_min = min_m[level];
+        level_max = max_m[level];
+        if(1 == level)
+        {
+            for(j = from; j < to; j++)
+            {
+                level_min[j] = (raw[2 * j] < raw[2 * j + 1]) ? raw[2 * j] : raw[2 * j + 1];
+                level_max[j] = (raw[2 * j] > raw[2 * j + 1]) ? raw[2 * j] : raw[2 * j + 1];
+            }
+        }
+        else
+        {
+            lower_min = min_m[level - 1];
+            lower_max = max_m[level - 1];
+            for(j = from; j < to; j++)
+            {
+                level_min[j] = (lower_min[2 * j] < lower_min[2 * j + 1]) ? lower_min[2 * j] : lower_min[2 * j + 1];
+                level_max[j] = (lower_max[2 * j] > lower_max[2 * j + 1]) ? lower_max[2 * j] : lower_max[2 * j + 1];
+            }
+        }
+    }
+    count_m = count;
+    return 0;
+}
+
+/****************************************************************************
+ * range
+ ****************************************************************************/
+int8_t MinMaxPyramid::range(const short *raw, uint32_t first, uint32_t last, short *min, short *max) const
+{
+    uint32_t j = 0;
+    uint32_t from = 0;
+    uint32_t to = 0;
+    uint8_t level = 0;
+    short low = 0;
+    short high = 0;
+
+    if(last > count_m)
+    {
+        last = count_m;
+    }
+    if((NULL == raw) || (first >= last))
+    {
+        return -1;
+    }
+    // coarsest level with cells not larger than half the range
+    while((level + 1 < MINMAX_PYRAMID_LEVELS) && ((2u << level) <= (last - first) / 2))
+    {
+        level++;
+    }
+    low = high = raw[first];
+    if(0 == level)
+    {
+        for(j = first; j < last; j++)
+        {
+            if(raw[j] < low)
+                low = raw[j];
+            if(raw[j] > high)
+                high = raw[j];
+        }
+    }
+    else
+    {
+        // partial cells at the ends are taken whole
+        from = first >> level;
+        to = ((last - 1) >> level) + 1;
+        if(to > (count_m >> level))
+        {
+            // trailing samples not yet in a complete cell
+            j = (to - 1) << level;
+            for(j = (j < first) ? first : j; j < last; j++)
+            {
+                if(raw[j] < low)
+                    low = raw[j];
+                if(raw[j] > high)
+                    high = raw[j];
+            }
+            to--;
+        }
+        for(j = from; j < to; j++)
+        {
+            if(min_m[level][j] < low)
+                low = min_m[level][j];
+            if(max_m[level][j] > high)
+                high = max_m[level][j];
+        }
+    }
+    *min = low;
+    *max = high;
+    return 0;
+}
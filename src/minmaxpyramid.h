@@ -0,0 +1,94 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file minmaxpyramid.h
+ * @brief Declaration of MinMaxPyramid class.
+ * Min/max levels of a capture at 2x, 4x, 8x... decimation. Levels are
+ * extended as samples are appended, and the bounds of any sample range are
+ * read from the coarsest level fitting the range, in a few steps whatever
+ * the capture length.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include "oscilloscope.h"
+
+/* level k holds the bounds of 2^k samples, up to 2^31 */
+#define MINMAX_PYRAMID_LEVELS 32
+
+class MinMaxPyramid
+{
+public:
+    MinMaxPyramid();
+    ~MinMaxPyramid();
+    /** @brief forget all samples, storage is kept */
+    void reset() { count_m = 0; }
+    /**
+     * @brief extend levels with samples appended to the capture
+     * @param[in] : all samples of the capture, the first count() ones are already in the levels
+     * @param[in] : new number of samples of the capture, not less than count()
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t append(const short *raw, uint32_t count);
+    /**
+     * @brief size levels for captures up to count samples, append then does not allocate
+     * @param[in] : number of samples
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t reserve(uint32_t count);
+    /**
+     * @brief rebuild levels for a whole capture
+     * @param[in] : samples of the capture
+     * @param[in] : number of samples
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t build(const short *raw, uint32_t count) { reset(); return append(raw, count); }
+    /**
+     * @brief exchange levels with another pyramid, no copy is made
+     * @param[in,out] : other pyramid
+     */
+    void swap(MinMaxPyramid &other);
+    /** @brief number of samples in the levels */
+    uint32_t count() const { return count_m; }
+    /**
+     * @brief bounds of samples [first, last), widened to the cells of the level used,
+     * at most half the range on each side
+     * @param[in] : samples of the capture, same as given to append
+     * @param[in] : first sample
+     * @param[in] : end of the range, not more than count()
+     * @param[out] : minimum
+     * @param[out] : maximum
+     * return : 0 if successful, -1 if the range is empty
+     */
+    int8_t range(const short *raw, uint32_t first, uint32_t last, short *min, short *max) const;
+private:
+    MinMaxPyramid(const MinMaxPyramid &);
+    MinMaxPyramid &operator=(const MinMaxPyramid &);
+    /* level k > 0: bounds of samples [j * 2^k, (j + 1) * 2^k), complete cells only */
+    short *min_m[MINMAX_PYRAMID_LEVELS];
+    short *max_m[MINMAX_PYRAMID_LEVELS];
+    uint32_t capacity_m;
+    uint32_t count_m;
+};
+
+#endif // MINMAXPYRAMID_H
@@ -32,6 +32,14 @@
 #include <stdio.h>
 #include <limits.h>
 
+#include "log.h"
+
+#define MAX_CHANNELS          4
+
+/* QSettings of the last session, reopened at start up */
+#define SETTINGS_ORGANIZATION "qpicoscope"
+#define SETTINGS_APPLICATION  "qpicoscope"
+
 /*!!! TODO remove this flag while testing with HW!!!*/
 //#define TEST_WITHOUT_HW
 
@@ -75,8 +83,12 @@ typedef enum
     E_TRIGGER_FALLING
 }trigger_e;
 
-#define DEBUG(...)     do{ fprintf(stderr, "%s\t- %s:\t[%d]\tDEBUG: ",__FILE__, __FUNCTION__,__LINE__); fprintf(stderr, __VA_ARGS__); }while(0)
-#define ERROR(...)     do{ fprintf(stderr, "%s\t- %s:\t[%d]\tERROR: ",__FILE__, __FUNCTION__,__LINE__); fprintf(stderr, __VA_ARGS__); }while(0)
-#define WARNING(...)   do{ fprintf(stderr, "%s\t- %s:\t[%d]\tWARNING: ",__FILE__, __FUNCTION__,__LINE__); fprintf(stderr, __VA_ARGS__); }while(0)
+typedef enum
+{
+    E_ACQUISITION_BLOCK = 0,
+    E_ACQUISITION_FAST_STREAMING,
+    E_ACQUISITION_ROLL,
+    E_ACQUISITION_ETS
+}acquisition_mode_e;
 
 #endif // OSCILLOSCOPE_H
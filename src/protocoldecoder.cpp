@@ -0,0 +1,444 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file protocoldecoder.cpp
+ * @brief Definition of ProtocolDecoder class and of its UART, SPI and I2C
+ * decoders.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "protocoldecoder.h"
+
+/****************************************************************************
+ * decoder event text
+ ****************************************************************************/
+void decoder_event_text(const decoder_event_t *event, char *text, size_t size)
+{
+    const char *ack = "";
+
+    if(DECODER_NO_ACK != event->ack)
+    {
+        ack = event->ack ? " ACK" : " NACK";
+    }
+    switch(event->type)
+    {
+        case E_EVENT_DATA:
+            snprintf(text, size, "0x%02X%s", event->value, ack);
+            break;
+        case E_EVENT_ADDRESS:
+            snprintf(text, size, "ADDR 0x%02X %c%s", event->value >> 1, (event->value & 1) ? 'R' : 'W', ack);
+            break;
+        case E_EVENT_START:
+            snprintf(text, size, "START");
+            break;
+        case E_EVENT_STOP:
+            snprintf(text, size, "STOP");
+            break;
+        case E_EVENT_ERROR:
+        default:
+            snprintf(text, size, "ERR 0x%02X", event->value);
+            break;
+    }
+}
+
+/****************************************************************************
+ * create
+ ****************************************************************************/
+ProtocolDecoder *ProtocolDecoder::create(const decoder_spec_t &spec)
+{
+    switch(spec.protocol)
+    {
+        case E_DECODER_UART:
+            if(spec.baud_rate <= 0.)
+            {
+                ERROR("invalid UART baud rate %f\n", spec.baud_rate);
+                return NULL;
+            }
+            return new UartDecoder(spec);
+        case E_DECODER_SPI:
+            return new SpiDecoder(spec);
+        case E_DECODER_I2C:
+            return new I2cDecoder(spec);
+        case E_DECODER_NONE:
+        default:
+            return NULL;
+    }
+}
+
+/****************************************************************************
+ * ProtocolDecoder
+ ****************************************************************************/
+ProtocolDecoder::ProtocolDecoder(const decoder_spec_t &spec, uint8_t nb_lines) :
+    spec_m(spec),
+    nb_lines_m(nb_lines),
+    source_digital_m(NULL),
+    source_count_m(0),
+    time_m(0.),
+    levels_m(0),
+    started_m(false)
+{
+    memset(source_raw_m, 0, sizeof(source_raw_m));
+    memset(source_high_m, 0, sizeof(source_high_m));
+    memset(source_low_m, 0, sizeof(source_low_m));
+}
+
+ProtocolDecoder::~ProtocolDecoder()
+{
+}
+
+/****************************************************************************
+ * reset
+ ****************************************************************************/
+void ProtocolDecoder::reset(double time)
+{
+    time_m = time;
+    levels_m = 0;
+    started_m = false;
+    restart();
+}
+
+/****************************************************************************
+ * push event
+ ****************************************************************************/
+void ProtocolDecoder::push_event(decoder_event_type_e type, double time, double end, uint16_t value, uint8_t ack)
+{
+    decoder_event_t event;
+
+    if(events_m.size() >= DECODER_MAX_EVENTS)
+    {
+        // drop the oldest half at once, so the cost stays amortized
+        events_m.erase(events_m.begin(), events_m.begin() + DECODER_MAX_EVENTS / 2);
+    }
+    event.time = time;
+    event.end = end;
+    event.type = type;
+    event.value = value;
+    event.ack = ack;
+    events_m.push_back(event);
+}
+
+/****************************************************************************
+ * next edge - first sample at or after from whose level differs
+ ****************************************************************************/
+uint32_t ProtocolDecoder::next_edge(uint8_t line, uint32_t from, uint8_t levels) const
+{
+    const short *raw = source_raw_m[line];
+    uint8_t level = (levels >> line) & 1;
+    uint32_t i = from;
+
+    if(from >= source_count_m)
+    {
+        return source_count_m;
+    }
+    if(NULL != source_digital_m)
+    {
+        if(DECODER_NO_LINE == spec_m.lines[line])
+        {
+            return source_count_m;
+        }
+        if(source_digital_m->level(spec_m.lines[line], from) != level)
+        {
+            return from;
+        }
+        return source_digital_m->next_transition(spec_m.lines[line], from);
+    }
+    if(NULL == raw)
+    {
+        return source_count_m;
+    }
+    // hysteresis: a high line must fall below low, a low line rise above high
+    if(level)
+    {
+        while((i < source_count_m) && (raw[i] > source_low_m[line]))
+            i++;
+    }
+    else
+    {
+        while((i < source_count_m) && (raw[i] < source_high_m[line]))
+            i++;
+    }
+    return i;
+}
+
+/****************************************************************************
+ * dispatch - merge line transitions in time order
+ ****************************************************************************/
+void ProtocolDecoder::dispatch(uint32_t count, double dt)
+{
+    uint32_t next[DECODER_MAX_LINES];
+    uint8_t levels = levels_m;
+    uint8_t line = 0;
+    uint8_t first = 0;
+
+    source_count_m = count;
+    if(0 == count)
+    {
+        return;
+    }
+    if(!started_m)
+    {
+        // the first sample gives the initial levels, it is not an edge
+        for(line = 0; line < nb_lines_m; line++)
+        {
+            if(next_edge(line, 0, levels) == 0)
+            {
+                levels ^= (1 << line);
+            }
+        }
+        started_m = true;
+    }
+    for(line = 0; line < nb_lines_m; line++)
+    {
+        next[line] = next_edge(line, 0, levels);
+    }
+    for(;;)
+    {
+        first = 0;
+        for(line = 1; line < nb_lines_m; line++)
+        {
+            if(next[line] < next[first])
+                first = line;
+        }
+        if(next[first] >= count)
+        {
+            break;
+        }
+        levels ^= (1 << first);
+        edge(first, levels, time_m + next[first] * dt);
+        next[first] = next_edge(first, next[first] + 1, levels);
+    }
+    time_m += count * dt;
+    levels_m = levels;
+    advance(levels, time_m);
+}
+
+/****************************************************************************
+ * feed analog
+ ****************************************************************************/
+void ProtocolDecoder::feed_analog(const short * const *raw, const double *scale, uint32_t count, double dt)
+{
+    uint8_t line = 0;
+    uint8_t ch = 0;
+    double high = spec_m.threshold + spec_m.hysteresis / 2.;
+    double low = spec_m.threshold - spec_m.hysteresis / 2.;
+
+    source_digital_m = NULL;
+    for(line = 0; line < nb_lines_m; line++)
+    {
+        ch = spec_m.lines[line];
+        source_raw_m[line] = NULL;
+        if((ch < MAX_CHANNELS) && (NULL != raw[ch]) && (scale[ch] > 0.))
+        {
+            source_raw_m[line] = raw[ch];
+            source_high_m[line] = (short)(high / scale[ch]);
+            source_low_m[line] = (short)(low / scale[ch]);
+        }
+    }
+    dispatch(count, dt);
+}
+
+/****************************************************************************
+ * feed digital
+ ****************************************************************************/
+void ProtocolDecoder::feed_digital(const DigitalBlock *block)
+{
+    source_digital_m = block;
+    dispatch(block->count(), block->dt());
+    source_digital_m = NULL;
+}
+
+/****************************************************************************
+ * UartDecoder - 8 data bits, LSB first, no parity, 1 stop bit
+ ****************************************************************************/
+UartDecoder::UartDecoder(const decoder_spec_t &spec) :
+    ProtocolDecoder(spec, 1),
+    bit_time_m(1. / spec.baud_rate)
+{
+    restart();
+}
+
+void UartDecoder::restart()
+{
+    in_frame_m = false;
+    frame_start_m = 0.;
+    bit_m = 0;
+    level_m = 1;
+    value_m = 0;
+}
+
+/****************************************************************************
+ * sample until - bits are read at their center, the level holds since the last edge
+ ****************************************************************************/
+void UartDecoder::sample_until(double time)
+{
+    double center = 0.;
+
+    while(in_frame_m)
+    {
+        center = frame_start_m + (bit_m + 0.5) * bit_time_m;
+        if(center >= time)
+        {
+            break;
+        }
+        if(0 == bit_m)
+        {
+            if(level_m)
+            {
+                // start bit too short: glitch
+                in_frame_m = false;
+                break;
+            }
+        }
+        else if(bit_m <= 8)
+        {
+            value_m |= (uint16_t)(level_m << (bit_m - 1));
+        }
+        else
+        {
+            push_event(level_m ? E_EVENT_DATA : E_EVENT_ERROR, frame_start_m, frame_start_m + 10 * bit_time_m, value_m, DECODER_NO_ACK);
+            in_frame_m = false;
+            break;
+        }
+        bit_m++;
+    }
+}
+
+void UartDecoder::edge(uint8_t line, uint8_t levels, double time)
+{
+    (void)line;
+    sample_until(time);
+    level_m = levels & 1;
+    if(!in_frame_m && (0 == level_m))
+    {
+        in_frame_m = true;
+        frame_start_m = time;
+        bit_m = 0;
+        value_m = 0;
+    }
+}
+
+void UartDecoder::advance(uint8_t levels, double time)
+{
+    (void)levels;
+    sample_until(time);
+}
+
+/****************************************************************************
+ * SpiDecoder - mode 0, data sampled on rising clock, MSB first
+ ****************************************************************************/
+SpiDecoder::SpiDecoder(const decoder_spec_t &spec) :
+    ProtocolDecoder(spec, 3)
+{
+    restart();
+}
+
+void SpiDecoder::restart()
+{
+    bit_m = 0;
+    value_m = 0;
+    first_edge_m = 0.;
+}
+
+void SpiDecoder::edge(uint8_t line, uint8_t levels, double time)
+{
+    // a missing chip select line reads low: always selected
+    bool selected = !(levels & 4);
+
+    if(2 == line)
+    {
+        // chip select change: byte boundary
+        restart();
+        return;
+    }
+    if((0 != line) || !(levels & 1) || !selected)
+    {
+        return;
+    }
+    if(0 == bit_m)
+    {
+        first_edge_m = time;
+    }
+    value_m = (uint16_t)((value_m << 1) | ((levels >> 1) & 1));
+    if(++bit_m == 8)
+    {
+        push_event(E_EVENT_DATA, first_edge_m, time, value_m, DECODER_NO_ACK);
+        bit_m = 0;
+        value_m = 0;
+    }
+}
+
+/****************************************************************************
+ * I2cDecoder
+ ****************************************************************************/
+I2cDecoder::I2cDecoder(const decoder_spec_t &spec) :
+    ProtocolDecoder(spec, 2)
+{
+    restart();
+}
+
+void I2cDecoder::restart()
+{
+    state_m = E_I2C_IDLE;
+    bit_m = 0;
+    value_m = 0;
+    first_edge_m = 0.;
+}
+
+void I2cDecoder::edge(uint8_t line, uint8_t levels, double time)
+{
+    uint8_t scl = levels & 1;
+    uint8_t sda = (levels >> 1) & 1;
+
+    if(1 == line)
+    {
+        // data changes while the clock is high are start and stop conditions
+        if(scl)
+        {
+            push_event(sda ? E_EVENT_STOP : E_EVENT_START, time, time, 0, DECODER_NO_ACK);
+            state_m = sda ? E_I2C_IDLE : E_I2C_ADDRESS;
+            bit_m = 0;
+            value_m = 0;
+        }
+        return;
+    }
+    if(!scl || (E_I2C_IDLE == state_m))
+    {
+        return;
+    }
+    if(0 == bit_m)
+    {
+        first_edge_m = time;
+    }
+    if(bit_m < 8)
+    {
+        value_m = (uint16_t)((value_m << 1) | sda);
+        bit_m++;
+        return;
+    }
+    // ninth clock: acknowledge, low for ACK
+    push_event((E_I2C_ADDRESS == state_m) ? E_EVENT_ADDRESS : E_EVENT_DATA, first_edge_m, time, value_m, !sda);
+    state_m = E_I2C_DATA;
+    bit_m = 0;
+    value_m = 0;
+}
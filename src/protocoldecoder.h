@@ -0,0 +1,215 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file protocoldecoder.h
+ * @brief Declaration of ProtocolDecoder class and of its UART, SPI and I2C
+ * decoders.
+ * Lines are thresholded analog channels or digital lines. Decoders only see
+ * level transitions, runs of identical samples are skipped, and keep their
+ * state between calls so a stream is decoded across block boundaries.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef PROTOCOLDECODER_H
+#define PROTOCOLDECODER_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "oscilloscope.h"
+#include "digitalblock.h"
+
+#define DECODER_MAX_LINES   3
+#define DECODER_NO_LINE     0xFF
+#define DECODER_NO_ACK      0xFF
+/* oldest events are dropped beyond this count */
+#define DECODER_MAX_EVENTS  4096
+
+typedef enum
+{
+    E_DECODER_NONE = 0,
+    E_DECODER_UART,  /* lines: rx */
+    E_DECODER_SPI,   /* lines: clock, data, chip select (optional) */
+    E_DECODER_I2C    /* lines: scl, sda */
+}decoder_protocol_e;
+
+typedef enum
+{
+    E_EVENT_DATA = 0,
+    E_EVENT_ADDRESS,
+    E_EVENT_START,
+    E_EVENT_STOP,
+    E_EVENT_ERROR
+}decoder_event_type_e;
+
+typedef struct
+{
+    decoder_protocol_e protocol;
+    /** @brief non zero when lines are digital lines, else analog channels */
+    uint8_t digital;
+    /** @brief channel or digital line of each protocol line, DECODER_NO_LINE if unused */
+    uint8_t lines[DECODER_MAX_LINES];
+    /** @brief analog threshold and hysteresis, in volts */
+    double threshold;
+    double hysteresis;
+    /** @brief UART bit rate, 8 data bits, no parity, 1 stop bit */
+    double baud_rate;
+}decoder_spec_t;
+
+typedef struct
+{
+    /** @brief start and end of the event, in seconds */
+    double time;
+    double end;
+    decoder_event_type_e type;
+    /** @brief byte value, I2C address with read/write bit for E_EVENT_ADDRESS */
+    uint16_t value;
+    /** @brief I2C acknowledge bit, 1 for ACK, DECODER_NO_ACK for other protocols */
+    uint8_t ack;
+}decoder_event_t;
+
+/**
+ * @brief format an event for display
+ * @param[in] : event
+ * @param[out] : text buffer
+ * @param[in] : text buffer size
+ */
+void decoder_event_text(const decoder_event_t *event, char *text, size_t size);
+
+class ProtocolDecoder
+{
+public:
+    /**
+     * @brief create the decoder of a protocol
+     * return : decoder to delete by the caller, NULL for E_DECODER_NONE
+     */
+    static ProtocolDecoder *create(const decoder_spec_t &spec);
+    virtual ~ProtocolDecoder();
+    /**
+     * @brief forget decoder state, next samples start a new stream
+     * @param[in] : time of the next sample, in seconds
+     */
+    void reset(double time);
+    /** @brief drop decoded events */
+    void clear_events() { events_m.clear(); }
+    /**
+     * @brief decode contiguous samples of analog channels
+     * @param[in] : raw ADC counts per channel, MAX_CHANNELS entries, unused ones may be NULL
+     * @param[in] : volts per ADC count per channel
+     * @param[in] : number of samples
+     * @param[in] : sample interval, in seconds
+     */
+    void feed_analog(const short * const *raw, const double *scale, uint32_t count, double dt);
+    /**
+     * @brief decode contiguous samples of digital lines
+     * @param[in] : digital block
+     */
+    void feed_digital(const DigitalBlock *block);
+    /** @brief time of the next sample, in seconds */
+    double time() const { return time_m; }
+    const decoder_spec_t &spec() const { return spec_m; }
+    const std::vector<decoder_event_t> &events() const { return events_m; }
+protected:
+    ProtocolDecoder(const decoder_spec_t &spec, uint8_t nb_lines);
+    /**
+     * @brief a protocol line changed
+     * @param[in] : protocol line index
+     * @param[in] : levels of all protocol lines after the change, bit per line
+     * @param[in] : time of the change, in seconds
+     */
+    virtual void edge(uint8_t line, uint8_t levels, double time) = 0;
+    /**
+     * @brief no change until time, called at the end of each call to feed
+     */
+    virtual void advance(uint8_t levels, double time) { (void)levels; (void)time; }
+    /** @brief forget protocol state */
+    virtual void restart() = 0;
+    void push_event(decoder_event_type_e type, double time, double end, uint16_t value, uint8_t ack);
+    decoder_spec_t spec_m;
+    uint8_t nb_lines_m;
+private:
+    uint32_t next_edge(uint8_t line, uint32_t from, uint8_t levels) const;
+    void dispatch(uint32_t count, double dt);
+    /* source of the current call to feed, per protocol line */
+    const short *source_raw_m[DECODER_MAX_LINES];
+    short source_high_m[DECODER_MAX_LINES];
+    short source_low_m[DECODER_MAX_LINES];
+    const DigitalBlock *source_digital_m;
+    uint32_t source_count_m;
+    std::vector<decoder_event_t> events_m;
+    double time_m;
+    /* levels of protocol lines at the end of the last call, bit per line */
+    uint8_t levels_m;
+    bool started_m;
+};
+
+class UartDecoder : public ProtocolDecoder
+{
+public:
+    UartDecoder(const decoder_spec_t &spec);
+protected:
+    void edge(uint8_t line, uint8_t levels, double time);
+    void advance(uint8_t levels, double time);
+    void restart();
+private:
+    void sample_until(double time);
+    bool in_frame_m;
+    double frame_start_m;
+    double bit_time_m;
+    uint8_t bit_m;
+    uint8_t level_m;
+    uint16_t value_m;
+};
+
+class SpiDecoder : public ProtocolDecoder
+{
+public:
+    SpiDecoder(const decoder_spec_t &spec);
+protected:
+    void edge(uint8_t line, uint8_t levels, double time);
+    void restart();
+private:
+    uint8_t bit_m;
+    uint16_t value_m;
+    double first_edge_m;
+};
+
+class I2cDecoder : public ProtocolDecoder
+{
+public:
+    I2cDecoder(const decoder_spec_t &spec);
+protected:
+    void edge(uint8_t line, uint8_t levels, double time);
+    void restart();
+private:
+    typedef enum
+    {
+        E_I2C_IDLE = 0,
+        E_I2C_ADDRESS,
+        E_I2C_DATA
+    }i2c_state_e;
+    i2c_state_e state_m;
+    uint8_t bit_m;
+    uint16_t value_m;
+    double first_edge_m;
+};
+
+#endif // PROTOCOLDECODER_H
@@ -1,10 +1,36 @@
 TEMPLATE    = app
 CONFIG        += qt warn_on
+# highest log level compiled in: 0 errors, 1 warnings, 2 debug
+#DEFINES       += LOG_LEVEL_MAX=1
 HEADERS        = screen.h \
                  frontpanel.h \
                  comborange.h \
                  oscilloscope.h \
                  acquisition.h \
+                 bufferpool.h \
+                 samplering.h \
+                 acquisitionpipeline.h \
+                 sampleblock.h \
+                 sampleblockseries.h \
+                 rasterrenderer.h \
+                 mathchannel.h \
+                 filter.h \
+                 digitalblock.h \
+                 logicitem.h \
+                 protocoldecoder.h \
+                 eventitem.h \
+                 decoderview.h \
+                 masktest.h \
+                 waveformaverager.h \
+                 etsreconstructor.h \
+                 minmaxpyramid.h \
+                 waveformhistory.h \
+                 exporter.h \
+                 log.h \
+                 driverlibrary.h \
+                 triplebuffer.h \
+                 signalanalyzer.h \
+                 analysisview.h \
                  acquisition2000.h \
                  acquisition2000a.h \
                  acquisition3000.h \
@@ -15,6 +41,28 @@ SOURCES        = screen.cpp \
                  main.cpp \
                  comborange.cpp \
                  acquisition.cpp \
+                 bufferpool.cpp \
+                 samplering.cpp \
+                 sampleblockseries.cpp \
+                 rasterrenderer.cpp \
+                 mathchannel.cpp \
+                 filter.cpp \
+                 digitalblock.cpp \
+                 logicitem.cpp \
+                 protocoldecoder.cpp \
+                 eventitem.cpp \
+                 decoderview.cpp \
+                 masktest.cpp \
+                 waveformaverager.cpp \
+                 etsreconstructor.cpp \
+                 minmaxpyramid.cpp \
+                 waveformhistory.cpp \
+                 exporter.cpp \
+                 log.cpp \
+                 driverlibrary.cpp \
+                 triplebuffer.cpp \
+                 signalanalyzer.cpp \
+                 analysisview.cpp \
                  acquisition2000.cpp \
                  acquisition2000a.cpp \
                  acquisition3000.cpp \
@@ -22,7 +70,13 @@ SOURCES        = screen.cpp \
                  search-for-acquisition-device-worker.cpp
 TARGET        = QPicoscope
 QTDIR_build:REQUIRES="contains(QT_CONFIG, full-config)"
-unix:LIBS += -lm -lps2000 -lps3000
+# qmake CONFIG+=dynlink loads the Picotech libraries at run time
+dynlink {
+    DEFINES += DYNLINK
+    unix:LIBS += -lm -ldl
+} else {
+    unix:LIBS += -lm -lps2000 -lps3000
+}
 
 # install
 target.path = ./
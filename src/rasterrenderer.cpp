@@ -0,0 +1,218 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file rasterrenderer.cpp
+ * @brief Definition of RasterRenderer and RasterItem classes.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <limits.h>
+#include <math.h>
+
+#include <QPainter>
+
+#include "rasterrenderer.h"
+
+/****************************************************************************
+ * RasterRenderer
+ ****************************************************************************/
+RasterRenderer::RasterRenderer() :
+    active_m(false),
+    x_min_m(0.),
+    x_max_m(1.),
+    y_min_m(-1.),
+    y_max_m(1.)
+{
+}
+
+/****************************************************************************
+ * begin
+ ****************************************************************************/
+void RasterRenderer::begin(int width, int height, double x_min, double x_max, double y_min, double y_max)
+{
+    if((image_m.width() != width) || (image_m.height() != height))
+    {
+        image_m = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+        column_min_m.resize(width);
+        column_max_m.resize(width);
+    }
+    image_m.fill(0);
+    x_min_m = x_min;
+    x_max_m = x_max;
+    y_min_m = y_min;
+    y_max_m = y_max;
+    active_m = true;
+}
+
+/****************************************************************************
+ * drawBlock
+ ****************************************************************************/
+void RasterRenderer::drawBlock(const sample_block_t *block, QRgb color)
+{
+    const int width = image_m.width();
+    const int height = image_m.height();
+    int column = 0;
+    int row = 0;
+    uint32_t i = 0;
+    double x_scale = 0.;
+    double y_scale = 0.;
+
+    if((NULL == block) || (0 == block->count) || (width <= 0) || (height <= 0) ||
+       (x_max_m <= x_min_m) || (y_max_m <= y_min_m))
+    {
+        return;
+    }
+    x_scale = width / (x_max_m - x_min_m);
+    y_scale = (height - 1) / (y_max_m - y_min_m);
+
+    /* one pass on the samples: min and max row of each pixel column */
+    for(column = 0; column < width; column++)
+    {
+        column_min_m[column] = INT_MAX;
+        column_max_m[column] = INT_MIN;
+    }
+    for(i = 0; i < block->count; i++)
+    {
+        column = (int)((sample_block_time(block, i) - x_min_m) * x_scale);
+        if((column < 0) || (column >= width))
+        {
+            continue;
+        }
+        row = (int)((y_max_m - block->scale * block->raw[i]) * y_scale);
+        row = (row < 0) ? 0 : ((row >= height) ? height - 1 : row);
+        if(row < column_min_m[column])
+            column_min_m[column] = row;
+        if(row > column_max_m[column])
+            column_max_m[column] = row;
+    }
+
+    fillColumns(color);
+}
+
+/****************************************************************************
+ * drawPyramid
+ ****************************************************************************/
+void RasterRenderer::drawPyramid(const sample_block_t *block, const MinMaxPyramid *pyramid, QRgb color)
+{
+    const int width = image_m.width();
+    const int height = image_m.height();
+    int column = 0;
+    int low = 0;
+    int high = 0;
+    double first = 0.;
+    double last = 0.;
+    double per_column = 0.;
+    short min = 0;
+    short max = 0;
+    double y_scale = 0.;
+
+    if((NULL == block) || (NULL != block->times) || (0 == block->count) || (block->dt <= 0.) ||
+       (NULL == pyramid) || (pyramid->count() != block->count) ||
+       (width <= 0) || (height <= 0) || (x_max_m <= x_min_m) || (y_max_m <= y_min_m))
+    {
+        drawBlock(block, color);
+        return;
+    }
+    y_scale = (height - 1) / (y_max_m - y_min_m);
+    per_column = (x_max_m - x_min_m) / width / block->dt;
+
+    /* sample range of each pixel column, bounds read from the levels */
+    for(column = 0; column < width; column++)
+    {
+        column_min_m[column] = INT_MAX;
+        column_max_m[column] = INT_MIN;
+        first = ceil((x_min_m - block->t0) / block->dt + column * per_column);
+        last = ceil((x_min_m - block->t0) / block->dt + (column + 1) * per_column);
+        first = (first < 0.) ? 0. : first;
+        last = (last > block->count) ? block->count : last;
+        if((last <= first) || (0 != pyramid->range(block->raw, (uint32_t)first, (uint32_t)last, &min, &max)))
+        {
+            continue;
+        }
+        low = (int)((y_max_m - block->scale * max) * y_scale);
+        high = (int)((y_max_m - block->scale * min) * y_scale);
+        column_min_m[column] = (low < 0) ? 0 : ((low >= height) ? height - 1 : low);
+        column_max_m[column] = (high < 0) ? 0 : ((high >= height) ? height - 1 : high);
+    }
+    fillColumns(color);
+}
+
+/****************************************************************************
+ * fillColumns
+ ****************************************************************************/
+void RasterRenderer::fillColumns(QRgb color)
+{
+    const int width = image_m.width();
+    int column = 0;
+    int row = 0;
+    int low = 0;
+    int high = 0;
+    uchar *bits = NULL;
+    int stride = 0;
+
+    /* one span per column, joined with the previous column to keep the trace continuous */
+    bits = image_m.bits();
+    stride = image_m.bytesPerLine();
+    for(column = 0; column < width; column++)
+    {
+        low = column_min_m[column];
+        high = column_max_m[column];
+        if(low > high)
+        {
+            continue;
+        }
+        if((column > 0) && (column_min_m[column - 1] <= column_max_m[column - 1]))
+        {
+            if(low > column_max_m[column - 1])
+                low = column_max_m[column - 1];
+            if(high < column_min_m[column - 1])
+                high = column_min_m[column - 1];
+        }
+        for(row = low; row <= high; row++)
+        {
+            ((QRgb*)(bits + row * stride))[column] = color;
+        }
+    }
+}
+
+/****************************************************************************
+ * RasterItem
+ ****************************************************************************/
+RasterItem::RasterItem(RasterRenderer * const *front) :
+    front_m(front)
+{
+}
+
+#if ( QWT_VERSION >= 0x060000)
+void RasterItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
+#else
+void RasterItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRect &canvasRect) const
+#endif
+{
+    const RasterRenderer *front = *front_m;
+
+    (void)xMap;
+    (void)yMap;
+    if(front->active())
+    {
+        painter->drawImage(canvasRect, front->image());
+    }
+}
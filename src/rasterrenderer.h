@@ -0,0 +1,105 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file rasterrenderer.h
+ * @brief Declaration of RasterRenderer and RasterItem classes.
+ * Dense traces are drawn as one vertical min/max span per pixel column into
+ * an image, then the image is blitted on the plot canvas.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef RASTERRENDERER_H
+#define RASTERRENDERER_H
+
+#include <vector>
+
+#include <QImage>
+#include <qwt_plot_item.h>
+
+#include "oscilloscope.h"
+#include "sampleblock.h"
+#include "minmaxpyramid.h"
+
+class RasterRenderer
+{
+public:
+    RasterRenderer();
+    /**
+     * @brief start a new image, all channels are transparent
+     * @param[in] : image width in pixels
+     * @param[in] : image height in pixels
+     * @param[in] : time of the left edge, in seconds
+     * @param[in] : time of the right edge, in seconds
+     * @param[in] : voltage of the bottom edge
+     * @param[in] : voltage of the top edge
+     */
+    void begin(int width, int height, double x_min, double x_max, double y_min, double y_max);
+    /**
+     * @brief draw a sample block, costs one pass on samples plus one span per column
+     * @param[in] : sample block
+     * @param[in] : trace color
+     */
+    void drawBlock(const sample_block_t *block, QRgb color);
+    /**
+     * @brief draw a block with uniform time base from its min/max levels,
+     * costs a few steps per column whatever the number of samples
+     * @param[in] : sample block
+     * @param[in] : min/max levels of the block samples
+     * @param[in] : trace color
+     */
+    void drawPyramid(const sample_block_t *block, const MinMaxPyramid *pyramid, QRgb color);
+    /**
+     * @brief forget the image, nothing will be blitted
+     */
+    void clear() { active_m = false; }
+    bool active() const { return active_m; }
+    const QImage &image() const { return image_m; }
+private:
+    /** @brief fill the image with one span per column from column_min_m and column_max_m */
+    void fillColumns(QRgb color);
+    QImage image_m;
+    bool active_m;
+    double x_min_m;
+    double x_max_m;
+    double y_min_m;
+    double y_max_m;
+    std::vector<int> column_min_m;
+    std::vector<int> column_max_m;
+};
+
+class RasterItem : public QwtPlotItem
+{
+public:
+    /**
+     * @brief constructor
+     * @param[in] : location of the current renderer pointer, read at each draw
+     */
+    RasterItem(RasterRenderer * const *front);
+#if ( QWT_VERSION >= 0x060000)
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const;
+#else
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRect &canvasRect) const;
+#endif
+private:
+    RasterRenderer * const *front_m;
+};
+
+#endif // RASTERRENDERER_H
@@ -0,0 +1,92 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file sampleblock.h
+ * @brief Declaration of the sample block type.
+ * A sample block describes one channel capture as raw ADC counts plus the
+ * scale and time base needed to turn them into volts and seconds. Time is
+ * implicit (start and interval) unless the mode samples unevenly.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef SAMPLEBLOCK_H
+#define SAMPLEBLOCK_H
+
+#include <stddef.h>
+
+#include "oscilloscope.h"
+
+/* frames carry the physical channels plus the math channel */
+#define MATH_CHANNEL     MAX_CHANNELS
+#define FRAME_CHANNELS   (MAX_CHANNELS + 1)
+
+class DigitalBlock;
+
+typedef struct
+{
+    /** @brief raw ADC counts, count elements */
+    const short *raw;
+    /** @brief volts per ADC count */
+    double scale;
+    /** @brief time of the first sample, in seconds */
+    double t0;
+    /** @brief sample interval, in seconds */
+    double dt;
+    /** @brief number of samples */
+    uint32_t count;
+    /** @brief leading samples unchanged since the previous frame of the channel, the
+     * others are appended to them; 0 when the whole block may have changed */
+    uint32_t stable;
+    /** @brief explicit sample times in seconds for non uniform modes (ETS),
+     * NULL when time is t0 + i * dt */
+    const double *times;
+}sample_block_t;
+
+/**
+ * @brief all enabled channels of one capture, delivered together
+ */
+typedef struct
+{
+    /** @brief capture counter, increases by one per frame */
+    uint32_t sequence;
+    /** @brief non zero when the capture was triggered */
+    uint8_t triggered;
+    /** @brief trigger time in the frame time base, in seconds */
+    double trigger_time;
+    /** @brief bit mask of channels present in blocks (bit 0 for channel A, etc, bit MATH_CHANNEL for math) */
+    uint8_t channels;
+    sample_block_t blocks[FRAME_CHANNELS];
+    /** @brief logic lines of mixed signal captures, NULL when none */
+    const DigitalBlock *digital;
+}sample_frame_t;
+
+/**
+ * @brief time of a sample
+ * @param[in] : sample block
+ * @param[in] : sample index
+ * return : time in seconds
+ */
+inline double sample_block_time(const sample_block_t *block, uint32_t i)
+{
+    return (NULL != block->times) ? block->times[i] : block->t0 + i * block->dt;
+}
+
+#endif // SAMPLEBLOCK_H
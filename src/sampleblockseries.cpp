@@ -0,0 +1,197 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file sampleblockseries.cpp
+ * @brief Definition of SampleBlockSeries class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sampleblockseries.h"
+
+/****************************************************************************
+ * series_block_copy
+ ****************************************************************************/
+int8_t series_block_copy(series_block_t *dst, const sample_block_t *src)
+{
+    dst->block.count = 0;
+    return series_block_extend(dst, src);
+}
+
+/****************************************************************************
+ * series_block_reserve
+ ****************************************************************************/
+int8_t series_block_reserve(series_block_t *block, uint32_t nb_samples)
+{
+    if( block->capacity < nb_samples )
+    {
+        short *storage = (short*)realloc(block->storage, nb_samples * sizeof(short));
+        if( NULL == storage )
+        {
+            ERROR("cannot allocate %u samples\n", nb_samples);
+            return -1;
+        }
+        block->storage = storage;
+        block->capacity = nb_samples;
+        block->block.raw = storage;
+    }
+    return 0;
+}
+
+/****************************************************************************
+ * series_block_extend
+ ****************************************************************************/
+int8_t series_block_extend(series_block_t *dst, const sample_block_t *src)
+{
+    uint32_t i = (dst->block.count < src->count) ? dst->block.count : src->count;
+    short sample = 0;
+    short min = dst->min;
+    short max = dst->max;
+
+    if( 0 != series_block_reserve(dst, src->count) )
+    {
+        return -1;
+    }
+    if( 0 == i )
+    {
+        min = max = (src->count > 0) ? src->raw[0] : 0;
+    }
+    for( ; i < src->count; i++ )
+    {
+        sample = src->raw[i];
+        dst->storage[i] = sample;
+        if( sample < min )
+            min = sample;
+        if( sample > max )
+            max = sample;
+    }
+    dst->block = *src;
+    dst->block.raw = dst->storage;
+    if( NULL != src->times )
+    {
+        if( dst->times_capacity < src->count )
+        {
+            double *times = (double*)realloc(dst->times_storage, src->count * sizeof(double));
+            if( NULL == times )
+            {
+                ERROR("cannot allocate %u sample times\n", src->count);
+                dst->block.count = 0;
+                return -1;
+            }
+            dst->times_storage = times;
+            dst->times_capacity = src->count;
+        }
+        memcpy(dst->times_storage, src->times, src->count * sizeof(double));
+        dst->block.times = dst->times_storage;
+    }
+    dst->min = min;
+    dst->max = max;
+    dst->view_first = 0;
+    dst->view_count = src->count;
+    return 0;
+}
+
+/****************************************************************************
+ * series_block_free
+ ****************************************************************************/
+void series_block_free(series_block_t *block)
+{
+    free(block->storage);
+    free(block->times_storage);
+    memset(block, 0, sizeof(series_block_t));
+}
+
+/****************************************************************************
+ * SampleBlockSeries
+ ****************************************************************************/
+SampleBlockSeries::SampleBlockSeries(series_block_t * const *front) :
+    front_m(front)
+{
+}
+
+size_t SampleBlockSeries::size() const
+{
+    // rastered blocks are already on the canvas, the curve draws nothing
+    return (*front_m)->rastered ? 0 : (*front_m)->view_count;
+}
+
+#if ( QWT_VERSION >= 0x060000)
+QPointF SampleBlockSeries::sample(size_t i) const
+{
+    const sample_block_t *block = &(*front_m)->block;
+    i += (*front_m)->view_first;
+    return QPointF(sample_block_time(block, i), block->scale * block->raw[i]);
+}
+
+QRectF SampleBlockSeries::boundingRect() const
+{
+    const series_block_t *front = *front_m;
+    double first = 0.;
+    double last = 0.;
+
+    if( 0 == front->block.count )
+    {
+        return QRectF(1.0, 1.0, -2.0, -2.0); // invalid
+    }
+    first = sample_block_time(&front->block, 0);
+    last = sample_block_time(&front->block, front->block.count - 1);
+    return QRectF(first,
+                  front->block.scale * front->min,
+                  last - first,
+                  front->block.scale * (front->max - front->min));
+}
+#else
+QwtData *SampleBlockSeries::copy() const
+{
+    return new SampleBlockSeries(front_m);
+}
+
+double SampleBlockSeries::x(size_t i) const
+{
+    return sample_block_time(&(*front_m)->block, i + (*front_m)->view_first);
+}
+
+double SampleBlockSeries::y(size_t i) const
+{
+    const sample_block_t *block = &(*front_m)->block;
+    return block->scale * block->raw[i + (*front_m)->view_first];
+}
+
+QwtDoubleRect SampleBlockSeries::boundingRect() const
+{
+    const series_block_t *front = *front_m;
+    double first = 0.;
+    double last = 0.;
+
+    if( 0 == front->block.count )
+    {
+        return QwtDoubleRect(1.0, 1.0, -2.0, -2.0); // invalid
+    }
+    first = sample_block_time(&front->block, 0);
+    last = sample_block_time(&front->block, front->block.count - 1);
+    return QwtDoubleRect(first,
+                         front->block.scale * front->min,
+                         last - first,
+                         front->block.scale * (front->max - front->min));
+}
+#endif
@@ -0,0 +1,117 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file sampleblockseries.h
+ * @brief Declaration of SampleBlockSeries class.
+ * Qwt data adapter reading a channel sample block in place, so curves are
+ * refreshed by swapping a block pointer instead of copying samples.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef SAMPLEBLOCKSERIES_H
+#define SAMPLEBLOCKSERIES_H
+
+#include <qwt_global.h>
+#if ( QWT_VERSION >= 0x060000)
+#include <qwt_series_data.h>
+#else
+#include <qwt_data.h>
+#endif
+
+#include "oscilloscope.h"
+#include "sampleblock.h"
+
+/**
+ * @brief a sample block with its own copy of the counts and cached bounds
+ */
+typedef struct
+{
+    sample_block_t block;
+    short *storage;
+    uint32_t capacity;
+    double *times_storage;
+    uint32_t times_capacity;
+    short min;
+    short max;
+    /** @brief non zero when the block is drawn by the raster renderer instead of the curve */
+    uint8_t rastered;
+    /** @brief samples handed to the curve, the visible ones when zoomed in */
+    uint32_t view_first;
+    uint32_t view_count;
+}series_block_t;
+
+/**
+ * @brief copy a sample block into a series block, computing its bounds
+ * @param[out] : series block, storage grows when needed
+ * @param[in] : sample block to copy
+ * return : 0 if successful, -1 in case of error
+ */
+int8_t series_block_copy(series_block_t *dst, const sample_block_t *src);
+
+/**
+ * @brief grow a series block storage, samples are kept
+ * @param[in,out] : series block
+ * @param[in] : number of samples the storage must hold
+ * return : 0 if successful, -1 in case of error
+ */
+int8_t series_block_reserve(series_block_t *block, uint32_t nb_samples);
+
+/**
+ * @brief copy the samples appended to a series block, the dst->block.count
+ * first ones being the same in both blocks
+ * @param[in,out] : series block, storage grows when needed
+ * @param[in] : sample block extending the series block
+ * return : 0 if successful, -1 in case of error
+ */
+int8_t series_block_extend(series_block_t *dst, const sample_block_t *src);
+
+/**
+ * @brief free a series block storage
+ */
+void series_block_free(series_block_t *block);
+
+#if ( QWT_VERSION >= 0x060000)
+class SampleBlockSeries : public QwtSeriesData<QPointF>
+#else
+class SampleBlockSeries : public QwtData
+#endif
+{
+public:
+    /**
+     * @brief constructor
+     * @param[in] : location of the current block pointer, read at each access
+     */
+    SampleBlockSeries(series_block_t * const *front);
+    virtual size_t size() const;
+#if ( QWT_VERSION >= 0x060000)
+    virtual QPointF sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+#else
+    virtual QwtData *copy() const;
+    virtual double x(size_t i) const;
+    virtual double y(size_t i) const;
+    virtual QwtDoubleRect boundingRect() const;
+#endif
+private:
+    series_block_t * const *front_m;
+};
+
+#endif // SAMPLEBLOCKSERIES_H
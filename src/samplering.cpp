@@ -0,0 +1,201 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file samplering.cpp
+ * @brief Definition of SampleRing class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "samplering.h"
+
+/****************************************************************************
+ *
+ * constructor
+ *
+ ****************************************************************************/
+SampleRing::SampleRing() :
+    storage_m(NULL),
+    owner_m(false),
+    capacity_m(0),
+    head_m(0),
+    size_m(0),
+    total_m(0)
+{
+}
+
+/****************************************************************************
+ *
+ * destructor
+ *
+ ****************************************************************************/
+SampleRing::~SampleRing()
+{
+    if(owner_m)
+    {
+        free(storage_m);
+    }
+}
+
+/****************************************************************************
+ * attach - use external storage
+ ****************************************************************************/
+void SampleRing::attach(short *storage, uint32_t capacity)
+{
+    if(owner_m)
+    {
+        free(storage_m);
+    }
+    owner_m = false;
+    storage_m = storage;
+    capacity_m = (NULL != storage) ? capacity : 0;
+    clear();
+}
+
+/****************************************************************************
+ * allocate - own storage, grow only
+ ****************************************************************************/
+int8_t SampleRing::allocate(uint32_t capacity)
+{
+    short *storage = NULL;
+
+    if(owner_m && (capacity <= capacity_m))
+    {
+        clear();
+        return 0;
+    }
+
+    storage = (short*)malloc(capacity * sizeof(short));
+    if(NULL == storage)
+    {
+        ERROR("cannot allocate %u samples\n", capacity);
+        return -1;
+    }
+    if(owner_m)
+    {
+        free(storage_m);
+    }
+    owner_m = true;
+    storage_m = storage;
+    capacity_m = capacity;
+    clear();
+    return 0;
+}
+
+/****************************************************************************
+ * clear - empty the ring
+ ****************************************************************************/
+void SampleRing::clear(void)
+{
+    head_m = 0;
+    size_m = 0;
+    total_m = 0;
+}
+
+/****************************************************************************
+ * append - at most two copies, whatever the ring capacity
+ ****************************************************************************/
+void SampleRing::append(const short *samples, uint32_t nb_samples)
+{
+    uint32_t first = 0;
+
+    if((0 == capacity_m) || (NULL == samples))
+    {
+        return;
+    }
+
+    total_m += nb_samples;
+    /* only the last capacity_m samples can survive */
+    if(nb_samples > capacity_m)
+    {
+        samples += nb_samples - capacity_m;
+        nb_samples = capacity_m;
+    }
+
+    first = capacity_m - head_m;
+    if(first > nb_samples)
+    {
+        first = nb_samples;
+    }
+    memcpy(storage_m + head_m, samples, first * sizeof(short));
+    memcpy(storage_m, samples + first, (nb_samples - first) * sizeof(short));
+
+    head_m = (head_m + nb_samples) % capacity_m;
+    size_m = (size_m + nb_samples > capacity_m) ? capacity_m : size_m + nb_samples;
+}
+
+/****************************************************************************
+ * copy_last - most recent samples, oldest first
+ ****************************************************************************/
+uint32_t SampleRing::copy_last(short *out, uint32_t nb_samples) const
+{
+    uint32_t start = 0;
+    uint32_t first = 0;
+
+    if((NULL == out) || (0 == size_m))
+    {
+        return 0;
+    }
+    if(nb_samples > size_m)
+    {
+        nb_samples = size_m;
+    }
+
+    start = (head_m + capacity_m - nb_samples) % capacity_m;
+    first = capacity_m - start;
+    if(first > nb_samples)
+    {
+        first = nb_samples;
+    }
+    memcpy(out, storage_m + start, first * sizeof(short));
+    memcpy(out + first, storage_m, (nb_samples - first) * sizeof(short));
+    return nb_samples;
+}
+
+/****************************************************************************
+ * copy - samples from an index, oldest first
+ ****************************************************************************/
+uint32_t SampleRing::copy(uint32_t index, short *out, uint32_t nb_samples) const
+{
+    uint32_t start = 0;
+    uint32_t first = 0;
+
+    if((NULL == out) || (index >= size_m))
+    {
+        return 0;
+    }
+    if(nb_samples > size_m - index)
+    {
+        nb_samples = size_m - index;
+    }
+
+    start = (tail() + index) % capacity_m;
+    first = capacity_m - start;
+    if(first > nb_samples)
+    {
+        first = nb_samples;
+    }
+    memcpy(out, storage_m + start, first * sizeof(short));
+    memcpy(out + first, storage_m, (nb_samples - first) * sizeof(short));
+    return nb_samples;
+}
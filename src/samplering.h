@@ -0,0 +1,115 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file samplering.h
+ * @brief Declaration of SampleRing class.
+ * SampleRing is a circular buffer of raw ADC samples.
+ * Appending costs the number of new samples, whatever the ring capacity.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include "oscilloscope.h"
+
+class SampleRing
+{
+public:
+    /**
+     * @brief constructor, ring is empty until attach() or allocate() is called
+     */
+    SampleRing();
+    /**
+     * @brief destructor, frees storage given by allocate()
+     */
+    ~SampleRing();
+    /**
+     * @brief use external storage (i.e. BufferPool buffers) for the ring
+     * @param[in] storage : table of capacity elements, not freed by the ring
+     * @param[in] capacity : number of samples the ring can hold
+     */
+    void attach(short *storage, uint32_t capacity);
+    /**
+     * @brief make the ring own its storage, only reallocated when growing
+     * @param[in] capacity : number of samples the ring can hold
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t allocate(uint32_t capacity);
+    /**
+     * @brief forget all samples, storage is kept
+     */
+    void clear(void);
+    /**
+     * @brief append samples, oldest ones are overwritten when the ring is full
+     * @param[in] samples : table of nb_samples raw ADC counts
+     * @param[in] nb_samples : number of samples to append
+     */
+    void append(const short *samples, uint32_t nb_samples);
+    /**
+     * @brief copy the most recent samples, oldest first
+     * @param[out] out : table of at least nb_samples elements
+     * @param[in] nb_samples : number of samples wanted
+     * return : number of samples copied (less than asked if the ring holds less)
+     */
+    uint32_t copy_last(short *out, uint32_t nb_samples) const;
+    /**
+     * @brief copy samples from an index, 0 being the oldest sample still in the ring
+     * @param[in] index : index of the first sample
+     * @param[out] out : table of at least nb_samples elements
+     * @param[in] nb_samples : number of samples wanted
+     * return : number of samples copied (less than asked if the ring holds less)
+     */
+    uint32_t copy(uint32_t index, short *out, uint32_t nb_samples) const;
+    /**
+     * @brief get a sample, 0 being the oldest sample still in the ring
+     */
+    short at(uint32_t index) const { return storage_m[(tail() + index) % capacity_m]; }
+    /**
+     * @brief get number of samples currently held
+     */
+    uint32_t size(void) const { return size_m; }
+    /**
+     * @brief get number of samples the ring can hold
+     */
+    uint32_t capacity(void) const { return capacity_m; }
+    /**
+     * @brief get number of samples appended since last clear(), including overwritten ones
+     */
+    uint64_t total(void) const { return total_m; }
+
+private:
+    /* not copyable */
+    SampleRing(const SampleRing&);
+    SampleRing& operator=(const SampleRing&);
+
+    uint32_t tail(void) const { return (head_m + capacity_m - size_m) % capacity_m; }
+
+    short *storage_m;
+    bool owner_m;
+    uint32_t capacity_m;
+    /** @brief index where next sample is written */
+    uint32_t head_m;
+    uint32_t size_m;
+    uint64_t total_m;
+};
+
+#endif // SAMPLERING_H
@@ -29,6 +29,7 @@
 #include <QDateTime>
 #include <QMouseEvent>
 #include <QPaintEvent>
+#include <QWheelEvent>
 #include <QPainter>
 #include <QTimer>
 
@@ -38,9 +39,13 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "screen.h"
 
+/* raster colors, same as the curves */
+static const QRgb colors[FRAME_CHANNELS] = { qRgb(0, 255, 0), qRgb(255, 0, 0), qRgb(255, 0, 255), qRgb(255, 255, 0), qRgb(255, 255, 255) };
+
 Screen::Screen(QWidget *parent)
     : QwtPlot(parent)
 {
@@ -89,12 +94,90 @@ Screen::Screen(QWidget *parent)
     curveD.setRenderHint(QwtPlotItem::RenderAntialiased, true);
     curveD.setPaintAttribute(QwtPlotCurve::ClipPolygons, false);
     curveD.attach(this);
+    curveMath.setStyle(QwtPlotCurve::Lines);
+    curveMath.setPen(QPen(Qt::white));
+    curveMath.setRenderHint(QwtPlotItem::RenderAntialiased, true);
+    curveMath.setPaintAttribute(QwtPlotCurve::ClipPolygons, false);
+    curveMath.attach(this);
 
     pthread_mutex_init(&needToRepaitLock, NULL);
 
+    memset(blocks, 0, sizeof(blocks));
+    for(int ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        frontBlock[ch] = &blocks[ch];
+        blockAttached[ch] = false;
+        blockRuns[ch] = 0;
+        setRun[ch] = 0;
+        setCount[ch] = 0;
+    }
+    for(int slot = 0; slot < TRIPLE_BUFFER_SLOTS; slot++)
+    {
+        memset(latestFrames[slot].blocks, 0, sizeof(latestFrames[slot].blocks));
+        memset(latestFrames[slot].runs, 0, sizeof(latestFrames[slot].runs));
+        latestFrames[slot].sequence = 0;
+        latestFrames[slot].channels = 0;
+        latestFrames[slot].has_digital = false;
+    }
+    notifyPending = 0;
+    frameSamples = 0;
+    // setFrame is called by the acquisition thread, frames are shown by the GUI thread
+    connect(this, SIGNAL(frameReady()), this, SLOT(takeFrame()), Qt::QueuedConnection);
+    currentFrameSequence = 0;
+    pthread_mutex_init(&blockLock, NULL);
+    frameHeld = false;
+
+    frontRaster = &raster;
+    rasterWidth = 0;
+    rasterHeight = 0;
+    rasterXMin = 0.0;
+    rasterXMax = 1.0;
+    rasterYMin = -5.0;
+    rasterYMax = 5.0;
+    viewXMin = 0.0;
+    viewXMax = 1.0;
+    panning = false;
+    panOrigin = 0;
+    panXMin = 0.0;
+    panXMax = 1.0;
+    rasterItem = new RasterItem(&frontRaster);
+    rasterItem->setZ(curveA.z());
+    rasterItem->attach(this);
+
+    frontDigital = &digital;
+    logicItem = new LogicItem(&frontDigital);
+    logicItem->setZ(curveA.z());
+    logicItem->attach(this);
+
+    frontEvents = &events[0];
+    currentEventsSequence = 0;
+    eventItem = new EventItem(&frontEvents);
+    eventItem->setZ(curveA.z());
+    eventItem->attach(this);
+
     replot();
 }
 
+Screen::~Screen()
+{
+    for(int ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        series_block_free(&blocks[ch]);
+        for(int slot = 0; slot < TRIPLE_BUFFER_SLOTS; slot++)
+        {
+            series_block_free(&latestFrames[slot].blocks[ch]);
+        }
+    }
+    rasterItem->detach();
+    delete rasterItem;
+    logicItem->detach();
+    delete logicItem;
+    eventItem->detach();
+    delete eventItem;
+    pthread_mutex_destroy(&blockLock);
+    pthread_mutex_destroy(&needToRepaitLock);
+}
+
 void Screen::initGradient()
 {
     QPalette pal = canvas()->palette();
@@ -119,6 +202,8 @@ void Screen::setVoltCaliber(double voltCaliber)
     //update(cannonRect());
     //emit voltCaliberChanged(currentVoltCaliber);
     setAxisScale(QwtPlot::yLeft,-(5*currentVoltCaliber),(5*currentVoltCaliber), currentVoltCaliber);
+    rasterYMin = -(5*currentVoltCaliber);
+    rasterYMax = 5*currentVoltCaliber;
     // update all:
     update();
 }
@@ -131,9 +216,8 @@ void Screen::setTimeCaliber(double timeCaliber)
     if (currentTimeCaliber == timeCaliber)
         return;
     currentTimeCaliber = timeCaliber;
-    setAxisScale(QwtPlot::xBottom, 0.0, 5*currentTimeCaliber, currentTimeCaliber);
-    // update all:
-    update();
+    // a new time base shows the full screen
+    setView(0.0, 5*currentTimeCaliber);
     //emit timeCaliberChanged(currentTimeCaliber);
 }
 
@@ -158,42 +242,123 @@ void Screen::setTrigger(trigger_e trigger)
 }
 
 
-//! [2]
 void Screen::mousePressEvent(QMouseEvent *event)
 {
-    (void)event; //avoid warning for now
-//    if (event->button() != Qt::LeftButton)
-//        return;
-//    if (barrelHit(event->pos()))
-//        barrelPressed = true;
+    if (event->button() != Qt::LeftButton)
+    {
+        event->ignore();
+        return;
+    }
+    panning = true;
+    panOrigin = event->pos().x();
+    panXMin = viewXMin;
+    panXMax = viewXMax;
+    event->accept();
 }
-//! [2]
 
-//! [3]
 void Screen::mouseMoveEvent(QMouseEvent *event)
 {
-      (void)event; //avoid warning for now
-//    if (!barrelPressed)
-//        return;
-//    QPoint pos = event->pos();
-//    if (pos.x() <= 0)
-//        pos.setX(1);
-//    if (pos.y() >= height())
-//        pos.setY(height() - 1);
-//    double rad = atan(((double)rect().bottom() - pos.y()) / pos.x());
-//    setAngle(qRound(rad * 180 / 3.14159265));
-//! [3] //! [4]
+    double shift = 0.;
+
+    if (!panning || (canvas()->width() <= 0))
+    {
+        event->ignore();
+        return;
+    }
+    // the trace follows the mouse
+    shift = (event->pos().x() - panOrigin) * (panXMax - panXMin) / canvas()->width();
+    if (panXMin - shift < 0.0)
+        shift = panXMin;
+    if (panXMax - shift > 5*currentTimeCaliber)
+        shift = panXMax - 5*currentTimeCaliber;
+    setView(panXMin - shift, panXMax - shift);
+    event->accept();
 }
-//! [4]
 
-//! [5]
 void Screen::mouseReleaseEvent(QMouseEvent *event)
 {
-    (void)event;
-//    if (event->button() == Qt::LeftButton)
-//        barrelPressed = false;
+    if (event->button() == Qt::LeftButton)
+        panning = false;
+    event->accept();
+}
+
+void Screen::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    // back to the full screen
+    setView(0.0, 5*currentTimeCaliber);
+    event->accept();
+}
+
+void Screen::wheelEvent(QWheelEvent *event)
+{
+    double factor = (event->delta() > 0) ? ZOOM_STEP : 1.0 / ZOOM_STEP;
+    double at = invTransform(QwtPlot::xBottom, event->pos().x() - canvas()->x());
+
+    // the time under the mouse stays under the mouse
+    if (at < viewXMin)
+        at = viewXMin;
+    if (at > viewXMax)
+        at = viewXMax;
+    setView(at - (at - viewXMin) * factor, at + (viewXMax - at) * factor);
+    event->accept();
+}
+
+void Screen::setView(double xMin, double xMax)
+{
+    const double full = 5*currentTimeCaliber;
+    double span = xMax - xMin;
+    uint8_t ch = 0;
+
+    if (full <= 0.0)
+        return;
+    if (span > full)
+        span = full;
+    if (span < full / ZOOM_MAX)
+        span = full / ZOOM_MAX;
+    if (xMin < 0.0)
+        xMin = 0.0;
+    if (xMin + span > full)
+        xMin = full - span;
+    xMax = xMin + span;
+    viewXMin = xMin;
+    viewXMax = xMax;
+    setAxisScale(QwtPlot::xBottom, viewXMin, viewXMax, span / 5);
+
+    // the displayed blocks are rastered again here, from their min/max levels
+    rasterXMin = viewXMin;
+    rasterXMax = viewXMax;
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        setVisible(frontBlock[ch], rasterWidth, rasterXMin, rasterXMax);
+    }
+    drawBlocks(0);
+
+    pthread_mutex_lock(&needToRepaitLock);
+    needToRepait = true;
+    pthread_mutex_unlock(&needToRepaitLock);
+    // update all:
+    update();
+}
+
+void Screen::setVisible(series_block_t *block, int width, double xMin, double xMax)
+{
+    double first = 0.;
+    double last = 0.;
+
+    block->view_first = 0;
+    block->view_count = block->block.count;
+    if((NULL == block->block.times) && (block->block.dt > 0.))
+    {
+        // one sample on each side keeps the curve running to the edges
+        first = floor((xMin - block->block.t0) / block->block.dt) - 1;
+        last = ceil((xMax - block->block.t0) / block->block.dt) + 2;
+        first = (first < 0.) ? 0. : ((first > block->block.count) ? block->block.count : first);
+        last = (last < first) ? first : ((last > block->block.count) ? block->block.count : last);
+        block->view_first = (uint32_t)first;
+        block->view_count = (uint32_t)(last - first);
+    }
+    block->rastered = (width > 0) && (block->view_count > (uint32_t)(RASTER_DENSITY_THRESHOLD * width));
 }
-//! [5]
 
 void Screen::paintEvent(QPaintEvent *event)
 {
@@ -238,7 +403,12 @@ void Screen::paintEvent(QPaintEvent *event)
     // TODO calling replot here is freezing the mainwindow.... But not calling it will never show the curves...
     if(needToRepaint_l)
     {
+        rasterWidth = canvas()->width();
+        rasterHeight = canvas()->height();
+        // events are read in place while replotting
+        pthread_mutex_lock(&blockLock);
         replot();
+        pthread_mutex_unlock(&blockLock);
     }
     event->accept();
 }
@@ -331,55 +501,289 @@ void Screen::paintEvent(QPaintEvent *event)
 //}
  
 
-int8_t Screen::setData(uint8_t channel_id, double *x_data, double *y_data, uint32_t nb_points)
+QwtPlotCurve *Screen::channelCurve(uint8_t channel_id)
 {
-
-    QwtPlotCurve *curve = NULL;
     // select channel_id
     switch(channel_id)
     {
         case 1:
-            curve = &curveA;
-        break;
+            return &curveA;
         case 2:
-            curve = &curveB;
-        break;
+            return &curveB;
         case 3:
-            curve = &curveC;
-        break;
+            return &curveC;
         case 4:
-            curve = &curveD;
-        break;
+            return &curveD;
+        case (MATH_CHANNEL + 1):
+            return &curveMath;
         default:
             ERROR("invalid channel id : %d\n", channel_id);
+            return NULL;
+    }
+}
+
+int8_t Screen::setBlock(uint8_t channel_id, const sample_block_t *block)
+{
+    sample_frame_t frame;
+
+    if((channel_id < 1) || (channel_id > FRAME_CHANNELS) || (NULL == block))
+    {
+        ERROR("invalid channel id : %d\n", channel_id);
+        return -1;
+    }
+    frame.sequence = currentFrameSequence;
+    frame.triggered = 0;
+    frame.trigger_time = 0.;
+    frame.channels = (1 << (channel_id - 1));
+    frame.digital = NULL;
+    frame.blocks[channel_id - 1] = *block;
+    return setFrame(&frame);
+}
+
+int8_t Screen::setFrame(const sample_frame_t *frame)
+{
+    latest_frame_t *slot = &latestFrames[latest.write_slot()];
+    const sample_block_t *block = NULL;
+    uint8_t ch = 0;
+
+    if(NULL == frame)
+    {
+        return -1;
+    }
+    // the write slot is never read by the GUI thread
+    slot->channels = 0;
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        if(frame->channels & (1 << ch))
+        {
+            block = &frame->blocks[ch];
+            // storage of a slot grows once to the announced size
+            if((0 != series_block_reserve(&slot->blocks[ch], frameSamples)) ||
+               (0 != slot->pyramids[ch].reserve(frameSamples)))
+            {
+                WARNING("frame storage grows with the captures\n");
+            }
+            // a block appending to the previous one of its channel continues its run
+            if((0 == block->stable) || (block->stable != setCount[ch]) || (NULL != block->times))
+            {
+                setRun[ch]++;
+            }
+            setCount[ch] = block->count;
+            if(slot->runs[ch] == setRun[ch])
+            {
+                // the slot holds an earlier block of the run: only appended samples are copied
+                // and the levels grow with them
+                if(0 != series_block_extend(&slot->blocks[ch], block))
+                {
+                    return -1;
+                }
+                if(0 != slot->pyramids[ch].append(slot->blocks[ch].block.raw, slot->blocks[ch].block.count))
+                {
+                    slot->pyramids[ch].reset();
+                }
+            }
+            else
+            {
+                if(0 != series_block_copy(&slot->blocks[ch], block))
+                {
+                    slot->runs[ch] = 0;
+                    return -1;
+                }
+                // levels are built here, off the GUI thread, zoom and pan then cost a few steps per column
+                if((NULL != slot->blocks[ch].block.times) || (0 != slot->pyramids[ch].build(slot->blocks[ch].block.raw, slot->blocks[ch].block.count)))
+                {
+                    slot->pyramids[ch].reset();
+                }
+            }
+            slot->runs[ch] = setRun[ch];
+            slot->channels |= (1 << ch);
+        }
+    }
+    slot->has_digital = false;
+    if(NULL != frame->digital)
+    {
+        if(0 != slot->digital.copy(*frame->digital))
+        {
             return -1;
+        }
+        slot->has_digital = true;
+    }
+    slot->sequence = frame->sequence;
+    // a frame the GUI thread did not take yet is dropped
+    latest.publish();
+    notify();
+    return 0;
+}
+
+void Screen::reserveFrame(uint32_t nb_samples)
+{
+    frameSamples = nb_samples;
+}
 
+void Screen::takeFrame()
+{
+    latest_frame_t *slot = NULL;
+    series_block_t shown;
+    uint32_t run = 0;
+    uint8_t ch = 0;
+
+    // data set from now on notifies again
+    __atomic_exchange_n(&notifyPending, 0, __ATOMIC_ACQ_REL);
+    // a kept frame is on screen: the live one is dropped
+    if(latest.acquire() && !frameHeld)
+    {
+        slot = &latestFrames[latest.read_slot()];
+        // displayed blocks go back in the slot, the acquisition thread reuses their storage
+        for(ch = 0; ch < FRAME_CHANNELS; ch++)
+        {
+            if(slot->channels & (1 << ch))
+            {
+                shown = blocks[ch];
+                blocks[ch] = slot->blocks[ch];
+                slot->blocks[ch] = shown;
+                pyramids[ch].swap(slot->pyramids[ch]);
+                run = blockRuns[ch];
+                blockRuns[ch] = slot->runs[ch];
+                slot->runs[ch] = run;
+            }
+        }
+        if(slot->has_digital && (0 != digital.copy(slot->digital)))
+        {
+            ERROR("cannot copy logic lines of frame %u\n", slot->sequence);
+        }
+        currentFrameSequence = slot->sequence;
+        // all channels of the frame become visible at once
+        drawBlocks(slot->channels);
     }
-    
-    if( nb_points <= INT_MAX )
+    // one repaint per notification
+    pthread_mutex_lock(&needToRepaitLock);
+    needToRepait = true;
+    pthread_mutex_unlock(&needToRepaitLock);
+    update();
+}
+
+void Screen::notify()
+{
+    // one queued notification at a time, takeFrame shows whatever is newest then
+    if(0 == __atomic_exchange_n(&notifyPending, 1, __ATOMIC_ACQ_REL))
     {
-#if ( QWT_VERSION >= 0x060000)
-        curve->setSamples( x_data, y_data, (int)nb_points);
-#else
-        curve->setData( x_data, y_data, (int)nb_points);
-#endif
-        
+        emit frameReady();
+    }
+}
+
+int8_t Screen::showFrame(const sample_frame_t *frame)
+{
+    uint8_t ch = 0;
+
+    if(NULL == frame)
+    {
+        return -1;
     }
-    else
+    frameHeld = true;
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
     {
-        // crazy to get such an amount of data at once...
+        if(frame->channels & (1 << ch))
+        {
+            // the block leaves its run, it must not be extended once back in a slot
+            blockRuns[ch] = 0;
+            if(0 != series_block_copy(&blocks[ch], &frame->blocks[ch]))
+            {
+                return -1;
+            }
+            if((NULL != blocks[ch].block.times) || (0 != pyramids[ch].build(blocks[ch].block.raw, blocks[ch].block.count)))
+            {
+                pyramids[ch].reset();
+            }
+        }
+    }
+    if((NULL != frame->digital) && (0 != digital.copy(*frame->digital)))
+    {
+        return -1;
+    }
+    currentFrameSequence = frame->sequence;
+    drawBlocks(frame->channels);
+    pthread_mutex_lock(&needToRepaitLock);
+    needToRepait = true;
+    pthread_mutex_unlock(&needToRepaitLock);
+    update();
+    return 0;
+}
+
+void Screen::showLive()
+{
+    frameHeld = false;
+}
+
+void Screen::drawBlocks(uint8_t channels)
+{
+    QwtPlotCurve *curve = NULL;
+    uint8_t ch = 0;
+
+    // dense traces are drawn as min/max column spans from the levels
+    frontRaster->clear();
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        if(channels & (1 << ch))
+        {
+            setVisible(frontBlock[ch], rasterWidth, rasterXMin, rasterXMax);
+        }
+        // channels missing from the frame keep their displayed block
+        if(frontBlock[ch]->rastered)
+        {
+            if(!frontRaster->active())
+            {
+                frontRaster->begin(rasterWidth, rasterHeight, rasterXMin, rasterXMax, rasterYMin, rasterYMax);
+            }
+            frontRaster->drawPyramid(&frontBlock[ch]->block, &pyramids[ch], colors[ch]);
+        }
+        curve = channelCurve(ch + 1);
+        if((channels & (1 << ch)) && !blockAttached[ch])
+        {
+            // curve takes ownership of the adapter
 #if ( QWT_VERSION >= 0x060000)
-        curve->setSamples( x_data, y_data, INT_MAX);
-        curve->setSamples( x_data + INT_MAX, y_data + INT_MAX, (int)(nb_points-INT_MAX));
+            curve->setData(new SampleBlockSeries(&frontBlock[ch]));
 #else
-        curve->setData( x_data, y_data, INT_MAX);
-        curve->setData( x_data + INT_MAX, y_data + INT_MAX, (int)(nb_points-INT_MAX));
+            curve->setData(SampleBlockSeries(&frontBlock[ch]));
 #endif
+            blockAttached[ch] = true;
+        }
+    }
+}
+
+int8_t Screen::setEvents(const decoder_event_t *newEvents, uint32_t nb_events)
+{
+    std::vector<decoder_event_t> *back = (frontEvents == &events[0]) ? &events[1] : &events[0];
+
+    if((NULL == newEvents) && (nb_events > 0))
+    {
+        return -1;
     }
+    // back table is never read by the GUI thread
+    back->clear();
+    if(nb_events > 0)
+    {
+        back->assign(newEvents, newEvents + nb_events);
+    }
+    pthread_mutex_lock(&blockLock);
+    frontEvents = back;
+    currentEventsSequence++;
+    pthread_mutex_unlock(&blockLock);
+
     pthread_mutex_lock(&needToRepaitLock);
     needToRepait = true;
     pthread_mutex_unlock(&needToRepaitLock);
-    update();
+    // called by the acquisition thread: the GUI thread repaints
+    notify();
     return 0;
 }
 
+uint32_t Screen::copyEvents(std::vector<decoder_event_t> &copy)
+{
+    uint32_t sequence = 0;
+
+    pthread_mutex_lock(&blockLock);
+    copy = *frontEvents;
+    sequence = currentEventsSequence;
+    pthread_mutex_unlock(&blockLock);
+    return sequence;
+}
@@ -34,11 +34,39 @@
 
 #include "oscilloscope.h"
 #include "drawdata.h"
+#include "sampleblockseries.h"
+#include "rasterrenderer.h"
+#include "logicitem.h"
+#include "eventitem.h"
+#include "triplebuffer.h"
+
+/* above this number of samples per pixel column, traces are rastered */
+#define RASTER_DENSITY_THRESHOLD 4
+/* zoom step of a mouse wheel notch, and deepest zoom relative to the full screen */
+#define ZOOM_STEP 0.8
+#define ZOOM_MAX 1.0e6
 
 QT_BEGIN_NAMESPACE
 class QTimer;
 QT_END_NAMESPACE
 
+/**
+ * @brief a frame handed from the acquisition thread to the GUI thread,
+ * copied with its min/max levels built
+ */
+typedef struct
+{
+    uint32_t sequence;
+    /** @brief channels held by blocks */
+    uint8_t channels;
+    series_block_t blocks[FRAME_CHANNELS];
+    MinMaxPyramid pyramids[FRAME_CHANNELS];
+    /** @brief run of appended blocks each block belongs to */
+    uint32_t runs[FRAME_CHANNELS];
+    DigitalBlock digital;
+    bool has_digital;
+}latest_frame_t;
+
 class Screen : public QwtPlot, public DrawData
 {
     Q_OBJECT
@@ -49,6 +77,10 @@ public:
      * @param[in] parent widget pointer
      */
     Screen(QWidget *parent = 0);
+    /**
+     * @brief destructor
+     */
+    ~Screen();
     /**
      * @brief get voltage caliber
      * @return current voltage caliber over a double
@@ -73,14 +105,57 @@ public:
     //QSize sizeHint() const;
  
     /**
-     * @brief: set data to draw
+     * @brief: set a sample block to draw, raw counts with a uniform time base
      * @param[in] channel_id: when getting multiple channels, a.k.a multiple curves, id between curves must be different
-     * @param[in] x_data table of X-axis. Table has nb_points elements. Table will be copied.
-     * @param[in] y_data table of Y-axis. Table has nb_points elements. Table will be copied.
-     * @param[in] nb_points is the table size.
+     * @param[in] block: sample block. Counts are copied as by setFrame.
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t setBlock(uint8_t channel_id, const sample_block_t *block);
+    /**
+     * @brief: set all channels of one capture at once
+     * @param[in] frame: sample frame. Blocks are copied in the free slot of a triple buffer
+     *                   and the GUI thread is notified; it shows the newest frame only,
+     *                   so the caller never waits and frames in between are dropped.
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t setFrame(const sample_frame_t *frame);
+    /**
+     * @brief: announce the largest block of the coming frames, from the thread calling setFrame
+     * @param[in] nb_samples: number of samples per channel. Frame storage grows to it
+     *                        at once instead of with each capture of a filling screen.
+     */
+    void reserveFrame(uint32_t nb_samples);
+    /**
+     * @brief get sequence number of the displayed frame
+     */
+    uint32_t frameSequence() const { return currentFrameSequence; }
+    /**
+     * @brief get number of frames given to setFrame and never displayed
+     */
+    uint32_t droppedFrames() const { return latest.dropped(); }
+    /**
+     * @brief: show a kept frame, live frames are not drawn until showLive is called
+     * @param[in] frame: sample frame, copied as by setFrame
      * return : 0 if successful, -1 in case of error
      */
-    int8_t setData(uint8_t channel_id, double *x_data, double *y_data, uint32_t nb_points);
+    int8_t showFrame(const sample_frame_t *frame);
+    /**
+     * @brief: draw live frames again, from the next one
+     */
+    void showLive();
+    /**
+     * @brief: set decoded protocol events to annotate
+     * @param[in] events: events sorted by time. Events are copied in a back table, then swapped with the displayed one.
+     * @param[in] nb_events: number of events, 0 to remove annotations
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t setEvents(const decoder_event_t *events, uint32_t nb_events);
+    /**
+     * @brief copy the annotated events
+     * @param[out] events: copy of the displayed events
+     * return : events sequence number, increased by each call to setEvents
+     */
+    uint32_t copyEvents(std::vector<decoder_event_t> &events);
 
 public slots:
     /**
@@ -105,14 +180,20 @@ public slots:
     void setTrigger(trigger_e trigger);
 
 private slots:
+    /** @brief show the newest frame of the triple buffer */
+    void takeFrame();
 
 signals:
+    /** @brief queued to the GUI thread when new data is set */
+    void frameReady();
 
 protected:
     void paintEvent(QPaintEvent *event);
     void mousePressEvent(QMouseEvent *event);
     void mouseMoveEvent(QMouseEvent *event);
     void mouseReleaseEvent(QMouseEvent *event);
+    void mouseDoubleClickEvent(QMouseEvent *event);
+    void wheelEvent(QWheelEvent *event);
 
 private:
 
@@ -121,14 +202,84 @@ private:
     current_e currentCurrent;
     trigger_e currentTrigger;
     void initGradient();
+    QwtPlotCurve *channelCurve(uint8_t channel_id);
+    /** @brief wake the GUI thread up, once till it handles it */
+    void notify();
+    /** @brief raster and attach the displayed blocks of channels, after they changed */
+    void drawBlocks(uint8_t channels);
+    /**
+     * @brief select samples of a block visible between xMin and xMax, and
+     * whether they are dense enough to be rastered
+     */
+    void setVisible(series_block_t *block, int width, double xMin, double xMax);
+    /** @brief show the time window [xMin, xMax], clamped to the full screen */
+    void setView(double xMin, double xMax);
     /* TODO Could be improved (table, list...)*/
     QwtPlotCurve curveA;
     QwtPlotCurve curveB;
     QwtPlotCurve curveC;
     QwtPlotCurve curveD;
+    QwtPlotCurve curveMath;
 
     bool needToRepait;
     pthread_mutex_t needToRepaitLock;
+
+    /* frames from setFrame: the acquisition thread fills one slot, the GUI thread takes the newest */
+    latest_frame_t latestFrames[TRIPLE_BUFFER_SLOTS];
+    TripleBuffer latest;
+    int notifyPending;
+    /* acquisition thread: run of the last block set per channel, and its length.
+     * Blocks of one run only append samples, a slot of the same run is extended */
+    uint32_t setRun[FRAME_CHANNELS];
+    uint32_t setCount[FRAME_CHANNELS];
+    /* acquisition thread: largest block announced by reserveFrame */
+    uint32_t frameSamples;
+
+    /* displayed sample blocks, owned by the GUI thread: slot blocks are swapped with them */
+    series_block_t blocks[FRAME_CHANNELS];
+    series_block_t *frontBlock[FRAME_CHANNELS];
+    /* min/max levels of each block, zoom and pan raster from them */
+    MinMaxPyramid pyramids[FRAME_CHANNELS];
+    /* run of each displayed block, 0 when it is not from setFrame */
+    uint32_t blockRuns[FRAME_CHANNELS];
+    /* curves showing their block series, GUI thread only */
+    bool blockAttached[FRAME_CHANNELS];
+    uint32_t currentFrameSequence;
+    /* events are swapped by the acquisition thread while the GUI thread replots */
+    pthread_mutex_t blockLock;
+    /* live frames are dropped while a kept one is shown */
+    bool frameHeld;
+
+    /* raster fast path, rendered from the levels by the GUI thread */
+    RasterRenderer raster;
+    RasterRenderer *frontRaster;
+    RasterItem *rasterItem;
+    /* canvas geometry, updated by the GUI thread */
+    int rasterWidth;
+    int rasterHeight;
+    double rasterXMin;
+    double rasterXMax;
+    double rasterYMin;
+    double rasterYMax;
+
+    /* zoom: visible time window, dragged with the left button */
+    double viewXMin;
+    double viewXMax;
+    bool panning;
+    int panOrigin;
+    double panXMin;
+    double panXMax;
+
+    /* logic lines of mixed signal captures */
+    DigitalBlock digital;
+    DigitalBlock *frontDigital;
+    LogicItem *logicItem;
+
+    /* decoded events: front is annotated, back is filled by setEvents */
+    std::vector<decoder_event_t> events[2];
+    std::vector<decoder_event_t> *frontEvents;
+    uint32_t currentEventsSequence;
+    EventItem *eventItem;
     
 };
 
@@ -65,37 +65,12 @@ void SearchForAcquisitionDeviceWorker::searchForAcquisitionDevice(void)
     parent_m->acquisition_m = device;
     parent_m->acquisition_m->setDrawData(parent_m->screen_m);
     parent_m->acquisition_m->get_device_info(&device_info);
+    pthread_mutex_unlock(&parent_m->acquisitionLock_m);
     // show the detected device name in status bar
     emit newStatusBarMessage(tr(device_info.device_name));
     //((QMainWindow*)(parent_m->parent_m))->statusBar()->showMessage(tr(device_info.device_name), 30000);
-    if(device_info.nb_channels >= 1)
-    {
-
-        parent_m->acquisition_m->set_voltages(Acquisition::CHANNEL_A, (parent_m->volt_items_m->back()).value);
-        parent_m->volt_channel_A_m->setCurrentIndex(parent_m->volt_items_m->size() - 1);
-        // set screen values
-        parent_m->screen_m->setVoltCaliber((parent_m->volt_items_m->back()).value);
-        
-    }
-    else
-    {
-        // stupid if a device has no channel...
-        ERROR("This device has no channel\n");
-        parent_m->volt_channel_A_m->setVisible(false);
-    }
-
-    if(device_info.nb_channels >= 2)
-    {
-        parent_m->acquisition_m->set_voltages(Acquisition::CHANNEL_B, (parent_m->volt_items_m->back()).value);
-        parent_m->volt_channel_B_m->setCurrentIndex(parent_m->volt_items_m->size() - 1);
-    }
-    else
-    {
-        parent_m->volt_channel_B_m->setVisible(false);
-    }
-    parent_m->acquisition_m->set_timebase((parent_m->time_items_m->at(0)).value);
-    parent_m->acquisition_m->start();
-    pthread_mutex_unlock(&parent_m->acquisitionLock_m);
+    // widgets belong to the GUI thread: it restores the session and starts the acquisition
+    emit deviceFound();
 }
 
 void SearchForAcquisitionDeviceWorker::stopSearchForAcquisitionDevice(void)
@@ -52,6 +52,8 @@ class SearchForAcquisitionDeviceWorker : public QObject
     FrontPanel* parent_m;
  signals:
     void newStatusBarMessage(QString text);
+    /** @brief the device is opened, the front panel configures and starts it */
+    void deviceFound(void);
 };
 
 #endif
@@ -0,0 +1,422 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file signalanalyzer.cpp
+ * @brief Definition of SignalAnalyzer class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "signalanalyzer.h"
+
+/* amplitude bin of a raw ADC count */
+#define ANALYSIS_BIN(sample, shift) ((uint32_t)((int32_t)(sample) + 32768) >> (shift))
+
+/****************************************************************************
+ * count_sample - increase a bin, saturating
+ ****************************************************************************/
+static inline void count_sample(uint32_t *bin)
+{
+    if(0xFFFFFFFFu != *bin)
+    {
+        (*bin)++;
+    }
+}
+
+/****************************************************************************
+ * SignalAnalyzer
+ ****************************************************************************/
+SignalAnalyzer::SignalAnalyzer() :
+    bins_m(0),
+    histograms_m(NULL),
+    eye_m(NULL),
+    folded_m(0),
+    dt_m(0.),
+    period_m(0.),
+    locked_m(false),
+    clock_m(0.),
+    crossing_m(0.),
+    high_m(false),
+    has_previous_m(false),
+    previous_m(0)
+{
+    spec_m.mode = E_ANALYSIS_NONE;
+    spec_m.channel = 0;
+    spec_m.shift = 8;
+    spec_m.symbol_period = 0.;
+    spec_m.columns = 256;
+    memset(samples_m, 0, sizeof(samples_m));
+    memset(scale_m, 0, sizeof(scale_m));
+    memset(min_m, 0, sizeof(min_m));
+    memset(max_m, 0, sizeof(max_m));
+}
+
+/****************************************************************************
+ * ~SignalAnalyzer
+ ****************************************************************************/
+SignalAnalyzer::~SignalAnalyzer()
+{
+    release();
+}
+
+/****************************************************************************
+ * release
+ ****************************************************************************/
+void SignalAnalyzer::release()
+{
+    free(histograms_m);
+    free(eye_m);
+    histograms_m = NULL;
+    eye_m = NULL;
+    bins_m = 0;
+}
+
+/****************************************************************************
+ * configure
+ ****************************************************************************/
+int8_t SignalAnalyzer::configure(const analysis_spec_t &spec)
+{
+    uint32_t bins = 0;
+
+    spec_m = spec;
+    if(spec_m.shift < ANALYSIS_SHIFT_MIN)
+    {
+        spec_m.shift = ANALYSIS_SHIFT_MIN;
+    }
+    if(spec_m.shift > ANALYSIS_SHIFT_MAX)
+    {
+        spec_m.shift = ANALYSIS_SHIFT_MAX;
+    }
+    if(spec_m.columns < EYE_SYMBOLS)
+    {
+        spec_m.columns = EYE_SYMBOLS;
+    }
+    if(spec_m.channel >= MAX_CHANNELS)
+    {
+        spec_m.channel = 0;
+    }
+    release();
+    if(enabled())
+    {
+        bins = 65536 >> spec_m.shift;
+        histograms_m = (uint32_t *)calloc(MAX_CHANNELS * bins, sizeof(uint32_t));
+        if(E_ANALYSIS_EYE == spec_m.mode)
+        {
+            eye_m = (uint32_t *)calloc(bins * spec_m.columns, sizeof(uint32_t));
+        }
+        if((NULL == histograms_m) || ((E_ANALYSIS_EYE == spec_m.mode) && (NULL == eye_m)))
+        {
+            ERROR("unable to allocate %u amplitude bins\n", bins);
+            release();
+            spec_m.mode = E_ANALYSIS_NONE;
+            return -1;
+        }
+        bins_m = bins;
+    }
+    reset();
+    return 0;
+}
+
+/****************************************************************************
+ * reserve
+ ****************************************************************************/
+void SignalAnalyzer::reserve(uint32_t nb_samples)
+{
+    // crossings alternate between the low and high levels, at most one per sample
+    crossings_m.reserve(nb_samples);
+}
+
+/****************************************************************************
+ * reset
+ ****************************************************************************/
+void SignalAnalyzer::reset()
+{
+    uint8_t ch = 0;
+
+    for(ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        clear_channel(ch);
+    }
+    clear_eye();
+}
+
+/****************************************************************************
+ * clear_channel
+ ****************************************************************************/
+void SignalAnalyzer::clear_channel(uint8_t channel)
+{
+    if(NULL != histograms_m)
+    {
+        memset(histograms_m + channel * bins_m, 0, bins_m * sizeof(uint32_t));
+    }
+    samples_m[channel] = 0;
+    scale_m[channel] = 0.;
+    min_m[channel] = SHRT_MAX;
+    max_m[channel] = SHRT_MIN;
+}
+
+/****************************************************************************
+ * clear_eye
+ ****************************************************************************/
+void SignalAnalyzer::clear_eye()
+{
+    if(NULL != eye_m)
+    {
+        memset(eye_m, 0, bins_m * spec_m.columns * sizeof(uint32_t));
+    }
+    folded_m = 0;
+    dt_m = 0.;
+    period_m = 0.;
+    locked_m = false;
+    has_previous_m = false;
+}
+
+/****************************************************************************
+ * accumulate
+ ****************************************************************************/
+void SignalAnalyzer::accumulate(uint8_t channel, const short *samples, uint32_t count, double scale, double dt, bool continuous)
+{
+    uint32_t *histogram = NULL;
+    uint32_t i = 0;
+    short min = 0;
+    short max = 0;
+
+    if(!enabled() || (channel >= MAX_CHANNELS) || (NULL == samples) || (0 == count))
+    {
+        return;
+    }
+    // counts of another range do not add up
+    if(scale != scale_m[channel])
+    {
+        clear_channel(channel);
+        if(channel == spec_m.channel)
+        {
+            clear_eye();
+        }
+        scale_m[channel] = scale;
+    }
+    histogram = histograms_m + channel * bins_m;
+    min = min_m[channel];
+    max = max_m[channel];
+    for(i = 0; i < count; i++)
+    {
+        count_sample(&histogram[ANALYSIS_BIN(samples[i], spec_m.shift)]);
+        if(samples[i] < min)
+            min = samples[i];
+        if(samples[i] > max)
+            max = samples[i];
+    }
+    min_m[channel] = min;
+    max_m[channel] = max;
+    samples_m[channel] += count;
+
+    if((E_ANALYSIS_EYE == spec_m.mode) && (channel == spec_m.channel) && (dt > 0.))
+    {
+        fold(samples, count, dt, continuous);
+    }
+}
+
+/****************************************************************************
+ * recover_period
+ ****************************************************************************/
+double SignalAnalyzer::recover_period(const short *samples, uint32_t count, short low, short high)
+{
+    double mid = 0.5 * ((double)low + (double)high);
+    double straddle = 0.;
+    double interval = 0.;
+    double shortest = 0.;
+    double symbols = 0.;
+    bool above = false;
+    uint32_t i = 0;
+
+    crossings_m.clear();
+    if(count < 2)
+    {
+        return 0.;
+    }
+    above = (samples[0] > mid);
+    for(i = 1; i < count; i++)
+    {
+        if((samples[i - 1] < mid) != (samples[i] < mid))
+        {
+            straddle = (i - 1) + (mid - samples[i - 1]) / (double)(samples[i] - samples[i - 1]);
+        }
+        if((above && (samples[i] < low)) || (!above && (samples[i] > high)))
+        {
+            above = !above;
+            crossings_m.push_back(straddle);
+        }
+    }
+    if(crossings_m.size() < EYE_RECOVERY_CROSSINGS)
+    {
+        return 0.;
+    }
+    // the shortest interval is about one symbol, the others a whole number of them
+    for(i = 1; i < crossings_m.size(); i++)
+    {
+        interval = crossings_m[i] - crossings_m[i - 1];
+        if((1 == i) || (interval < shortest))
+        {
+            shortest = interval;
+        }
+    }
+    if(shortest < 1.)
+    {
+        return 0.;
+    }
+    for(i = 1; i < crossings_m.size(); i++)
+    {
+        symbols += floor((crossings_m[i] - crossings_m[i - 1]) / shortest + 0.5);
+    }
+    return (crossings_m.back() - crossings_m.front()) / symbols;
+}
+
+/****************************************************************************
+ * fold
+ ****************************************************************************/
+void SignalAnalyzer::fold(const short *samples, uint32_t count, double dt, bool continuous)
+{
+    const uint8_t ch = spec_m.channel;
+    double mid = 0.5 * ((double)min_m[ch] + (double)max_m[ch]);
+    double low = mid - (max_m[ch] - min_m[ch]) / 8.;
+    double high = mid + (max_m[ch] - min_m[ch]) / 8.;
+    double edge = 0.;
+    double phase = 0.;
+    uint32_t column = 0;
+    uint32_t i = 0;
+    short sample = 0;
+
+    // another time base: folded samples do not add up
+    if(dt != dt_m)
+    {
+        clear_eye();
+        dt_m = dt;
+    }
+    if(!continuous)
+    {
+        locked_m = false;
+        has_previous_m = false;
+    }
+    // no edge to follow on a flat signal
+    if((max_m[ch] - min_m[ch]) < (2 << spec_m.shift))
+    {
+        return;
+    }
+    if(period_m <= 0.)
+    {
+        period_m = (spec_m.symbol_period > 0.) ? spec_m.symbol_period / dt : recover_period(samples, count, (short)low, (short)high);
+        // a symbol must last a sample at least
+        if(period_m < 1.)
+        {
+            period_m = 0.;
+            return;
+        }
+        DEBUG("eye symbol period %g s\n", period_m * dt);
+    }
+    if(!has_previous_m)
+    {
+        previous_m = samples[0];
+        high_m = (samples[0] > mid);
+        crossing_m = 0.;
+        has_previous_m = true;
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        sample = samples[i];
+        // mid level crossing, kept till the hysteresis confirms it
+        if((previous_m < mid) != (sample < mid))
+        {
+            crossing_m = (i - 1.) + (mid - previous_m) / (double)(sample - previous_m);
+        }
+        if((high_m && (sample < low)) || (!high_m && (sample > high)))
+        {
+            high_m = !high_m;
+            if(!locked_m)
+            {
+                clock_m = crossing_m;
+                locked_m = true;
+            }
+            else
+            {
+                // nearest edge of the recovered clock moves toward the crossing
+                edge = clock_m + floor((crossing_m - clock_m) / period_m + 0.5) * period_m;
+                clock_m = edge + EYE_LOOP_GAIN * (crossing_m - edge);
+            }
+        }
+        if(locked_m)
+        {
+            // crossings half a symbol from the left, the eye opening in the middle
+            phase = (i - clock_m) / period_m + 0.5;
+            phase -= EYE_SYMBOLS * floor(phase / EYE_SYMBOLS);
+            column = (uint32_t)(phase * spec_m.columns / EYE_SYMBOLS);
+            if(column >= spec_m.columns)
+            {
+                column = spec_m.columns - 1;
+            }
+            count_sample(&eye_m[ANALYSIS_BIN(sample, spec_m.shift) * spec_m.columns + column]);
+            folded_m++;
+        }
+        previous_m = sample;
+    }
+    // positions are kept from the first sample of the next block
+    clock_m -= count;
+    crossing_m -= count;
+}
+
+/****************************************************************************
+ * read
+ ****************************************************************************/
+void SignalAnalyzer::read(analysis_result_t *result) const
+{
+    uint8_t ch = 0;
+
+    result->mode = spec_m.mode;
+    result->channel = spec_m.channel;
+    result->shift = spec_m.shift;
+    result->bins = bins_m;
+    result->columns = spec_m.columns;
+    for(ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        if(NULL != histograms_m)
+        {
+            result->histograms[ch].assign(histograms_m + ch * bins_m, histograms_m + (ch + 1) * bins_m);
+        }
+        else
+        {
+            result->histograms[ch].clear();
+        }
+        result->samples[ch] = samples_m[ch];
+        result->scale[ch] = scale_m[ch];
+    }
+    if(NULL != eye_m)
+    {
+        result->eye.assign(eye_m, eye_m + bins_m * spec_m.columns);
+    }
+    else
+    {
+        result->eye.clear();
+    }
+    result->folded = folded_m;
+    result->symbol_period = period_m * dt_m;
+}
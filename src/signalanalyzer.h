@@ -0,0 +1,162 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file signalanalyzer.h
+ * @brief Declaration of SignalAnalyzer class.
+ * Amplitude histograms of all channels and eye diagram of one channel,
+ * accumulated as integer bins over raw ADC counts from every captured or
+ * streamed block, so they gather far more samples than a screen shows.
+ * The amplitude bin of a count is a shift. The eye folds samples at a given
+ * symbol period, or at one recovered from the signal crossings, following
+ * the crossings with a first order clock recovery loop.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef SIGNALANALYZER_H
+#define SIGNALANALYZER_H
+
+#include <vector>
+
+#include "oscilloscope.h"
+
+/* amplitude bins from 4096 (shift 4) to 16 (shift 12) */
+#define ANALYSIS_SHIFT_MIN      4
+#define ANALYSIS_SHIFT_MAX      12
+/* symbols across the eye, crossings sit at 1/4 and 3/4 of its width */
+#define EYE_SYMBOLS             2
+/* share of a crossing error the recovered clock moves by */
+#define EYE_LOOP_GAIN           0.0625
+/* crossings of a block needed to recover the symbol period */
+#define EYE_RECOVERY_CROSSINGS  16
+
+typedef enum
+{
+    E_ANALYSIS_NONE = 0,
+    /* amplitude histograms of all channels */
+    E_ANALYSIS_HISTOGRAM,
+    /* histograms, and eye diagram of one channel */
+    E_ANALYSIS_EYE
+}analysis_mode_e;
+
+typedef struct
+{
+    analysis_mode_e mode;
+    /** @brief channel folded into the eye diagram */
+    uint8_t channel;
+    /** @brief amplitude bin of a count is (count + 32768) >> shift, 8 is one bin per code of an 8 bit ADC */
+    uint8_t shift;
+    /** @brief symbol period in seconds, 0 to recover it from the signal crossings */
+    double symbol_period;
+    /** @brief eye columns across EYE_SYMBOLS symbols */
+    uint16_t columns;
+}analysis_spec_t;
+
+/**
+ * @brief copy of the accumulators, for display
+ */
+typedef struct
+{
+    analysis_mode_e mode;
+    uint8_t channel;
+    uint8_t shift;
+    /** @brief amplitude bins, bin b holds counts from (b << shift) - 32768 */
+    uint32_t bins;
+    uint16_t columns;
+    /** @brief samples per amplitude bin of each channel */
+    std::vector<uint32_t> histograms[MAX_CHANNELS];
+    uint64_t samples[MAX_CHANNELS];
+    /** @brief volts per ADC count of the accumulated samples */
+    double scale[MAX_CHANNELS];
+    /** @brief eye samples, bin major: eye[bin * columns + column], bin 0 is the lowest level */
+    std::vector<uint32_t> eye;
+    uint64_t folded;
+    /** @brief symbol period folded at, in seconds, 0 while it is not recovered */
+    double symbol_period;
+}analysis_result_t;
+
+class SignalAnalyzer
+{
+public:
+    SignalAnalyzer();
+    ~SignalAnalyzer();
+    /**
+     * @brief set the analysis, accumulators are allocated and cleared
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t configure(const analysis_spec_t &spec);
+    /** @brief clear accumulators, a recovered period is recovered again */
+    void reset();
+    bool enabled() const { return E_ANALYSIS_NONE != spec_m.mode; }
+    /**
+     * @brief accumulate samples of a channel
+     * @param[in] : channel index (0 for channel A, 1 for channel B, etc)
+     * @param[in] : raw ADC counts
+     * @param[in] : number of samples
+     * @param[in] : volts per ADC count, a channel is cleared when it changes
+     * @param[in] : sample interval in seconds, the eye is cleared when it changes
+     * @param[in] : true when samples follow the previous ones of the channel (streaming),
+     *              false when they start a new capture
+     */
+    void accumulate(uint8_t channel, const short *samples, uint32_t count, double scale, double dt, bool continuous);
+    /**
+     * @brief copy the accumulators
+     * @param[out] : result, its vectors are resized
+     */
+    void read(analysis_result_t *result) const;
+    /**
+     * @brief size the period recovery for blocks up to nb_samples, accumulate then does not allocate
+     * @param[in] : number of samples of the largest block
+     */
+    void reserve(uint32_t nb_samples);
+private:
+    SignalAnalyzer(const SignalAnalyzer &);
+    SignalAnalyzer &operator=(const SignalAnalyzer &);
+    void release();
+    void clear_channel(uint8_t channel);
+    void clear_eye();
+    /** @brief symbol period from the crossings of a block, in samples, 0 if there are too few */
+    double recover_period(const short *samples, uint32_t count, short low, short high);
+    void fold(const short *samples, uint32_t count, double dt, bool continuous);
+    analysis_spec_t spec_m;
+    uint32_t bins_m;
+    /* channel major: bins of channel c start at c * bins_m */
+    uint32_t *histograms_m;
+    uint64_t samples_m[MAX_CHANNELS];
+    double scale_m[MAX_CHANNELS];
+    short min_m[MAX_CHANNELS];
+    short max_m[MAX_CHANNELS];
+    uint32_t *eye_m;
+    uint64_t folded_m;
+    double dt_m;
+    /* symbol period, in samples, 0 while unknown */
+    double period_m;
+    /* crossings of the block the period is recovered from */
+    std::vector<double> crossings_m;
+    /* clock recovery, positions in samples from the first sample of the next block */
+    bool locked_m;
+    double clock_m;
+    double crossing_m;
+    bool high_m;
+    bool has_previous_m;
+    short previous_m;
+};
+
+#endif // SIGNALANALYZER_H
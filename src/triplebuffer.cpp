@@ -0,0 +1,85 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file triplebuffer.cpp
+ * @brief Definition of TripleBuffer class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include "triplebuffer.h"
+
+/* shared slot index is held in the low bits */
+#define TRIPLE_BUFFER_INDEX 0x03
+#define TRIPLE_BUFFER_FRESH 0x04
+
+/****************************************************************************
+ *
+ * constructor
+ *
+ ****************************************************************************/
+TripleBuffer::TripleBuffer() :
+    write_m(0),
+    read_m(2),
+    shared_m(1),
+    dropped_m(0)
+{
+}
+
+/****************************************************************************
+ * publish - swap the written slot with the shared one
+ ****************************************************************************/
+bool TripleBuffer::publish(void)
+{
+    uint8_t previous = __atomic_exchange_n(&shared_m, (uint8_t)(write_m | TRIPLE_BUFFER_FRESH), __ATOMIC_ACQ_REL);
+
+    write_m = previous & TRIPLE_BUFFER_INDEX;
+    if(previous & TRIPLE_BUFFER_FRESH)
+    {
+        __atomic_add_fetch(&dropped_m, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+    return false;
+}
+
+/****************************************************************************
+ * acquire - swap the read slot with the shared one if it is fresh
+ ****************************************************************************/
+bool TripleBuffer::acquire(void)
+{
+    uint8_t previous = 0;
+
+    // only the writer makes the shared slot fresh: it stays fresh till the exchange
+    if(0 == (__atomic_load_n(&shared_m, __ATOMIC_ACQUIRE) & TRIPLE_BUFFER_FRESH))
+    {
+        return false;
+    }
+    previous = __atomic_exchange_n(&shared_m, read_m, __ATOMIC_ACQ_REL);
+    read_m = previous & TRIPLE_BUFFER_INDEX;
+    return true;
+}
+
+/****************************************************************************
+ * dropped
+ ****************************************************************************/
+uint32_t TripleBuffer::dropped(void) const
+{
+    return __atomic_load_n(&dropped_m, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,83 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file triplebuffer.h
+ * @brief Declaration of TripleBuffer class.
+ * Latest value hand-off between one writer and one reader thread. Three
+ * slots are owned by the caller, TripleBuffer only tells which one each side
+ * may use: the writer always has a free slot and never waits, the reader
+ * always gets the newest published slot. Slots published but never read are
+ * dropped and counted.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include "oscilloscope.h"
+
+#define TRIPLE_BUFFER_SLOTS 3
+
+class TripleBuffer
+{
+public:
+    /**
+     * @brief constructor, nothing is published
+     */
+    TripleBuffer();
+    /**
+     * @brief slot the writer fills, never read by the reader
+     */
+    uint8_t write_slot() const { return write_m; }
+    /**
+     * @brief give the written slot to the reader, the writer gets another free one
+     * return : true if the previously published slot was dropped without being read
+     */
+    bool publish(void);
+    /**
+     * @brief take the newest published slot, read_slot() then gives its index
+     * return : true if a slot was published since the last call
+     */
+    bool acquire(void);
+    /**
+     * @brief slot the reader uses, never written by the writer
+     */
+    uint8_t read_slot() const { return read_m; }
+    /**
+     * @brief number of slots published and never read
+     */
+    uint32_t dropped(void) const;
+
+private:
+    /* not copyable */
+    TripleBuffer(const TripleBuffer&);
+    TripleBuffer& operator=(const TripleBuffer&);
+
+    /** @brief owned by the writer thread */
+    uint8_t write_m;
+    /** @brief owned by the reader thread */
+    uint8_t read_m;
+    /** @brief slot between them, with TRIPLE_BUFFER_FRESH when it is not read yet */
+    uint8_t shared_m;
+    uint32_t dropped_m;
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,234 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file waveformaverager.cpp
+ * @brief Definition of WaveformAverager class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "waveformaverager.h"
+
+/****************************************************************************
+ * WaveformAverager
+ ****************************************************************************/
+WaveformAverager::WaveformAverager() :
+    shift_m(1),
+    capacity_m(0),
+    sums_m(NULL),
+    min_m(NULL),
+    max_m(NULL),
+    output_m(NULL)
+{
+    spec_m.mode = E_AVERAGE_NONE;
+    spec_m.captures = 2;
+    memset(captures_m, 0, sizeof(captures_m));
+}
+
+/****************************************************************************
+ * ~WaveformAverager
+ ****************************************************************************/
+WaveformAverager::~WaveformAverager()
+{
+    release();
+}
+
+/****************************************************************************
+ * release
+ ****************************************************************************/
+void WaveformAverager::release()
+{
+    free(sums_m);
+    free(min_m);
+    free(max_m);
+    free(output_m);
+    sums_m = NULL;
+    min_m = NULL;
+    max_m = NULL;
+    output_m = NULL;
+    capacity_m = 0;
+}
+
+/****************************************************************************
+ * configure
+ ****************************************************************************/
+void WaveformAverager::configure(const average_spec_t &spec)
+{
+    spec_m = spec;
+    if(spec_m.captures < 2)
+    {
+        spec_m.captures = 2;
+    }
+    // exponential weight is a shift
+    shift_m = 0;
+    while((2u << shift_m) <= spec_m.captures)
+    {
+        shift_m++;
+    }
+    reset();
+}
+
+/****************************************************************************
+ * allocate
+ ****************************************************************************/
+int8_t WaveformAverager::allocate(uint32_t nb_samples)
+{
+    reset();
+    if(nb_samples <= capacity_m)
+    {
+        return 0;
+    }
+    release();
+    sums_m = (int32_t *)malloc(MAX_CHANNELS * nb_samples * sizeof(int32_t));
+    min_m = (short *)malloc(MAX_CHANNELS * nb_samples * sizeof(short));
+    max_m = (short *)malloc(MAX_CHANNELS * nb_samples * sizeof(short));
+    output_m = (short *)malloc(2 * MAX_CHANNELS * nb_samples * sizeof(short));
+    if((NULL == sums_m) || (NULL == min_m) || (NULL == max_m) || (NULL == output_m))
+    {
+        ERROR("unable to allocate averaging of %u samples\n", nb_samples);
+        release();
+        return -1;
+    }
+    capacity_m = nb_samples;
+    return 0;
+}
+
+/****************************************************************************
+ * reset
+ ****************************************************************************/
+void WaveformAverager::reset()
+{
+    memset(captures_m, 0, sizeof(captures_m));
+}
+
+/****************************************************************************
+ * accumulate
+ ****************************************************************************/
+const short *WaveformAverager::accumulate(uint8_t channel, const short *samples, uint32_t first, uint32_t count)
+{
+    int32_t *sums = NULL;
+    short *min = NULL;
+    short *max = NULL;
+    short *out = NULL;
+    uint32_t i = 0;
+    uint32_t n = 0;
+    uint8_t shift = shift_m;
+
+    if(!active() || (channel >= MAX_CHANNELS) || (first + count > capacity_m))
+    {
+        return NULL;
+    }
+    if(0 == first)
+    {
+        captures_m[channel]++;
+    }
+    n = captures_m[channel];
+    // reset in the middle of a screen: its accumulators hold nothing till the next capture starts
+    if(0 == n)
+    {
+        return NULL;
+    }
+    sums = sums_m + channel * capacity_m + first;
+    min = min_m + channel * capacity_m + first;
+    max = max_m + channel * capacity_m + first;
+    out = output_m + 2 * channel * capacity_m;
+    switch(spec_m.mode)
+    {
+        case E_AVERAGE_RUNNING:
+            if(1 == n)
+            {
+                memset(sums, 0, count * sizeof(int32_t));
+            }
+            else if((0 == first) && (n > spec_m.captures))
+            {
+                // keep the newest half: the average stays smooth, halving costs one pass every N/2 captures
+                for(i = 0; i < capacity_m; i++)
+                {
+                    sums[i] /= 2;
+                }
+                n = captures_m[channel] = spec_m.captures / 2 + 1;
+            }
+            for(i = 0; i < count; i++)
+            {
+                sums[i] += samples[i];
+            }
+            for(i = first; i < first + count; i++)
+            {
+                out[i] = (short)(sums[i - first] / (int32_t)n);
+            }
+            break;
+        case E_AVERAGE_EXPONENTIAL:
+            if(1 == n)
+            {
+                for(i = 0; i < count; i++)
+                {
+                    sums[i] = samples[i] * (1 << AVERAGE_FRACTION_BITS);
+                }
+            }
+            else
+            {
+                // too few captures for the weight: average them evenly
+                if((1u << shift) > n)
+                {
+                    shift = 0;
+                    while((2u << shift) <= n)
+                        shift++;
+                }
+                for(i = 0; i < count; i++)
+                {
+                    sums[i] += ((samples[i] * (1 << AVERAGE_FRACTION_BITS)) - sums[i]) >> shift;
+                }
+            }
+            for(i = first; i < first + count; i++)
+            {
+                out[i] = (short)(sums[i - first] / (1 << AVERAGE_FRACTION_BITS));
+            }
+            break;
+        case E_AVERAGE_ENVELOPE:
+            if(1 == n)
+            {
+                memcpy(min, samples, count * sizeof(short));
+                memcpy(max, samples, count * sizeof(short));
+            }
+            else
+            {
+                for(i = 0; i < count; i++)
+                {
+                    if(samples[i] < min[i])
+                        min[i] = samples[i];
+                    if(samples[i] > max[i])
+                        max[i] = samples[i];
+                }
+            }
+            for(i = 0; i < count; i++)
+            {
+                out[2 * (first + i)] = max[i];
+                out[2 * (first + i) + 1] = min[i];
+            }
+            break;
+        case E_AVERAGE_NONE:
+        default:
+            return NULL;
+    }
+    return out;
+}
@@ -0,0 +1,110 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file waveformaverager.h
+ * @brief Declaration of WaveformAverager class.
+ * Running average, exponential average and min/max envelope of block
+ * captures, accumulated as integers over raw ADC counts in per channel
+ * arrays allocated once per acquisition.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef WAVEFORMAVERAGER_H
+#define WAVEFORMAVERAGER_H
+
+#include "oscilloscope.h"
+
+/* fractional bits of the exponential average accumulators */
+#define AVERAGE_FRACTION_BITS 8
+
+typedef enum
+{
+    E_AVERAGE_NONE = 0,
+    /* average of the last captures, between N/2 and N of them */
+    E_AVERAGE_RUNNING,
+    /* exponential average of weight 1/N, N rounded down to a power of two */
+    E_AVERAGE_EXPONENTIAL,
+    /* min and max of all captures */
+    E_AVERAGE_ENVELOPE
+}average_mode_e;
+
+typedef struct
+{
+    average_mode_e mode;
+    /** @brief number of captures N, at least 2 */
+    uint32_t captures;
+}average_spec_t;
+
+class WaveformAverager
+{
+public:
+    WaveformAverager();
+    ~WaveformAverager();
+    /**
+     * @brief set the mode, accumulators are cleared
+     */
+    void configure(const average_spec_t &spec);
+    /**
+     * @brief reserve accumulators of all channels, storage only grows, accumulators are cleared
+     * @param[in] : number of samples of a screen
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t allocate(uint32_t nb_samples);
+    /** @brief clear accumulators, the next capture starts a new average */
+    void reset();
+    bool active() const { return E_AVERAGE_NONE != spec_m.mode; }
+    /**
+     * @brief true when the output interleaves max and min of each sample,
+     * output then holds twice the samples at half the interval
+     */
+    bool interleaved() const { return E_AVERAGE_ENVELOPE == spec_m.mode; }
+    /**
+     * @brief accumulate a capture, samples [first, first + count) of a screen.
+     * A capture starting at sample 0 counts as a new capture, samples of a capture
+     * started before the last reset are not accumulated.
+     * @param[in] : channel index (0 for channel A, 1 for channel B, etc)
+     * @param[in] : raw ADC counts of the capture
+     * @param[in] : screen index of the first sample
+     * @param[in] : number of samples
+     * return : averaged counts of the screen, NULL when inactive, out of range or
+     *          no capture started since the last reset
+     */
+    const short *accumulate(uint8_t channel, const short *samples, uint32_t first, uint32_t count);
+    /** @brief number of captures in the average of a channel */
+    uint32_t captures(uint8_t channel) const { return captures_m[channel]; }
+private:
+    WaveformAverager(const WaveformAverager &);
+    WaveformAverager &operator=(const WaveformAverager &);
+    void release();
+    average_spec_t spec_m;
+    uint8_t shift_m;
+    uint32_t capacity_m;
+    uint32_t captures_m[MAX_CHANNELS];
+    /* channel major storage: samples of channel c start at c * capacity_m */
+    /* running sums, or fixed point exponential averages */
+    int32_t *sums_m;
+    short *min_m;
+    short *max_m;
+    /* twice the capacity per channel: envelope interleaves max and min */
+    short *output_m;
+};
+
+#endif // WAVEFORMAVERAGER_H
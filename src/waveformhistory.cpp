@@ -0,0 +1,193 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file waveformhistory.cpp
+ * @brief Definition of WaveformHistory class.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "waveformhistory.h"
+
+/* blocks start on a double boundary, for their time tables */
+#define HISTORY_ALIGN(x) (((x) + sizeof(double) - 1) & ~(sizeof(double) - 1))
+
+/****************************************************************************
+ * WaveformHistory
+ ****************************************************************************/
+WaveformHistory::WaveformHistory() :
+    arena_m(NULL),
+    size_m(0),
+    head_m(0),
+    first_m(0),
+    count_m(0)
+{
+}
+
+/****************************************************************************
+ * ~WaveformHistory
+ ****************************************************************************/
+WaveformHistory::~WaveformHistory()
+{
+    free(arena_m);
+}
+
+/****************************************************************************
+ * allocate
+ ****************************************************************************/
+int8_t WaveformHistory::allocate(size_t budget)
+{
+    clear();
+    free(arena_m);
+    arena_m = NULL;
+    size_m = 0;
+    if(0 == budget)
+    {
+        return 0;
+    }
+    arena_m = (uint8_t *)malloc(budget);
+    if(NULL == arena_m)
+    {
+        ERROR("unable to allocate %lu bytes of waveform history\n", (unsigned long)budget);
+        return -1;
+    }
+    size_m = budget;
+    return 0;
+}
+
+/****************************************************************************
+ * clear
+ ****************************************************************************/
+void WaveformHistory::clear()
+{
+    head_m = 0;
+    first_m = 0;
+    count_m = 0;
+}
+
+/****************************************************************************
+ * evict
+ ****************************************************************************/
+void WaveformHistory::evict(size_t offset, size_t size)
+{
+    const history_frame_t *oldest = NULL;
+
+    while(count_m > 0)
+    {
+        oldest = &frames_m[first_m];
+        if((oldest->offset >= offset + size) || (oldest->offset + oldest->size <= offset))
+        {
+            // frames are in write order: the next ones are not in the way either
+            break;
+        }
+        first_m = (first_m + 1) % HISTORY_MAX_FRAMES;
+        count_m--;
+    }
+}
+
+/****************************************************************************
+ * store
+ ****************************************************************************/
+int8_t WaveformHistory::store(const sample_frame_t *frame, double timestamp, bool failed)
+{
+    history_frame_t *kept = NULL;
+    const sample_block_t *block = NULL;
+    size_t size = 0;
+    size_t offset = 0;
+    uint8_t ch = 0;
+
+    if((NULL == arena_m) || (NULL == frame))
+    {
+        return -1;
+    }
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        block = &frame->blocks[ch];
+        if((frame->channels & (1 << ch)) && (NULL != block->raw))
+        {
+            size += HISTORY_ALIGN(block->count * sizeof(short));
+            if(NULL != block->times)
+            {
+                size += block->count * sizeof(double);
+            }
+        }
+    }
+    if((0 == size) || (size > size_m))
+    {
+        return -1;
+    }
+    if(count_m == HISTORY_MAX_FRAMES)
+    {
+        first_m = (first_m + 1) % HISTORY_MAX_FRAMES;
+        count_m--;
+    }
+    offset = head_m;
+    if(head_m + size > size_m)
+    {
+        // a frame never wraps: the end of the arena is skipped, with the oldest frames there
+        evict(head_m, size_m - head_m);
+        offset = 0;
+    }
+    evict(offset, size);
+
+    kept = &frames_m[(first_m + count_m) % HISTORY_MAX_FRAMES];
+    kept->frame = *frame;
+    kept->frame.channels = 0;
+    kept->frame.digital = NULL;
+    kept->timestamp = timestamp;
+    kept->failed = failed;
+    kept->offset = offset;
+    kept->size = size;
+    head_m = offset;
+    for(ch = 0; ch < FRAME_CHANNELS; ch++)
+    {
+        block = &frame->blocks[ch];
+        if((frame->channels & (1 << ch)) && (NULL != block->raw))
+        {
+            kept->frame.channels |= (1 << ch);
+            if(NULL != block->times)
+            {
+                memcpy(arena_m + head_m, block->times, block->count * sizeof(double));
+                kept->frame.blocks[ch].times = (const double *)(arena_m + head_m);
+                head_m += block->count * sizeof(double);
+            }
+            memcpy(arena_m + head_m, block->raw, block->count * sizeof(short));
+            kept->frame.blocks[ch].raw = (const short *)(arena_m + head_m);
+            head_m += HISTORY_ALIGN(block->count * sizeof(short));
+        }
+    }
+    count_m++;
+    return 0;
+}
+
+/****************************************************************************
+ * frame
+ ****************************************************************************/
+const history_frame_t *WaveformHistory::frame(uint32_t age) const
+{
+    if(age >= count_m)
+    {
+        return NULL;
+    }
+    return &frames_m[(first_m + count_m - 1 - age) % HISTORY_MAX_FRAMES];
+}
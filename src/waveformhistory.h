@@ -0,0 +1,101 @@
+/*****************************************************************************
+*   Copyright 2026 QPicoscope contributors
+*
+*   This file is part of QPicoscope.
+*
+*   QPicoscope is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU Lesser General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   any later version.
+*
+*   QPicoscope is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with QPicoscope in files COPYING.LESSER and COPYING.
+*   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+/**
+ * @file waveformhistory.h
+ * @brief Declaration of WaveformHistory class.
+ * The last captured frames are kept in one arena allocated for a memory
+ * budget. Frames are written one after the other as a ring, the oldest ones
+ * being overwritten, so storing a capture never allocates.
+ * @version 0.1
+ * @date 2026, october 19
+ */
+
+#ifndef WAVEFORMHISTORY_H
+#define WAVEFORMHISTORY_H
+
+#include <stddef.h>
+
+#include "oscilloscope.h"
+#include "sampleblock.h"
+
+/* maximum number of frames kept, whatever the budget */
+#define HISTORY_MAX_FRAMES 4096
+
+/**
+ * @brief a kept frame: blocks point in the arena, digital lines are not kept
+ */
+typedef struct
+{
+    sample_frame_t frame;
+    /** @brief capture time, in seconds since the epoch */
+    double timestamp;
+    /** @brief the capture failed the mask test */
+    bool failed;
+    /** @brief arena bytes used by the frame, from offset */
+    size_t offset;
+    size_t size;
+}history_frame_t;
+
+class WaveformHistory
+{
+public:
+    WaveformHistory();
+    ~WaveformHistory();
+    /**
+     * @brief allocate the arena, kept frames are lost
+     * @param[in] : arena size in bytes, 0 to disable the history
+     * return : 0 if successful, -1 in case of error
+     */
+    int8_t allocate(size_t budget);
+    size_t budget() const { return size_m; }
+    /** @brief forget kept frames */
+    void clear();
+    /**
+     * @brief keep a copy of a frame, overwriting the oldest ones when needed
+     * @param[in] : frame to keep
+     * @param[in] : capture time, in seconds since the epoch
+     * @param[in] : the capture failed the mask test
+     * return : 0 if successful, -1 if the frame is larger than the arena
+     */
+    int8_t store(const sample_frame_t *frame, double timestamp, bool failed = false);
+    /** @brief number of kept frames */
+    uint32_t count() const { return count_m; }
+    /**
+     * @brief get a kept frame, valid until the next store
+     * @param[in] : age, 0 for the newest frame
+     * return : kept frame, NULL if there is no such frame
+     */
+    const history_frame_t *frame(uint32_t age) const;
+private:
+    WaveformHistory(const WaveformHistory &);
+    WaveformHistory &operator=(const WaveformHistory &);
+    /** @brief drop oldest frames until [offset, offset + size) is free */
+    void evict(size_t offset, size_t size);
+    uint8_t *arena_m;
+    size_t size_m;
+    /* next free byte of the arena */
+    size_t head_m;
+    /* ring of kept frames, oldest at first_m */
+    history_frame_t frames_m[HISTORY_MAX_FRAMES];
+    uint32_t first_m;
+    uint32_t count_m;
+};
+
+#endif // WAVEFORMHISTORY_H